@@ -0,0 +1,93 @@
+#include "alloc_counter.hh"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <sys/resource.h>
+
+/* Counters, shared by all threads */
+static std::atomic<size_t> allocCounter(0);
+static std::atomic<size_t> allocBytes(0);
+
+/* Replaced global allocation operators (the nothrow variants forward to these by default) */
+
+void * operator new(size_t size) {
+    allocCounter.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    void * result = std::malloc(size == 0 ? 1 : size);
+    if(result == nullptr)
+        throw std::bad_alloc();
+    return result;
+}
+
+void * operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+/* The aligned variants are replaced as well, since std::pmr::new_delete_resource allocates through them */
+
+void * operator new(size_t size, std::align_val_t alignment) {
+    allocCounter.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(size, std::memory_order_relaxed);
+    /* aligned_alloc requires the size to be a multiple of the alignment */
+    size_t align = (size_t)alignment;
+    void * result = std::aligned_alloc(align, ((size == 0 ? 1 : size) + align - 1) / align * align);
+    if(result == nullptr)
+        throw std::bad_alloc();
+    return result;
+}
+
+void * operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void * ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void * ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+
+/* Counter access */
+
+AllocCount alloc_current(void) {
+    return { allocCounter.load(std::memory_order_relaxed), allocBytes.load(std::memory_order_relaxed) };
+}
+
+AllocCount alloc_since(AllocCount const & start) {
+    AllocCount now = alloc_current();
+    return { now.allocations - start.allocations, now.bytes - start.bytes };
+}
+
+size_t alloc_peakRss(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (size_t)usage.ru_maxrss;
+}
@@ -0,0 +1,31 @@
+/**
+ * @file alloc_counter.hh
+ * @author Linux-Tech-Tips
+ * @brief Heap allocation counting for the benchmarks
+ *
+ * The benchmark executable replaces the global allocation operators with counting versions,
+ * the functions declared here give access to the counters.
+ */
+#ifndef BENCH_ALLOC_COUNTER_H
+#define BENCH_ALLOC_COUNTER_H
+
+#include <cstddef>
+
+/** Data structure containing a snapshot of the allocation counters */
+struct AllocCount {
+    /** The amount of allocations done */
+    size_t allocations;
+    /** The total amount of bytes allocated */
+    size_t bytes;
+};
+
+/** Returns the current values of the allocation counters (counted since the start of the program) */
+AllocCount alloc_current(void);
+
+/** Returns the difference of the allocation counters between two snapshots */
+AllocCount alloc_since(AllocCount const & start);
+
+/** Returns the peak resident set size of the process, in kilobytes */
+size_t alloc_peakRss(void);
+
+#endif /* BENCH_ALLOC_COUNTER_H */
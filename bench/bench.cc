@@ -0,0 +1,511 @@
+/**
+ * @file bench.cc
+ * @author Linux-Tech-Tips
+ * @brief XML Parser benchmark suite
+ *
+ * Benchmarks the main operations of the XML parser on a synthetic corpus document,
+ * printing one JSON object per line (a corpus record followed by one record per benchmark), so the results can be tracked across releases.
+ * Alternatively runs the scaling check on pathological inputs, exiting with a non-zero status if any operation grows faster than linearly.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include "../src/parser/XmlDocument.hh"
+#include "../src/parser/XmlDocumentCache.hh"
+#include "../src/parser/XmlBatchLoader.hh"
+#include "../src/parser/XmlAsyncIO.hh"
+#include "../src/parser/XmlDiff.hh"
+#include "../src/parser/XmlTraversal.hh"
+
+#include "corpus.hh"
+#include "alloc_counter.hh"
+#include "scaling.hh"
+
+/** Data structure containing the settings of a benchmark run */
+struct BenchSettings {
+    /** The settings of the generated corpus document */
+    CorpusSettings corpus;
+    /** The minimum amount of iterations of each benchmark */
+    size_t iterations = 5;
+    /** The minimum total time of each benchmark, in seconds */
+    double minTime = 0.5;
+    /** If not empty, only benchmarks with names containing this string are run */
+    std::string filter;
+    /** If not empty, the corpus is only written into this file and no benchmarks are run */
+    std::string generatePath;
+    /** If not empty, the results are written into this file instead of stdout */
+    std::string outputPath;
+    /** If true, the scaling check is run instead of the benchmarks */
+    bool scaling = false;
+    /** The settings of the scaling check */
+    ScalingSettings scalingSettings;
+};
+
+/** Data structure containing the results of a single benchmark */
+struct BenchResult {
+    /** The name of the benchmark */
+    std::string name;
+    /** How many iterations were run */
+    size_t iterations;
+    /** The fastest iteration, in seconds */
+    double minSeconds;
+    /** The mean iteration time, in seconds */
+    double meanSeconds;
+    /** The amount of input bytes processed per iteration */
+    size_t bytes;
+    /** The amount of nodes processed per iteration */
+    size_t nodes;
+    /** The allocations done per iteration */
+    AllocCount alloc;
+    /** The peak resident set size of the process after the benchmark, in kilobytes */
+    size_t peakRss;
+};
+
+/** Sink for benchmark results, so that the measured work can't be optimized out */
+static volatile size_t benchSink = 0;
+
+/** Visitor counting the attributes of all elements and the text of all text elements, for the visit benchmark */
+struct BenchVisitor : NodeVisitor<BenchVisitor> {
+    size_t count = 0;
+
+    bool visitElement(XmlElement const & element) {
+        this->count += element.getAttributeNumber();
+        return true;
+    }
+
+    void visitText(TextElement const & text) {
+        this->count += text.getAttributeNumber() + 1;
+    }
+};
+
+
+/* Function declarations */
+
+/** Parses the command line arguments into the settings, returns false if the arguments are incorrect */
+bool bench_parseArgs(int argc, char ** argv, BenchSettings * settings);
+
+/** Prints usage information */
+void bench_usage(char const * program);
+
+/** Returns the amount of Nodes in the document, including all nested Nodes */
+size_t bench_countNodes(XmlDocument const & document);
+
+/** Runs the given benchmark function repeatedly (at least the minimum amount of iterations, and for at least the minimum time) */
+BenchResult bench_run(BenchSettings const & settings, std::string const & name, size_t bytes, size_t nodes, std::function<void(void)> const & function);
+
+/** Prints the JSON record of a benchmark result into the given file */
+void bench_print(FILE * out, BenchResult const & result);
+
+
+/* Main function */
+
+int main(int argc, char ** argv) {
+    BenchSettings settings;
+    if(!bench_parseArgs(argc, argv, &settings)) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+
+    FILE * out = stdout;
+    if(!settings.outputPath.empty()) {
+        out = std::fopen(settings.outputPath.c_str(), "w");
+        if(out == nullptr) {
+            std::fprintf(stderr, "Error: Can't open output file %s\n", settings.outputPath.c_str());
+            return 1;
+        }
+    }
+
+    /* Scaling check instead of the benchmarks, failing if any operation grows too fast */
+    if(settings.scaling) {
+        size_t failed = scaling_run(out, settings.scalingSettings);
+        if(out != stdout)
+            std::fclose(out);
+        if(failed > 0) {
+            std::fprintf(stderr, "Error: %zu operations grew faster than the allowed exponent\n", failed);
+            return 1;
+        }
+        return 0;
+    }
+
+    /* Generating the corpus */
+    std::string corpus = corpus_generate(settings.corpus);
+    if(!settings.generatePath.empty()) {
+        file_writeString(settings.generatePath.c_str(), corpus);
+        return 0;
+    }
+
+    /* Reference document, used by the benchmarks operating on already loaded documents */
+    XmlDocument document;
+    document.loadFromString(corpus);
+    size_t nodes = bench_countNodes(document);
+    std::string printed = document.print();
+
+    std::fprintf(out, "{\"record\":\"corpus\",\"depth\":%zu,\"fanout\":%zu,\"attributes\":%zu,\"text\":%zu,\"dtd\":%s,\"bytes\":%zu,\"nodes\":%zu}\n",
+        settings.corpus.depth, settings.corpus.fanout, settings.corpus.attributes, settings.corpus.textSize,
+        (settings.corpus.dtd ? "true" : "false"), corpus.length(), nodes);
+
+    /* Temporary file for the save benchmark */
+    std::string savePath = "/tmp/xml_bench_" + std::to_string(getpid()) + ".xml";
+
+    /* The benchmarks - name, processed bytes, processed nodes, measured function */
+    auto run = [&](std::string const & name, size_t bytes, size_t benchNodes, std::function<void(void)> const & function) {
+        if(settings.filter.empty() || name.find(settings.filter) != std::string::npos) {
+            BenchResult result = bench_run(settings, name, bytes, benchNodes, function);
+            bench_print(out, result);
+            std::fflush(out);
+        }
+    };
+
+    run("loadFromString", corpus.length(), nodes, [&]() {
+        XmlDocument loaded;
+        loaded.loadFromString(corpus);
+        benchSink += loaded.getChildAmount();
+    });
+
+    run("getNodes", corpus.length(), nodes, [&]() {
+        benchSink += XmlDocument::getNodes(corpus).size();
+    });
+
+    run("print", printed.length(), nodes, [&]() {
+        benchSink += document.print().length();
+    });
+
+    /* Printing minified XML, without any formatting whitespace */
+    XmlDocument minified(document);
+    XmlWriteOptions minifiedOptions;
+    minifiedOptions.mode = XmlWriteMode::Minified;
+    minified.setWriteOptions(minifiedOptions);
+    std::string minifiedText = minified.print();
+    run("printMinified", minifiedText.length(), nodes, [&]() {
+        benchSink += minified.print().length();
+    });
+
+    run("save", printed.length(), nodes, [&]() {
+        document.save(savePath.c_str());
+    });
+
+    /* Getting the saved file from a document cache, which only checks that the file didn't change */
+    document.save(savePath.c_str());
+    XmlDocumentCache cache;
+    run("cacheGet", 0, nodes, [&]() {
+        benchSink += cache.get(savePath.c_str())->getChildAmount();
+    });
+
+    /* Loading the saved file asynchronously, waiting for the result */
+    XmlAsyncIO async;
+    run("asyncLoad", printed.length(), nodes, [&]() {
+        benchSink += async.load(savePath.c_str()).get()->getChildAmount();
+    });
+    std::remove(savePath.c_str());
+
+    /* Loading a gzip-compressed copy of the corpus, decompressed while reading */
+    std::string gzipPath = savePath + ".gz";
+    gzFile gzip = gzopen(gzipPath.c_str(), "wb");
+    if(gzip != nullptr) {
+        gzwrite(gzip, corpus.data(), (unsigned)corpus.length());
+        gzclose(gzip);
+        run("loadGzip", corpus.length(), nodes, [&]() {
+            XmlDocument loaded;
+            loaded.load(gzipPath.c_str());
+            benchSink += loaded.getChildAmount();
+        });
+        std::remove(gzipPath.c_str());
+    }
+
+    /* Loading a batch of copies of the corpus in parallel */
+    std::vector<std::string> batchPaths;
+    for(size_t i = 0; i < 8; i++) {
+        batchPaths.push_back("/tmp/xml_bench_" + std::to_string(getpid()) + "_" + std::to_string(i) + ".xml");
+        file_writeString(batchPaths.back().c_str(), corpus);
+    }
+    XmlBatchLoader loader;
+    run("batchLoad", corpus.length() * batchPaths.size(), nodes * batchPaths.size(), [&]() {
+        benchSink += loader.load(batchPaths).size();
+    });
+    for(std::string const & path : batchPaths) {
+        std::remove(path.c_str());
+    }
+
+    /* Printing a document with a single modified attribute of its last innermost element, copying everything else from the loaded text */
+    XmlDocument edited;
+    edited.setIncrementalSave(true);
+    edited.loadFromString(corpus);
+    if(edited.getChildAmount() > 0) {
+        Node * innermost = edited.getNode(edited.getChildAmount() - 1);
+        while(innermost->getNodeType() == NodeTypeName::XmlElement && ((XmlElement *)innermost)->getChildAmount() > 0)
+            innermost = ((XmlElement *)innermost)->getChild(((XmlElement *)innermost)->getChildAmount() - 1);
+        innermost->setAttribute("edited", "true");
+    }
+    run("printIncremental", corpus.length(), nodes, [&]() {
+        benchSink += edited.printIncremental().length();
+    });
+
+    std::string binary = document.printBinary();
+    run("loadFromBinary", binary.length(), nodes, [&]() {
+        XmlDocument loaded;
+        loaded.loadFromBinary(binary);
+        benchSink += loaded.getChildAmount();
+    });
+
+    run("printBinary", binary.length(), nodes, [&]() {
+        benchSink += document.printBinary().length();
+    });
+
+    /* Opening a mapped image and reading the last root-level Node, which doesn't depend on the document size */
+    std::string imagePath = "/tmp/xml_bench_" + std::to_string(getpid()) + ".img";
+    document.saveImage(imagePath.c_str());
+    run("openImage", 0, nodes, [&]() {
+        XmlImage image(imagePath.c_str());
+        benchSink += image.getNode(image.getChildAmount() - 1).getChildAmount();
+    });
+    std::remove(imagePath.c_str());
+
+    run("copy", printed.length(), nodes, [&]() {
+        XmlDocument copy(document);
+        benchSink += copy.getChildAmount();
+    });
+
+    /* Copying and modifying the last innermost element, which only copies the Nodes on the path to it */
+    run("copyEdit", printed.length(), nodes, [&]() {
+        XmlDocument copy(document);
+        if(copy.getChildAmount() > 0) {
+            Node * innermost = copy.getNode(copy.getChildAmount() - 1);
+            while(innermost->getNodeType() == NodeTypeName::XmlElement && ((XmlElement *)innermost)->getChildAmount() > 0)
+                innermost = ((XmlElement *)innermost)->getChild(((XmlElement *)innermost)->getChildAmount() - 1);
+            innermost->setAttribute("edited", "true");
+        }
+        benchSink += copy.getChildAmount();
+    });
+
+    /* The same modification, then hashing the copy, which only recomputes the hashes on the path to the modified element */
+    benchSink += document.getHash();
+    run("hashEdit", printed.length(), nodes, [&]() {
+        XmlDocument copy(document);
+        if(copy.getChildAmount() > 0) {
+            Node * innermost = copy.getNode(copy.getChildAmount() - 1);
+            while(innermost->getNodeType() == NodeTypeName::XmlElement && ((XmlElement *)innermost)->getChildAmount() > 0)
+                innermost = ((XmlElement *)innermost)->getChild(((XmlElement *)innermost)->getChildAmount() - 1);
+            innermost->setAttribute("edited", "true");
+        }
+        benchSink += copy.getHash();
+    });
+
+    /* Comparing the document with an edited copy, which only visits the Nodes on the path to the modified element */
+    XmlDocument editedCopy(document);
+    if(editedCopy.getChildAmount() > 0) {
+        Node * innermost = editedCopy.getNode(editedCopy.getChildAmount() - 1);
+        while(innermost->getNodeType() == NodeTypeName::XmlElement && ((XmlElement *)innermost)->getChildAmount() > 0)
+            innermost = ((XmlElement *)innermost)->getChild(((XmlElement *)innermost)->getChildAmount() - 1);
+        innermost->setAttribute("edited", "true");
+    }
+    XmlDiff diff;
+    run("diffEdit", printed.length(), nodes, [&]() {
+        benchSink += diff.compare(document, editedCopy).size();
+    });
+
+    /* Going through all Nodes of the document, counting the same as the visitor */
+    run("iterate", 0, nodes, [&]() {
+        size_t count = 0;
+        for(Node const * node : TreeRange(document)) {
+            if(node->getNodeType() == NodeTypeName::XmlElement)
+                count += node->getAttributeNumber();
+            else if(node->getNodeType() == NodeTypeName::TextElement)
+                count += node->getAttributeNumber() + 1;
+        }
+        benchSink += count;
+    });
+
+    run("visit", 0, nodes, [&]() {
+        BenchVisitor visitor;
+        visitor.traverse(document);
+        benchSink += visitor.count;
+    });
+
+    /* Looking up each child of the root element by name and offset */
+    XmlElement * root = nullptr;
+    for(size_t i = 0; i < document.getChildAmount(); i++) {
+        if(document.getNode(i)->getNodeType() == NodeTypeName::XmlElement) {
+            root = (XmlElement *)document.getNode(i);
+            break;
+        }
+    }
+    if(root != nullptr && root->getChildAmount() > 0) {
+        std::string childName = root->getChild(0)->getName();
+        size_t lookups = root->getChildAmount(childName.c_str());
+        run("findChild", 0, lookups, [&]() {
+            int index;
+            for(size_t i = 0; i < lookups; i++) {
+                root->findChild(childName.c_str(), &index, i);
+                benchSink += index;
+            }
+        });
+        /* The same lookups, comparing the interned namespace and local name ids */
+        ExpandedName childExpandedName = root->getChild(0)->getExpandedName();
+        run("findChildExpanded", 0, lookups, [&]() {
+            int index;
+            for(size_t i = 0; i < lookups; i++) {
+                root->findChild(childExpandedName, &index, i);
+                benchSink += index;
+            }
+        });
+    }
+
+    /* Reading a numeric attribute of each element, converted in place, and converted from a copy of the value */
+    std::string numbersText = "<numbers>";
+    for(size_t i = 0; i < 10000; i++) {
+        numbersText += "<v n=\"" + std::to_string(i * 7919) + "\" />";
+    }
+    numbersText += "</numbers>";
+    XmlDocument numbers;
+    numbers.loadFromString(numbersText);
+    XmlElement const * numbersRoot = (XmlElement const *)((XmlDocument const &)numbers).getNode(0);
+    run("getAttributeAs", 0, numbersRoot->getChildAmount(), [&]() {
+        for(size_t i = 0; i < numbersRoot->getChildAmount(); i++) {
+            long long value = 0;
+            numbersRoot->getChild((int)i)->getAttributeAs("n", &value);
+            benchSink += (size_t)value;
+        }
+    });
+    run("getAttributeStoll", 0, numbersRoot->getChildAmount(), [&]() {
+        for(size_t i = 0; i < numbersRoot->getChildAmount(); i++) {
+            benchSink += (size_t)std::stoll(numbersRoot->getChild((int)i)->getAttribute("n"));
+        }
+    });
+
+    if(out != stdout)
+        std::fclose(out);
+
+    return 0;
+}
+
+
+/* Function implementations */
+
+bool bench_parseArgs(int argc, char ** argv, BenchSettings * settings) {
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        /* Flags without a value */
+        if(arg.compare("--dtd") == 0) {
+            settings->corpus.dtd = true;
+            continue;
+        } else if(arg.compare("--scaling") == 0) {
+            settings->scaling = true;
+            continue;
+        }
+        /* All other options need a value */
+        if(i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        try {
+            if(arg.compare("--depth") == 0) {
+                settings->corpus.depth = std::stoul(value);
+            } else if(arg.compare("--fanout") == 0) {
+                settings->corpus.fanout = std::stoul(value);
+            } else if(arg.compare("--attributes") == 0) {
+                settings->corpus.attributes = std::stoul(value);
+            } else if(arg.compare("--text") == 0) {
+                settings->corpus.textSize = std::stoul(value);
+            } else if(arg.compare("--iterations") == 0) {
+                settings->iterations = std::stoul(value);
+            } else if(arg.compare("--time") == 0) {
+                settings->minTime = std::stod(value);
+            } else if(arg.compare("--filter") == 0) {
+                settings->filter = value;
+            } else if(arg.compare("--generate") == 0) {
+                settings->generatePath = value;
+            } else if(arg.compare("--output") == 0) {
+                settings->outputPath = value;
+            } else if(arg.compare("--max-exponent") == 0) {
+                settings->scalingSettings.maxExponent = std::stod(value);
+            } else if(arg.compare("--steps") == 0) {
+                settings->scalingSettings.steps = std::stoul(value);
+            } else {
+                return false;
+            }
+        } catch(std::exception const & e) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void bench_usage(char const * program) {
+    std::fprintf(stderr, "Usage: %s [options]\n", program);
+    std::fprintf(stderr, " - corpus options:\n");
+    std::fprintf(stderr, "    --depth <n>       ... levels of nested elements above the leaves (default 4)\n");
+    std::fprintf(stderr, "    --fanout <n>      ... child elements of each non-leaf element (default 8)\n");
+    std::fprintf(stderr, "    --attributes <n>  ... attributes of each element (default 2)\n");
+    std::fprintf(stderr, "    --text <n>        ... text length of each leaf element (default 32)\n");
+    std::fprintf(stderr, "    --dtd             ... add a Doctype DTD declaring all elements and attributes\n");
+    std::fprintf(stderr, " - run options:\n");
+    std::fprintf(stderr, "    --iterations <n>  ... minimum iterations of each benchmark (default 5)\n");
+    std::fprintf(stderr, "    --time <s>        ... minimum time of each benchmark in seconds (default 0.5)\n");
+    std::fprintf(stderr, "    --filter <name>   ... only run benchmarks containing the name\n");
+    std::fprintf(stderr, "    --output <file>   ... write the JSON records into the file instead of stdout\n");
+    std::fprintf(stderr, "    --generate <file> ... only write the generated corpus into the file\n");
+    std::fprintf(stderr, " - scaling check options:\n");
+    std::fprintf(stderr, "    --scaling         ... run the scaling check on pathological inputs instead of the benchmarks (fails on super-linear growth)\n");
+    std::fprintf(stderr, "    --max-exponent <e>... highest allowed growth exponent of the time taken (default 1.3)\n");
+    std::fprintf(stderr, "    --steps <n>       ... amount of doubling sizes measured for each shape (default 5)\n");
+}
+
+size_t bench_countNodes(XmlDocument const & document) {
+    size_t result = 0;
+    for(Node const * node : TreeRange(document)) {
+        (void)node;
+        result++;
+    }
+    return result;
+}
+
+BenchResult bench_run(BenchSettings const & settings, std::string const & name, size_t bytes, size_t nodes, std::function<void(void)> const & function) {
+    BenchResult result;
+    result.name = name;
+    result.bytes = bytes;
+    result.nodes = nodes;
+    result.iterations = 0;
+    result.minSeconds = 0.0;
+
+    /* Warmup iteration, not counted */
+    function();
+
+    double total = 0.0;
+    AllocCount start = alloc_current();
+    while(result.iterations < settings.iterations || total < settings.minTime) {
+        auto begin = std::chrono::steady_clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+        total += seconds;
+        if(result.iterations == 0 || seconds < result.minSeconds)
+            result.minSeconds = seconds;
+        result.iterations++;
+    }
+    AllocCount alloc = alloc_since(start);
+
+    result.meanSeconds = total / result.iterations;
+    result.alloc.allocations = alloc.allocations / result.iterations;
+    result.alloc.bytes = alloc.bytes / result.iterations;
+    result.peakRss = alloc_peakRss();
+    return result;
+}
+
+void bench_print(FILE * out, BenchResult const & result) {
+    /* Throughput is computed from the fastest iteration, as it is the least affected by noise */
+    double mbPerSecond = (result.minSeconds > 0.0 ? (result.bytes / 1e6) / result.minSeconds : 0.0);
+    double nodesPerSecond = (result.minSeconds > 0.0 ? result.nodes / result.minSeconds : 0.0);
+    std::fprintf(out,
+        "{\"record\":\"benchmark\",\"benchmark\":\"%s\",\"iterations\":%zu,\"bytes\":%zu,\"nodes\":%zu,"
+        "\"seconds_min\":%.9f,\"seconds_mean\":%.9f,\"mb_per_s\":%.3f,\"nodes_per_s\":%.1f,"
+        "\"allocations\":%zu,\"allocated_bytes\":%zu,\"peak_rss_kb\":%zu}\n",
+        result.name.c_str(), result.iterations, result.bytes, result.nodes,
+        result.minSeconds, result.meanSeconds, mbPerSecond, nodesPerSecond,
+        result.alloc.allocations, result.alloc.bytes, result.peakRss);
+}
@@ -0,0 +1,148 @@
+#include "corpus.hh"
+
+/* Internal auxiliary functions */
+
+/** Appends the attributes of a generated element to the given string */
+static void corpus_appendAttributes(std::string & result, CorpusSettings const & settings, size_t level, size_t index) {
+    for(size_t i = 0; i < settings.attributes; i++) {
+        result += " attr" + std::to_string(i) + "=\"value_" + std::to_string(level) + "_" + std::to_string(index) + "\"";
+    }
+}
+
+/** Appends a generated element of the given level, including all its nested elements, to the given string */
+static void corpus_appendElement(std::string & result, CorpusSettings const & settings, size_t level, size_t index) {
+    /* Indenting by the level */
+    result.append(level, '\t');
+
+    /* Leaf element - a text element, or an empty element if no text desired */
+    if(level == settings.depth) {
+        result += "<leaf";
+        corpus_appendAttributes(result, settings, level, index);
+        if(settings.textSize > 0) {
+            result += ">";
+            /* Generating text content of the desired length, consisting of words of varying length */
+            static char const * const words = "lorem ipsum dolor sit amet consectetur adipiscing elit sed do eiusmod tempor ";
+            static size_t const wordsLength = std::string(words).length();
+            for(size_t i = 0; i < settings.textSize; i++) {
+                result += words[(i + index) % wordsLength];
+            }
+            result += "</leaf>\n";
+        } else {
+            result += " />\n";
+        }
+        return;
+    }
+
+    /* Element containing further nested elements */
+    std::string name = "level" + std::to_string(level);
+    result += "<" + name;
+    corpus_appendAttributes(result, settings, level, index);
+    result += ">\n";
+    for(size_t i = 0; i < settings.fanout; i++) {
+        corpus_appendElement(result, settings, level + 1, i);
+    }
+    result.append(level, '\t');
+    result += "</" + name + ">\n";
+}
+
+
+/* Corpus functions */
+
+std::string corpus_generate(CorpusSettings const & settings) {
+    std::string result;
+
+    if(settings.prolog)
+        result += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+
+    /* Declaring all generated elements and their attributes */
+    if(settings.dtd) {
+        result += "<!DOCTYPE level0 [\n";
+        for(size_t level = 0; level <= settings.depth; level++) {
+            std::string name = (level == settings.depth ? "leaf" : "level" + std::to_string(level));
+            result += "\t<!ELEMENT " + name + (level == settings.depth ? (settings.textSize > 0 ? " (#PCDATA)>\n" : " EMPTY>\n") : " ANY>\n");
+            for(size_t i = 0; i < settings.attributes; i++) {
+                result += "\t<!ATTLIST " + name + " attr" + std::to_string(i) + " CDATA #REQUIRED>\n";
+            }
+            /* An additional defaulted attribute, so that applying the declarations has work to do */
+            result += "\t<!ATTLIST " + name + " generated CDATA \"yes\">\n";
+        }
+        result += "]>\n";
+    }
+
+    corpus_appendElement(result, settings, 0, 0);
+    return result;
+}
+
+size_t corpus_elementAmount(CorpusSettings const & settings) {
+    /* Sum of fanout^level for all levels including the leaves */
+    size_t result = 0;
+    size_t levelAmount = 1;
+    for(size_t level = 0; level <= settings.depth; level++) {
+        result += levelAmount;
+        levelAmount *= settings.fanout;
+    }
+    return result;
+}
+
+char const * corpus_shapeName(CorpusShape shape) {
+    switch(shape) {
+        case CorpusShape::DeepNesting:
+            return "deep_nesting";
+        case CorpusShape::WideFanout:
+            return "wide_fanout";
+        case CorpusShape::LongComment:
+            return "long_comment";
+        case CorpusShape::LongAttribute:
+            return "long_attribute";
+        case CorpusShape::SameNameNesting:
+            return "same_name_nesting";
+        default:
+            return "unknown";
+    }
+}
+
+std::string corpus_generateShape(CorpusShape shape, size_t size) {
+    std::string result;
+    switch(shape) {
+        case CorpusShape::DeepNesting:
+            /* Kept on a single line, so that the printed size doesn't grow with indentation */
+            for(size_t i = 0; i < size; i++) {
+                result += "<n" + std::to_string(i) + ">";
+            }
+            result += "text";
+            for(size_t i = size; i > 0; i--) {
+                result += "</n" + std::to_string(i-1) + ">";
+            }
+            result += "\n";
+            break;
+
+        case CorpusShape::WideFanout:
+            result += "<root>\n";
+            for(size_t i = 0; i < size; i++) {
+                result += "\t<child index=\"" + std::to_string(i) + "\" />\n";
+            }
+            result += "</root>\n";
+            break;
+
+        case CorpusShape::LongComment:
+            result += "<!-- " + std::string(size, 'c') + " -->\n";
+            result += "<root>\n\t<!-- " + std::string(size, 'c') + " -->\n\t<child />\n</root>\n";
+            break;
+
+        case CorpusShape::LongAttribute:
+            result += "<root attr=\"" + std::string(size, 'a') + "\">\n\t<child />\n</root>\n";
+            break;
+
+        case CorpusShape::SameNameNesting:
+            for(size_t i = 0; i < size; i++) {
+                result += "<same>";
+            }
+            result += "text";
+            for(size_t i = 0; i < size; i++) {
+                result += "</same>";
+            }
+            result += "\n";
+            break;
+    }
+    return result;
+}
@@ -0,0 +1,58 @@
+/**
+ * @file corpus.hh
+ * @author Linux-Tech-Tips
+ * @brief Synthetic XML corpus generator for the benchmarks
+ *
+ * Contains functions generating synthetic XML documents of a configurable shape, used as input for the benchmark suite.
+ */
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include <string>
+#include <cstddef>
+
+/** Data structure containing the settings of a generated corpus document */
+struct CorpusSettings {
+    /** How many levels of nested elements are generated above the leaf elements */
+    size_t depth = 4;
+    /** How many child elements each non-leaf element has */
+    size_t fanout = 8;
+    /** How many attributes each element has */
+    size_t attributes = 2;
+    /** The length of the text content of each leaf element (leaf elements are empty if 0) */
+    size_t textSize = 32;
+    /** Whether a Doctype DTD with Element and Attribute DTD declarations of all generated elements is added */
+    bool dtd = false;
+    /** Whether an XML prolog is added at the start of the document */
+    bool prolog = true;
+};
+
+/** An enumeration type describing the shapes of pathological documents, used to check how the parser scales with unusual input */
+enum class CorpusShape {
+    /** Elements with distinct names, each nested in the previous one */
+    DeepNesting,
+    /** A single element with many empty child elements */
+    WideFanout,
+    /** A single long comment, both at the root level and within an element */
+    LongComment,
+    /** An element with a single long quoted attribute value */
+    LongAttribute,
+    /** Elements with the same name, each nested in the previous one */
+    SameNameNesting
+};
+
+/** Returns the name of the given shape, in the format used in the benchmark output */
+char const * corpus_shapeName(CorpusShape shape);
+
+/** Returns the XML text of a pathological document of the given shape
+ *  @param size the size of the shape - the amount of nested or child elements, or the length of the comment or attribute value
+*/
+std::string corpus_generateShape(CorpusShape shape, size_t size);
+
+/** Returns the XML text of a synthetic document with the given settings */
+std::string corpus_generate(CorpusSettings const & settings);
+
+/** Returns the amount of elements generated by the given settings (not including the prolog and DTD) */
+size_t corpus_elementAmount(CorpusSettings const & settings);
+
+#endif /* BENCH_CORPUS_H */
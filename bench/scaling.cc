@@ -0,0 +1,109 @@
+#include "scaling.hh"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../src/parser/XmlDocument.hh"
+
+#include "corpus.hh"
+
+/* Internal auxiliary functions */
+
+/** Returns the fastest time of the given function, run repeatedly for at least the given total time */
+static double scaling_measure(double minTime, std::function<void(void)> const & function) {
+    double best = -1.0;
+    double total = 0.0;
+    do {
+        auto begin = std::chrono::steady_clock::now();
+        function();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        total += seconds;
+        if(best < 0.0 || seconds < best)
+            best = seconds;
+    } while(total < minTime);
+    return best;
+}
+
+/** Returns the least-squares slope of log(time) over log(size), which is the growth exponent of the time */
+static double scaling_exponent(std::vector<size_t> const & sizes, std::vector<double> const & seconds) {
+    double meanX = 0.0, meanY = 0.0;
+    for(size_t i = 0; i < sizes.size(); i++) {
+        meanX += std::log((double)sizes[i]);
+        meanY += std::log(seconds[i]);
+    }
+    meanX /= sizes.size();
+    meanY /= sizes.size();
+
+    double covariance = 0.0, variance = 0.0;
+    for(size_t i = 0; i < sizes.size(); i++) {
+        double x = std::log((double)sizes[i]) - meanX;
+        covariance += x * (std::log(seconds[i]) - meanY);
+        variance += x * x;
+    }
+    return (variance > 0.0 ? covariance / variance : 0.0);
+}
+
+/** Prints the JSON record of a measured shape and operation, returns whether the growth exponent is within the allowed one */
+static bool scaling_report(FILE * out, ScalingSettings const & settings, CorpusShape shape, char const * operation, std::vector<size_t> const & sizes, std::vector<double> const & seconds) {
+    double exponent = scaling_exponent(sizes, seconds);
+    bool passed = (exponent <= settings.maxExponent);
+
+    std::fprintf(out, "{\"record\":\"scaling\",\"shape\":\"%s\",\"operation\":\"%s\",\"sizes\":[", corpus_shapeName(shape), operation);
+    for(size_t i = 0; i < sizes.size(); i++) {
+        std::fprintf(out, "%s%zu", (i > 0 ? "," : ""), sizes[i]);
+    }
+    std::fprintf(out, "],\"seconds\":[");
+    for(size_t i = 0; i < seconds.size(); i++) {
+        std::fprintf(out, "%s%.9f", (i > 0 ? "," : ""), seconds[i]);
+    }
+    std::fprintf(out, "],\"exponent\":%.3f,\"max_exponent\":%.3f,\"passed\":%s}\n", exponent, settings.maxExponent, (passed ? "true" : "false"));
+    std::fflush(out);
+
+    return passed;
+}
+
+
+/* Scaling check */
+
+size_t scaling_run(FILE * out, ScalingSettings const & settings) {
+    /* The shapes, with the smallest measured size of each (large enough for the timing to be above noise) */
+    std::vector<std::pair<CorpusShape, size_t>> shapes = {
+        { CorpusShape::DeepNesting, 256 },
+        { CorpusShape::WideFanout, 1024 },
+        { CorpusShape::LongComment, 16384 },
+        { CorpusShape::LongAttribute, 16384 },
+        { CorpusShape::SameNameNesting, 256 }
+    };
+
+    size_t failed = 0;
+    for(auto & shape : shapes) {
+        std::vector<size_t> sizes;
+        std::vector<double> parseSeconds;
+        std::vector<double> printSeconds;
+
+        for(size_t step = 0, size = shape.second; step < settings.steps; step++, size *= 2) {
+            std::string xml = corpus_generateShape(shape.first, size);
+            XmlDocument document;
+            document.loadFromString(xml);
+
+            sizes.push_back(size);
+            parseSeconds.push_back(scaling_measure(settings.minTime, [&]() {
+                XmlDocument loaded;
+                loaded.loadFromString(xml);
+            }));
+            printSeconds.push_back(scaling_measure(settings.minTime, [&]() {
+                document.print();
+            }));
+        }
+
+        if(!scaling_report(out, settings, shape.first, "parse", sizes, parseSeconds))
+            failed++;
+        if(!scaling_report(out, settings, shape.first, "print", sizes, printSeconds))
+            failed++;
+    }
+
+    return failed;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file scaling.hh
+ * @author Linux-Tech-Tips
+ * @brief Pathological-input scaling checks
+ *
+ * Contains the scaling check, which parses and prints pathological documents of doubling sizes
+ * and fits the growth exponent of the time taken, to catch super-linear behavior.
+ */
+#ifndef BENCH_SCALING_H
+#define BENCH_SCALING_H
+
+#include <cstdio>
+#include <cstddef>
+
+/** Data structure containing the settings of the scaling check */
+struct ScalingSettings {
+    /** The highest allowed growth exponent (1.0 is linear), a higher exponent fails the check */
+    double maxExponent = 1.3;
+    /** How many doubling sizes are measured for each shape */
+    size_t steps = 5;
+    /** The minimum total time spent measuring each size, in seconds (the fastest measured run is used) */
+    double minTime = 0.05;
+};
+
+/** Runs the scaling check for all pathological shapes, printing one JSON record per shape and operation into the given file
+ *  @return the amount of shape and operation combinations which grew faster than the allowed exponent
+*/
+size_t scaling_run(FILE * out, ScalingSettings const & settings);
+
+#endif /* BENCH_SCALING_H */
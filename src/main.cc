@@ -49,6 +49,8 @@ void select(cmdState * state);
 void nested(cmdState * state);
 /** Manipulates the content of the Node (for TextElement or Comment) */
 void content(cmdState * state);
+/** Applies the attribute declarations of the Doctype DTD to the document */
+void validate(cmdState * state);
 
 
 /* Main function */
@@ -67,6 +69,8 @@ int main() {
     
     /* XML Document loading from file */
     std::printf("Loading file %s\n", enteredFile.c_str());
+    /* Only the Nodes edited in the session are printed when saving, the rest of the file is copied as loaded */
+    state.document.setIncrementalSave(true);
     state.document.load(enteredFile.c_str());
     std::printf("Loaded file!\n");
 
@@ -125,6 +129,7 @@ void genMap(std::map<std::string, void(*)(cmdState *)> * map) {
     (*map)["select"] = select;
     (*map)["nested"] = nested;
     (*map)["content"] = content;
+    (*map)["validate"] = validate;
 }
 
 
@@ -159,6 +164,7 @@ void help(cmdState * state) {
     std::printf("    attr del <name>           ... deletes the given attribute\n");
     std::printf("    select home               ... unsets any current Nodes, showing the entire loaded XmlDocument\n");
     std::printf("    select ..                 ... sets the current Node to the one above the current\n");
+    std::printf("    validate                  ... applies the DTD attribute declarations (defaults, types) to the whole document\n");
 
     std::printf("\n - commands specific to XmlElement:\n");
     std::printf("    select <index>            ... selects the node with the given index (0-indexed)\n");
@@ -332,4 +338,15 @@ void content(cmdState * state) {
     } else {
         std::printf("Error: Incorrect number of arguments!\n");
     }
+}
+
+void validate(cmdState * state) {
+    std::vector<std::string> errors;
+    if(state->document.validateAttributes(&errors)) {
+        std::printf("Document attributes match the DTD declarations\n");
+    } else {
+        for(std::string const & it : errors) {
+            std::printf("%s\n", it.c_str());
+        }
+    }
 }
\ No newline at end of file
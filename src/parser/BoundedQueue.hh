@@ -0,0 +1,85 @@
+/**
+ * @file BoundedQueue.hh
+ * @author Linux-Tech-Tips
+ * @brief Bounded blocking queue template
+ *
+ * The header defining the bounded queue connecting the stages of the parser's pipelines (e.g. reading and decompressing a file),
+ * each stage running on its own thread
+ */
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @class BoundedQueue
+ * @author Linux-Tech-Tips
+ * @brief Bounded blocking queue
+ *
+ * A thread-safe queue holding at most a fixed amount of items - pushing blocks while the queue is full, and popping blocks while the queue is empty,
+ * so that a faster stage of a pipeline waits for the slower one instead of buffering without limit.
+ *
+ * Closing the queue ends the pipeline - the producer closes the queue once it pushed all items (the consumer still pops the remaining ones),
+ * and either side closes the queue to stop the other one on an error (pushing into a closed queue fails).
+*/
+template <typename T>
+class BoundedQueue {
+
+    protected:
+        /** Lock held while accessing the items */
+        std::mutex lock;
+        /** Notified when an item is pushed, or the queue is closed */
+        std::condition_variable pushed;
+        /** Notified when an item is popped, or the queue is closed */
+        std::condition_variable popped;
+        /** The queued items, from the oldest */
+        std::deque<T> items;
+        /** The maximum amount of queued items */
+        size_t capacity;
+        /** Whether the queue is closed */
+        bool closed;
+
+    public:
+        /** Constructor - creates an empty queue holding at most the given amount of items (at least 1) */
+        explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1), closed(false) {}
+
+        /** Adds an item to the end of the queue, waiting while the queue is full
+         *  @return false if the queue is closed (the item is not added)
+        */
+        bool push(T item) {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->popped.wait(guard, [this]() { return this->closed || this->items.size() < this->capacity; });
+            if(this->closed)
+                return false;
+            this->items.push_back(std::move(item));
+            this->pushed.notify_one();
+            return true;
+        }
+
+        /** Removes the oldest item from the queue and saves it into item, waiting while the queue is empty
+         *  @return false if the queue is closed and empty (nothing is saved)
+        */
+        bool pop(T & item) {
+            std::unique_lock<std::mutex> guard(this->lock);
+            this->pushed.wait(guard, [this]() { return this->closed || !this->items.empty(); });
+            if(this->items.empty())
+                return false;
+            item = std::move(this->items.front());
+            this->items.pop_front();
+            this->popped.notify_one();
+            return true;
+        }
+
+        /** Closes the queue, waking all waiting threads (the remaining items can still be popped) */
+        void close(void) {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->closed = true;
+            this->pushed.notify_all();
+            this->popped.notify_all();
+        }
+
+};
+
+#endif /* BOUNDED_QUEUE_H */
@@ -0,0 +1,63 @@
+#include "FrozenXmlDocument.hh"
+
+/* Constructor */
+
+FrozenXmlDocument::FrozenXmlDocument(XmlDocument const & original) : document(original) {}
+
+
+/* Get functions for internal nodes */
+
+Node const * FrozenXmlDocument::getNode(int index) const {
+    return this->document.getNode(index);
+}
+
+Node const * FrozenXmlDocument::getNode(char const * name, size_t offset) const {
+    return this->document.getNode(name, offset);
+}
+
+size_t FrozenXmlDocument::getChildAmount(void) const {
+    return this->document.getChildAmount();
+}
+
+size_t FrozenXmlDocument::getChildAmount(char const * name) const {
+    return this->document.getChildAmount(name);
+}
+
+bool FrozenXmlDocument::findChild(char const * name, int * index, size_t offset) const {
+    return this->document.findChild(name, index, offset);
+}
+
+Node const * FrozenXmlDocument::getNode(ExpandedName const & name, size_t offset) const {
+    return this->document.getNode(name, offset);
+}
+
+size_t FrozenXmlDocument::getChildAmount(ExpandedName const & name) const {
+    return this->document.getChildAmount(name);
+}
+
+bool FrozenXmlDocument::findChild(ExpandedName const & name, int * index, size_t offset) const {
+    return this->document.findChild(name, index, offset);
+}
+
+
+/* Hashing */
+
+uint64_t FrozenXmlDocument::getHash(void) const {
+    return this->document.getHash();
+}
+
+
+/* Output functions */
+
+std::string FrozenXmlDocument::print(void) const {
+    /* The frozen copy has no statistics set, so printing doesn't write anything shared */
+    return this->document.print();
+}
+
+void FrozenXmlDocument::save(char const * filePath) const {
+    this->document.save(filePath);
+}
+
+XmlDocument FrozenXmlDocument::thaw(void) const {
+    return XmlDocument(this->document);
+}
@@ -0,0 +1,88 @@
+/**
+ * @file FrozenXmlDocument.hh
+ * @author Linux-Tech-Tips
+ * @brief Immutable XML Document class header
+ *
+ * The header declaring the frozen XML Document class, an immutable form of an XML Document which can be shared by any amount of threads
+ */
+#ifndef FROZEN_XML_DOC_H
+#define FROZEN_XML_DOC_H
+
+#include <string>
+#include <memory>
+
+#include "XmlDocument.hh"
+
+/**
+ * @class FrozenXmlDocument
+ * @author Linux-Tech-Tips
+ * @brief Immutable XML Document class
+ *
+ * An immutable snapshot of an XML Document, created using @ref XmlDocument::freeze.
+ * Only provides read-only access to its Nodes, and doesn't modify anything internally when read, so any amount of threads
+ * can read the same frozen document at the same time without any locking.
+ *
+ * The Nodes are shared with the document the snapshot was taken from (and with any documents thawed from the snapshot) until modified,
+ * so freezing and thawing take time proportional only to the amount of root-level Nodes. Modifying the original document afterwards doesn't affect the snapshot.
+ * The memory resource of the original document must outlive the snapshot.
+*/
+class FrozenXmlDocument {
+
+    protected:
+        /** The frozen document, only accessed using its read-only member functions */
+        XmlDocument document;
+
+    public:
+        /** Constructor - creates a snapshot of the given document (use @ref XmlDocument::freeze to get a shared snapshot) */
+        explicit FrozenXmlDocument(XmlDocument const & original);
+
+
+        /* Get functions for internal nodes */
+
+        /** Returns a read-only pointer to the root-level Node at the specified index (or null pointer if out of bounds) */
+        Node const * getNode(int index) const;
+
+        /** Returns a read-only pointer to the first (or n-th) root-level Node with the given name (or null pointer if not found)
+         *  @param offset which node with the given name to find, if more exist (leave default or 0 to get the first found instance)
+        */
+        Node const * getNode(char const * name, size_t offset = 0) const;
+
+        /** Gets the amount of root-level Nodes contained within the document */
+        size_t getChildAmount(void) const;
+
+        /** Gets the amount of root-level Nodes with the given name in the document */
+        size_t getChildAmount(char const * name) const;
+
+        /** Returns whether the first (or n-th if defined by offset) root-level Node exists, and saves its index (if index not nullptr) */
+        bool findChild(char const * name, int * index = nullptr, size_t offset = 0) const;
+
+        /** Returns a read-only pointer to the first (or n-th) root-level Node with the given resolved namespace and local name (or null pointer if not found) */
+        Node const * getNode(ExpandedName const & name, size_t offset = 0) const;
+
+        /** Gets the amount of root-level Nodes with the given resolved namespace and local name in the document */
+        size_t getChildAmount(ExpandedName const & name) const;
+
+        /** Returns whether the first (or n-th if defined by offset) root-level Node with the given resolved namespace and local name exists, and saves its index (if index not nullptr) */
+        bool findChild(ExpandedName const & name, int * index = nullptr, size_t offset = 0) const;
+
+
+        /* Hashing */
+
+        /** Returns the hash of the content of the document (see @ref XmlDocument::getHash) - the Nodes of a frozen document are never modified, so their hashes are only computed once */
+        uint64_t getHash(void) const;
+
+
+        /* Output functions */
+
+        /** Returns the complete XML string of the document */
+        std::string print(void) const;
+
+        /** Saves the document to the given path */
+        void save(char const * filePath) const;
+
+        /** Returns a modifiable copy of the document, sharing the Nodes with the snapshot until modified */
+        XmlDocument thaw(void) const;
+
+};
+
+#endif /* FROZEN_XML_DOC_H */
@@ -0,0 +1,122 @@
+#include "ThreadPool.hh"
+
+/** The pool of the worker running on the current thread (null pointer if not a worker thread) */
+static thread_local ThreadPool const * currentPool = nullptr;
+/** The index of the worker running on the current thread */
+static thread_local size_t currentWorker = 0;
+
+
+/* Protected member functions */
+
+bool ThreadPool::takeTask(size_t worker, std::function<void(void)> & task) {
+    bool found = false;
+    /* Taking the most recently added task of the own queue, since its data is most likely still cached */
+    {
+        Queue & own = *this->queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if(!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    /* Stealing the oldest task of another worker, starting with the next one so that the workers don't all steal from the same queue */
+    for(size_t i = 1; !found && i < this->queues.size(); i++) {
+        Queue & other = *this->queues[(worker + i) % this->queues.size()];
+        std::lock_guard<std::mutex> guard(other.lock);
+        if(!other.tasks.empty()) {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            found = true;
+        }
+    }
+    if(found) {
+        std::lock_guard<std::mutex> guard(this->stateLock);
+        --this->queued;
+    }
+    return found;
+}
+
+void ThreadPool::work(size_t worker) {
+    currentPool = this;
+    currentWorker = worker;
+    std::function<void(void)> task;
+    while(true) {
+        if(this->takeTask(worker, task)) {
+            try {
+                task();
+            } catch(...) {}
+            task = nullptr;
+            std::lock_guard<std::mutex> guard(this->stateLock);
+            if(--this->unfinished == 0)
+                this->tasksFinished.notify_all();
+            continue;
+        }
+        /* Sleeping until a task is submitted, only stopping once all queued tasks are taken */
+        std::unique_lock<std::mutex> guard(this->stateLock);
+        this->taskAdded.wait(guard, [this]() { return this->stopping || this->queued > 0; });
+        if(this->stopping && this->queued == 0)
+            return;
+    }
+}
+
+
+/* Constructor and destructor */
+
+ThreadPool::ThreadPool(size_t threadAmount) : queued(0), unfinished(0), nextQueue(0), stopping(false) {
+    if(threadAmount == 0)
+        threadAmount = std::thread::hardware_concurrency();
+    if(threadAmount == 0)
+        threadAmount = 1;
+    for(size_t i = 0; i < threadAmount; i++) {
+        this->queues.push_back(std::make_unique<Queue>());
+    }
+    for(size_t i = 0; i < threadAmount; i++) {
+        this->threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool(void) {
+    {
+        std::lock_guard<std::mutex> guard(this->stateLock);
+        this->stopping = true;
+    }
+    this->taskAdded.notify_all();
+    for(std::thread & thread : this->threads) {
+        thread.join();
+    }
+}
+
+
+/* Tasks */
+
+void ThreadPool::submit(std::function<void(void)> task) {
+    {
+        /* The task is added and counted under the state lock, so that no worker can take it before it's counted */
+        std::lock_guard<std::mutex> guard(this->stateLock);
+        size_t index;
+        if(currentPool == this) {
+            index = currentWorker;
+        } else {
+            index = this->nextQueue;
+            this->nextQueue = (this->nextQueue + 1) % this->queues.size();
+        }
+        {
+            Queue & queue = *this->queues[index];
+            std::lock_guard<std::mutex> queueGuard(queue.lock);
+            queue.tasks.push_back(std::move(task));
+        }
+        ++this->queued;
+        ++this->unfinished;
+    }
+    this->taskAdded.notify_one();
+}
+
+void ThreadPool::wait(void) {
+    std::unique_lock<std::mutex> guard(this->stateLock);
+    this->tasksFinished.wait(guard, [this]() { return this->unfinished == 0; });
+}
+
+size_t ThreadPool::getThreadAmount(void) const {
+    return this->threads.size();
+}
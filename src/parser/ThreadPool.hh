@@ -0,0 +1,92 @@
+/**
+ * @file ThreadPool.hh
+ * @author Linux-Tech-Tips
+ * @brief Work-stealing thread pool header
+ *
+ * The header declaring the thread pool used to run the parser's parallel operations (e.g. loading many files at once)
+ */
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * @class ThreadPool
+ * @author Linux-Tech-Tips
+ * @brief Work-stealing thread pool
+ *
+ * A fixed amount of worker threads running submitted tasks. Each worker has its own queue of tasks - tasks submitted from outside of the pool
+ * are distributed between the queues in turn, and tasks submitted by a task running in the pool are added to the queue of its worker.
+ * Each worker runs the most recently added task of its own queue, and once its queue is empty, steals the oldest task from the queue of another worker,
+ * so that the workers stay busy even if the tasks take very different amounts of time.
+ *
+ * Exceptions thrown by tasks are ignored, so tasks should handle (or save) their own errors.
+ * Destroying the pool runs all tasks submitted so far before stopping the workers.
+*/
+class ThreadPool {
+
+    protected:
+        /** The queue of tasks of a single worker */
+        struct Queue {
+            /** Lock held while accessing the tasks */
+            std::mutex lock;
+            /** The tasks, taken from the back by the worker owning the queue, and from the front by other workers */
+            std::deque<std::function<void(void)>> tasks;
+        };
+
+        /** The queue of each worker */
+        std::vector<std::unique_ptr<Queue>> queues;
+        /** The worker threads */
+        std::vector<std::thread> threads;
+
+        /** Lock held while changing the task counts and stopping */
+        std::mutex stateLock;
+        /** Notified when a task is submitted, or the pool is stopping */
+        std::condition_variable taskAdded;
+        /** Notified when all submitted tasks are finished */
+        std::condition_variable tasksFinished;
+        /** The amount of tasks waiting in the queues */
+        size_t queued;
+        /** The amount of tasks waiting in the queues or running */
+        size_t unfinished;
+        /** The queue the next task submitted from outside of the pool is added to */
+        size_t nextQueue;
+        /** Whether the pool is being destroyed */
+        bool stopping;
+
+        /** Internal function which takes a task from the queue of the given worker, or steals one from another worker, returning false if none found */
+        bool takeTask(size_t worker, std::function<void(void)> & task);
+
+        /** Internal function run by each worker thread */
+        void work(size_t worker);
+
+    public:
+        /** Constructor - starts the given amount of worker threads (the amount of hardware threads if 0) */
+        explicit ThreadPool(size_t threadAmount = 0);
+
+        /** Copying is not supported, since the worker threads belong to a single pool */
+        ThreadPool(ThreadPool const & original) = delete;
+        /** Copying is not supported, since the worker threads belong to a single pool */
+        ThreadPool & operator=(ThreadPool const & original) = delete;
+
+        /** Destructor - runs all submitted tasks, and stops the worker threads */
+        ~ThreadPool(void);
+
+        /** Adds a task to be run by one of the worker threads */
+        void submit(std::function<void(void)> task);
+
+        /** Waits until all submitted tasks are finished (must not be called from a task running in the pool) */
+        void wait(void);
+
+        /** Returns the amount of worker threads */
+        size_t getThreadAmount(void) const;
+
+};
+
+#endif /* THREAD_POOL_H */
@@ -1,27 +1,35 @@
 #include "Comment.hh"
 
-Comment::Comment(std::string const & name, std::string const & content, bool showName, bool endLine, bool indent) {
+Comment::Comment(std::string const & name, std::string const & content, bool showName, bool endLine, bool indent, std::pmr::memory_resource * resource)
+    : Node(NodeTypeName::Comment, resource), content(content, this->getResource()) {
     this->setName(name, false);
-    this->nodeType = NodeTypeName::Comment;
-    this->content = content;
     this->showName = showName;
     this->endLine = endLine;
     this->indent = indent;
 }
 
+Comment::Comment(Comment const & original, std::pmr::memory_resource * resource)
+    : Node(original, resource), content(original.content, this->getResource()) {
+    this->showName = original.showName;
+}
+
 
 /* Internal content get/set functions */
 
 void Comment::setContent(std::string const & content) {
     this->content = content;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 std::string Comment::getContent(void) const {
-    return this->content;
+    return std::string(this->content);
 }
 
 void Comment::setShowName(bool showName) {
     this->showName = showName;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool Comment::getShowName(void) const {
@@ -31,29 +39,35 @@ bool Comment::getShowName(void) const {
 
 /* Other functions */
 
-std::string Comment::print(int indentLevel) {
-    std::string result;
+void Comment::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
     
     /* Indent if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++)
-            result += "\t";    
-    }
+    this->printIndent(result, indentLevel, options);
 
     result += "<!-- ";
 
     if(this->showName) {
-        result += this->name + " ";
+        result += this->name;
+        result += " ";
     }
 
-    result += this->content + " -->";
+    result += this->content;
+    result += " -->";
 
-    if(this->endLine)
-        result += "\n";
+    this->printLineBreak(result, options);
+}
 
-    return result;
+Node * Comment::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) Comment(*this, resource);
 }
 
-Node * Comment::_copy(void) const {
-    return new Comment(*this);
-}
\ No newline at end of file
+
+/* Hashing */
+
+uint64_t Comment::computeHash(bool * cacheable) const {
+    uint64_t result = Node::computeHash(cacheable);
+    result = Node::hashCombine(result, (uint64_t)this->showName);
+    return Node::hashBytes(result, this->content);
+}
@@ -24,9 +24,12 @@ class Comment : public Node {
 
     protected:
         /** The inner content of the comment, can be any string */
-        std::string content;
+        std::pmr::string content;
         /** Whether the name of the comment should be shown before the content */
         bool showName;
+
+        /** Internal function which computes the hash of the comment, including its content (see @ref Node::getHash) */
+        virtual uint64_t computeHash(bool * cacheable) const;
     
     public:
         /** Constructor
@@ -35,8 +38,14 @@ class Comment : public Node {
          *  @param showName whether the name of the Comment node should be rendered in the XML
          *  @param endLine whether the Node should end the line it's on
          *  @param indent whether the Node should be indented if nested
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
+        */
+        Comment(std::string const & name = "_default_comment", std::string const & content = "default comment content", bool showName = false, bool endLine = true, bool indent = true, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
         */
-        Comment(std::string const & name = "_default_comment", std::string const & content = "default comment content", bool showName = false, bool endLine = true, bool indent = true);
+        Comment(Comment const & original, std::pmr::memory_resource * resource = nullptr);
 
 
         /* Internal content get/set functions */
@@ -56,13 +65,14 @@ class Comment : public Node {
 
         /* Other functions */
 
-        /** Returns the processed XML of the Comment */
-        virtual std::string print(int indentLevel = 0);
+        /** Appends the processed XML of the Comment to the given string */
+        virtual void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        virtual Node * _copy(void) const;
+        virtual Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
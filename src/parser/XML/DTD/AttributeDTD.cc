@@ -2,10 +2,9 @@
 
 AttributeDTD::AttributeDTD(
     std::string const & element, std::string const & attribute, std::string const & type, std::string const & value, 
-    bool stringValue, bool indent, bool endLine) {
+    bool stringValue, bool indent, bool endLine, std::pmr::memory_resource * resource) : DTD(NodeTypeName::AttributeDTD, resource) {
 
         this->setName(DTD_ATTRIBUTES, false);
-        this->nodeType = NodeTypeName::AttributeDTD;
         this->setElementName(element);
         this->setAttr(attribute, type, value);
         this->stringValue = stringValue;
@@ -13,6 +12,10 @@ AttributeDTD::AttributeDTD(
         this->endLine = endLine;
 }
 
+AttributeDTD::AttributeDTD(AttributeDTD const & original, std::pmr::memory_resource * resource) : DTD(original, resource) {
+    this->stringValue = original.stringValue;
+}
+
 
 /* Get/Set functions for the internal attributes */
 
@@ -43,6 +46,8 @@ std::string AttributeDTD::getAttrType(void) const {
 void AttributeDTD::setAttrValue(std::string const & attrValue, bool isString) {
     this->setAttribute("attr_value", attrValue);
     this->stringValue = isString;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 std::string AttributeDTD::getAttrValue(void) const {
@@ -51,6 +56,8 @@ std::string AttributeDTD::getAttrValue(void) const {
 
 void AttributeDTD::setStringValue(bool isString) {
     this->stringValue = isString;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool AttributeDTD::getStringValue(void) const {
@@ -65,6 +72,8 @@ void AttributeDTD::setAttr(std::string const & attrName, std::string const & att
     this->setAttrType(attrType);
     this->setAttrValue(attrValue);
     this->stringValue = isString;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 void AttributeDTD::getAttr(std::string & attrName, std::string & attrType, std::string & attrValue, bool & isString) const {
@@ -97,17 +106,14 @@ void AttributeDTD::delContent(void) {
 
 /* Other functions */
 
-std::string AttributeDTD::print(int indentLevel) {
-    std::string result;
+void AttributeDTD::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
     /* Starting with indent if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
-    }
+    this->printIndent(result, indentLevel, options);
 
-    result += "<!" + this->name + " " + this->getElementName() + " " + this->getAttrName() + " " + this->getAttrType() + " ";
+    result += "<!";
+    result += this->name;
+    result += " " + this->getElementName() + " " + this->getAttrName() + " " + this->getAttrType() + " ";
 
     if(this->stringValue)
         result += "\"" + this->getAttrValue() + "\"";
@@ -116,12 +122,11 @@ std::string AttributeDTD::print(int indentLevel) {
     
     result += ">";
 
-    if(this->endLine)
-        result += "\n";
-
-    return result;
+    this->printLineBreak(result, options);
 }
 
-Node * AttributeDTD::_copy(void) const {
-    return new AttributeDTD(*this);
+Node * AttributeDTD::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) AttributeDTD(*this, resource);
 }
\ No newline at end of file
@@ -38,11 +38,17 @@ class AttributeDTD : public DTD {
          *  @param value the value of the described attribute
          *  @param indent whether the DTD should be indented if nested
          *  @param endLine whether the DTD should end the line it's on
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
         AttributeDTD(
             std::string const & element = "default_element", std::string const & attribute = "default_attribute", 
             std::string const & type = DTD_ATTR_CDATA, std::string const & value = DTD_ATTR_IMPLIED,
-            bool stringValue = false, bool indent = true, bool endLine = true);
+            bool stringValue = false, bool indent = true, bool endLine = true, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
+        */
+        AttributeDTD(AttributeDTD const & original, std::pmr::memory_resource * resource = nullptr);
         
 
         /* Get/Set functions for the internal attributes */
@@ -105,13 +111,14 @@ class AttributeDTD : public DTD {
 
         /* Other functions */
 
-        /** Returns the processed XML content of the Attribute DTD */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML content of the Attribute DTD to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
@@ -0,0 +1,245 @@
+#include "AttributeTable.hh"
+
+/* Protected member functions */
+
+bool AttributeTable::applyDeclarations(Node const * element, Node * modifiable, std::vector<std::string> * errors) {
+    /* Single lookup of all the declarations of the element */
+    std::vector<AttributeDeclaration> const * declarations = this->getDeclarations(element->getName());
+    if(declarations == nullptr)
+        return true;
+
+    bool valid = true;
+    /* Saves the message of a found problem (if desired), and marks the element as not valid */
+    auto error = [&](std::string const & attribute, std::string const & message) {
+        valid = false;
+        if(errors)
+            errors->push_back("Error: Attribute '" + attribute + "' of element '" + element->getName() + "' " + message);
+    };
+
+    for(AttributeDeclaration const & declaration : *declarations) {
+
+        /* Missing attribute - required, defaulted, or optional */
+        if(!element->hasAttribute(declaration.name)) {
+            if(declaration.defaultType == AttributeDefault::Required) {
+                error(declaration.name, "is required");
+            } else if(modifiable != nullptr && declaration.defaultType != AttributeDefault::Implied) {
+                modifiable->setAttribute(declaration.name, declaration.defaultValue);
+            }
+            continue;
+        }
+
+        std::string value = element->getAttribute(declaration.name);
+
+        /* Fixed value check */
+        if(declaration.defaultType == AttributeDefault::Fixed && value.compare(declaration.defaultValue) != 0) {
+            error(declaration.name, "must have the fixed value \"" + declaration.defaultValue + "\"");
+        }
+
+        /* Enumeration check */
+        if(!declaration.enumeration.empty()) {
+            bool found = false;
+            for(std::string const & it : declaration.enumeration) {
+                if(it.compare(value) == 0) {
+                    found = true;
+                    break;
+                }
+            }
+            if(!found)
+                error(declaration.name, "has the value \"" + value + "\", which is not in the declared enumeration");
+            continue;
+        }
+
+        /* Type checks */
+        if(declaration.type.compare(DTD_ATTR_ID) == 0) {
+            if(!AttributeTable::checkNameToken(value) || std::isdigit((unsigned char)value[0]) || value[0] == '-' || value[0] == '.') {
+                error(declaration.name, "has the value \"" + value + "\", which is not a valid ID");
+            } else if(!this->ids.insert(value).second) {
+                error(declaration.name, "has the value \"" + value + "\", which is not a unique ID");
+            }
+        } else if(declaration.type.compare(DTD_ATTR_IDREF) == 0 || declaration.type.compare(DTD_ATTR_IDREFS) == 0) {
+            std::vector<std::string> values = AttributeTable::splitList(value);
+            if(values.empty() || (values.size() > 1 && declaration.type.compare(DTD_ATTR_IDREF) == 0)) {
+                error(declaration.name, "has the value \"" + value + "\", which is not a valid " + declaration.type);
+            } else {
+                this->references.insert(this->references.end(), values.begin(), values.end());
+            }
+        } else if(declaration.type.compare(DTD_ATTR_NMTOKEN) == 0) {
+            if(!AttributeTable::checkNameToken(value))
+                error(declaration.name, "has the value \"" + value + "\", which is not a valid NMTOKEN");
+        } else if(declaration.type.compare(DTD_ATTR_NMTOKENS) == 0) {
+            std::vector<std::string> values = AttributeTable::splitList(value);
+            bool tokens = !values.empty();
+            for(std::string const & it : values) {
+                tokens = tokens && AttributeTable::checkNameToken(it);
+            }
+            if(!tokens)
+                error(declaration.name, "has the value \"" + value + "\", which is not a valid NMTOKENS list");
+        }
+    }
+
+    return valid;
+}
+
+
+/* Protected static member functions */
+
+bool AttributeTable::checkNameToken(std::string const & value) {
+    if(value.empty())
+        return false;
+    /* Name tokens consist only of letters, digits and the characters '_', '-', '.' and ':' (non-ASCII characters are accepted as they are) */
+    for(char c : value) {
+        if(!std::isalnum((unsigned char)c) && c != '_' && c != '-' && c != '.' && c != ':' && ((unsigned char)c) < 0x80)
+            return false;
+    }
+    return true;
+}
+
+std::vector<std::string> AttributeTable::splitList(std::string const & value) {
+    std::vector<std::string> result;
+    std::string buffer;
+    for(char c : value) {
+        if(std::isspace((unsigned char)c)) {
+            if(!buffer.empty()) {
+                result.push_back(buffer);
+                buffer.clear();
+            }
+        } else {
+            buffer += c;
+        }
+    }
+    if(!buffer.empty())
+        result.push_back(buffer);
+    return result;
+}
+
+
+/* Constructors */
+
+AttributeTable::AttributeTable(void) {}
+
+AttributeTable::AttributeTable(DoctypeDTD const & doctype) {
+    this->build(doctype);
+}
+
+
+/* Table building */
+
+void AttributeTable::build(DoctypeDTD const & doctype) {
+    for(size_t i = 0; i < doctype.getChildAmount(); i++) {
+        Node const * child = doctype.getChild(i);
+        if(child->getNodeType() == NodeTypeName::AttributeDTD) {
+            this->addDeclaration(*((AttributeDTD const *)child));
+        }
+    }
+}
+
+void AttributeTable::addDeclaration(AttributeDTD const & declaration) {
+    AttributeDeclaration result;
+    result.name = declaration.getAttrName();
+
+    /* Processing the type - enumerations are enclosed in brackets and separated by pipe characters */
+    std::string type = declaration.getAttrType();
+    if(!type.empty() && type[0] == '(') {
+        std::string buffer;
+        for(size_t i = 1; i < type.length(); i++) {
+            if(type[i] == '|' || type[i] == ')') {
+                /* Saving the value without any surrounding whitespace */
+                size_t start = buffer.find_first_not_of(" \t\n");
+                if(start != std::string::npos)
+                    result.enumeration.push_back(buffer.substr(start, buffer.find_last_not_of(" \t\n") - start + 1));
+                buffer.clear();
+            } else {
+                buffer += type[i];
+            }
+        }
+    } else {
+        result.type = type;
+    }
+
+    /* Processing the default declaration - string values are the default value directly */
+    std::string value = declaration.getAttrValue();
+    if(declaration.getStringValue()) {
+        result.defaultType = AttributeDefault::Value;
+        result.defaultValue = value;
+    } else if(value.compare(DTD_ATTR_REQUIRED) == 0) {
+        result.defaultType = AttributeDefault::Required;
+    } else if(value.empty() || value.compare(DTD_ATTR_IMPLIED) == 0) {
+        result.defaultType = AttributeDefault::Implied;
+    } else {
+        /* Either a fixed value (the keyword followed by the value), or a default value in single quotes */
+        result.defaultType = AttributeDefault::Value;
+        if(value.compare(0, std::string(DTD_ATTR_FIXED).length(), DTD_ATTR_FIXED) == 0) {
+            result.defaultType = AttributeDefault::Fixed;
+            value = value.substr(std::string(DTD_ATTR_FIXED).length());
+            size_t start = value.find_first_not_of(" \t\n");
+            value = (start == std::string::npos ? "" : value.substr(start));
+        }
+        /* Removing the quotes around the value, if any */
+        if(value.length() >= 2 && (value[0] == '"' || value[0] == '\'') && value[value.length()-1] == value[0])
+            value = value.substr(1, value.length()-2);
+        result.defaultValue = value;
+    }
+
+    /* Saving the declaration, unless the attribute was already declared (the first declaration is binding, later ones are ignored) */
+    std::vector<AttributeDeclaration> & declarations = this->table[declaration.getElementName()];
+    for(AttributeDeclaration const & it : declarations) {
+        if(it.name.compare(result.name) == 0)
+            return;
+    }
+    declarations.push_back(result);
+}
+
+void AttributeTable::clear(void) {
+    this->table.clear();
+    this->ids.clear();
+    this->references.clear();
+}
+
+
+/* Table access */
+
+std::vector<AttributeDeclaration> const * AttributeTable::getDeclarations(std::string const & elementName) const {
+    auto it = this->table.find(elementName);
+    if(it != this->table.end())
+        return &(it->second);
+    else
+        return nullptr;
+}
+
+bool AttributeTable::empty(void) const {
+    return this->table.empty();
+}
+
+
+/* Table application */
+
+bool AttributeTable::apply(Node * element, std::vector<std::string> * errors, bool applyDefaults) {
+    return this->applyDeclarations(element, (applyDefaults ? element : nullptr), errors);
+}
+
+bool AttributeTable::check(Node const * element, std::vector<std::string> * errors) {
+    return this->applyDeclarations(element, nullptr, errors);
+}
+
+bool AttributeTable::needsDefaults(Node const * element) const {
+    std::vector<AttributeDeclaration> const * declarations = this->getDeclarations(element->getName());
+    if(declarations == nullptr)
+        return false;
+    for(AttributeDeclaration const & declaration : *declarations) {
+        if((declaration.defaultType == AttributeDefault::Value || declaration.defaultType == AttributeDefault::Fixed) && !element->hasAttribute(declaration.name))
+            return true;
+    }
+    return false;
+}
+
+bool AttributeTable::checkReferences(std::vector<std::string> * errors) const {
+    bool valid = true;
+    for(std::string const & it : this->references) {
+        if(this->ids.find(it) == this->ids.end()) {
+            valid = false;
+            if(errors)
+                errors->push_back("Error: IDREF \"" + it + "\" doesn't refer to any ID in the document");
+        }
+    }
+    return valid;
+}
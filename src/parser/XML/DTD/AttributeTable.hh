@@ -0,0 +1,131 @@
+/**
+ * @file AttributeTable.hh
+ * @author Linux-Tech-Tips
+ * @brief Per-element table of declared DTD attributes
+ *
+ * The header declaring the Attribute Table class, which gathers all Attribute DTD declarations of a Doctype DTD
+ * into a table indexed by element name, and applies them (defaults and type checks) to XML elements
+ */
+#ifndef XML_ATTRIBUTE_TABLE_H
+#define XML_ATTRIBUTE_TABLE_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+#include "../Node.hh"
+#include "AttributeDTD.hh"
+#include "DoctypeDTD.hh"
+
+/** An enumeration type describing the default declaration of a DTD attribute */
+enum class AttributeDefault {
+    /** The attribute is optional and has no default value (#IMPLIED) */
+    Implied,
+    /** The attribute must be present (#REQUIRED) */
+    Required,
+    /** The attribute must always have the declared value (#FIXED "value") */
+    Fixed,
+    /** The attribute is optional, and the declared value is used if it isn't present */
+    Value
+};
+
+/** Data structure containing a single processed Attribute DTD declaration */
+struct AttributeDeclaration {
+    /** The name of the declared attribute */
+    std::string name;
+    /** The declared type of the attribute (DTD_ATTR_* constant, or empty if the type is an enumeration) */
+    std::string type;
+    /** The allowed values of the attribute, if the type is an enumeration */
+    std::vector<std::string> enumeration;
+    /** The default declaration of the attribute */
+    AttributeDefault defaultType;
+    /** The default (or fixed) value of the attribute, if any */
+    std::string defaultValue;
+};
+
+/**
+ * @class AttributeTable
+ * @author Linux-Tech-Tips
+ * @brief Per-element table of declared DTD attributes
+ *
+ * The table is built once from the Attribute DTD children of a Doctype DTD, after which the declarations
+ * of any element can be found with a single lookup by the element name, instead of going through all the ATTLIST declarations.
+ * The table can then be applied to XML elements, filling in default and fixed values and checking the declared attribute types.
+ * ID and IDREF values are collected across all the elements the table is applied to,
+ * and the references are checked against the collected IDs by @ref checkReferences.
+*/
+class AttributeTable {
+
+    protected:
+        /** The processed declarations, indexed by the name of the element they describe */
+        std::unordered_map<std::string, std::vector<AttributeDeclaration>> table;
+        /** All ID values found so far in the elements the table was applied to */
+        std::set<std::string> ids;
+        /** All IDREF values found so far in the elements the table was applied to */
+        std::vector<std::string> references;
+
+        /** Internal function which checks the element against its declarations, adding missing defaulted attributes to modifiable (none added if null pointer) */
+        bool applyDeclarations(Node const * element, Node * modifiable, std::vector<std::string> * errors);
+
+        /** Internal function to check whether a given value is a valid XML name token */
+        static bool checkNameToken(std::string const & value);
+
+        /** Internal function to split a whitespace-separated list of values */
+        static std::vector<std::string> splitList(std::string const & value);
+
+    public:
+        /** Constructor - creates an empty table */
+        AttributeTable(void);
+
+        /** Constructor - creates a table from the Attribute DTD children of the given Doctype DTD */
+        AttributeTable(DoctypeDTD const & doctype);
+
+
+        /* Table building */
+
+        /** Adds all the Attribute DTD children of the given Doctype DTD into the table */
+        void build(DoctypeDTD const & doctype);
+
+        /** Adds a single Attribute DTD declaration into the table (ignored if the same attribute of the element was already declared, as the first declaration is binding) */
+        void addDeclaration(AttributeDTD const & declaration);
+
+        /** Removes all declarations, and any collected IDs and references, from the table */
+        void clear(void);
+
+
+        /* Table access */
+
+        /** Returns a pointer to the list of declarations of the element with the given name (or null pointer if the element has no declared attributes) */
+        std::vector<AttributeDeclaration> const * getDeclarations(std::string const & elementName) const;
+
+        /** Returns whether the table contains no declarations */
+        bool empty(void) const;
+
+
+        /* Table application */
+
+        /** Applies the declarations of the element's name to the element
+         *  @param element the element to apply the declarations to
+         *  @param errors optionally specify a list into which a message is saved for each problem found (pass nullptr to not save messages)
+         *  @param applyDefaults if true, missing attributes with a default or fixed value are added to the element
+         *  @return whether the element's attributes match the declarations
+        */
+        bool apply(Node * element, std::vector<std::string> * errors = nullptr, bool applyDefaults = true);
+
+        /** Checks the element against the declarations of its name, without adding missing defaulted attributes (see @ref apply)
+         *  @return whether the element's attributes match the declarations
+        */
+        bool check(Node const * element, std::vector<std::string> * errors = nullptr);
+
+        /** Returns whether the element is missing any attribute with a declared default or fixed value (which @ref apply would add) */
+        bool needsDefaults(Node const * element) const;
+
+        /** Checks that every IDREF value collected by @ref apply refers to a collected ID
+         *  @param errors optionally specify a list into which a message is saved for each unresolved reference (pass nullptr to not save messages)
+        */
+        bool checkReferences(std::vector<std::string> * errors = nullptr) const;
+
+};
+
+#endif /* XML_ATTRIBUTE_TABLE_H */
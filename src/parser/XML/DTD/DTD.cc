@@ -1,16 +1,21 @@
 #include "DTD.hh"
 
+/* Protected constructor */
+
+DTD::DTD(NodeTypeName nodeType, std::pmr::memory_resource * resource) : Node(nodeType, resource) {}
+
 /* Constructor */
 
-DTD::DTD(std::string const & type, std::string const & content, bool indent, bool endLine) {
+DTD::DTD(std::string const & type, std::string const & content, bool indent, bool endLine, std::pmr::memory_resource * resource) : Node(NodeTypeName::DTD, resource) {
     this->setName(type, false);
-    this->nodeType = NodeTypeName::DTD;
     if(content.length() > 0)
         this->setAttribute("content", content);
     this->indent = indent;
     this->endLine = endLine;
 }
 
+DTD::DTD(DTD const & original, std::pmr::memory_resource * resource) : Node(original, resource) {}
+
 /* Other functions */
 
 void DTD::setContent(std::string const & content) {
@@ -25,28 +30,24 @@ void DTD::delContent(void) {
     this->delAttribute("content");
 }
 
-std::string DTD::print(int indentLevel) {
-    std::string result;
+void DTD::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
     /* Beginning with indent */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
-    }
-    result += "<!" + this->name + " ";
+    this->printIndent(result, indentLevel, options);
+    result += "<!";
+    result += this->name;
+    result += " ";
 
     /* Internally, an empty string is returned if the attribute doesn't exist */
     result += this->getAttribute("content");
 
     /* End with linebreak */
     result += ">";
-    if(this->endLine)
-        result += "\n";
-
-    return result;
+    this->printLineBreak(result, options);
 }
 
-Node * DTD::_copy(void) const {
-    return new DTD(*this);
+Node * DTD::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) DTD(*this, resource);
 }
\ No newline at end of file
@@ -81,14 +81,22 @@
 class DTD : public Node {
 
     protected:
+        /** Constructor used by inheriting classes - sets the Node type and the memory resource, without setting a name or content */
+        DTD(NodeTypeName nodeType, std::pmr::memory_resource * resource);
 
     public:
         /** Constructor 
          *  @param type the type of the DTD
          *  @param indent whether the DTD should be indented if nested
          *  @param endLine whether the DTD should end the line it's on
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        DTD(std::string const & type = DTD_DOCTYPE, std::string const & content = "", bool indent = true, bool endLine = true);
+        DTD(std::string const & type = DTD_DOCTYPE, std::string const & content = "", bool indent = true, bool endLine = true, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
+        */
+        DTD(DTD const & original, std::pmr::memory_resource * resource = nullptr);
 
         /** Sets the 'content' attribute to the desired content */
         virtual void setContent(std::string const & content);
@@ -99,13 +107,14 @@ class DTD : public Node {
         /** Removes any content from this element */
         void delContent(void);
 
-        /** Returns the processed XML of the DTD */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML of the DTD to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
@@ -1,36 +1,33 @@
 #include "DoctypeDTD.hh"
 
 /* Constructor/Destructor */
-DoctypeDTD::DoctypeDTD(std::string const & rootElement, bool singleLine, bool indent, bool endLine) {
+DoctypeDTD::DoctypeDTD(std::string const & rootElement, bool singleLine, bool indent, bool endLine, std::pmr::memory_resource * resource)
+    : DTD(NodeTypeName::DoctypeDTD, resource), children(this->getResource()) {
     this->setName(DTD_DOCTYPE, false);
-    this->nodeType = NodeTypeName::DoctypeDTD;
     this->setAttribute("root_element", rootElement);
     this->singleLine = singleLine;
     this->indent = indent;
     this->endLine = endLine;
 }
 
-DoctypeDTD::DoctypeDTD(DoctypeDTD const & original) {
-    this->name = original.name;
-    this->nodeType = original.nodeType;
-    this->attributes = original.attributes;
+DoctypeDTD::DoctypeDTD(DoctypeDTD const & original, std::pmr::memory_resource * resource)
+    : DTD(original, resource), children(this->getResource()) {
     this->singleLine = original.singleLine;
-    this->indent = indent;
-    this->endLine = endLine;
 
-    /* Copy nested children, if any */
+    /* Share nested children with the original, if any (adopting them directly, so that they keep representing the same loaded text) */
     if(original.getChildAmount() > 0) {
+        this->children.reserve(original.children.size());
         for(auto it : original.children) {
-            this->pushBackChild(*it);
+            this->children.push_back((DTD *)it->_share(this->getResource()));
         }
     }
 }
 
 DoctypeDTD::~DoctypeDTD(void) {
-    /* Deleting any dynamically allocated children */
+    /* Releasing any dynamically allocated children (deallocated unless shared with a copy) */
     if(this->getChildAmount() > 0) {
         for(auto it : this->children) {
-            delete it;
+            it->_release();
         }
     }
 }
@@ -95,35 +92,71 @@ void DoctypeDTD::delContent(void) {
 /* Child DTD management member functions */
 
 void DoctypeDTD::addChild(int pos, DTD const & value) {
-    this->children.insert(this->children.begin() + pos, dynamic_cast<DTD *>(value._copy()));
+    /* The added copy is detached from any loaded text, so that it is printed whole */
+    DTD * child = dynamic_cast<DTD *>(value._copy(this->getResource()));
+    child->_setSource(std::string::npos, std::string::npos);
+    this->children.insert(this->children.begin() + pos, child);
+    this->nestedDirty = true;
+    this->invalidateHash();
 }
 
 void DoctypeDTD::delChild(int pos) {
     if((size_t)pos < this->children.size()) {
-        delete this->children.at(pos);
+        this->children.at(pos)->_release();
         this->children.erase(this->children.begin() + pos);
     } else {
         throw std::invalid_argument("Error: Can't erase at out-of-bounds index");
     }
+    this->nestedDirty = true;
+    this->invalidateHash();
 }
 
 void DoctypeDTD::pushBackChild(DTD const & value) {
-    this->children.push_back(dynamic_cast<DTD *>(value._copy()));
+    this->addChild(this->children.size(), value);
 }
 
 void DoctypeDTD::popBackChild(void) {
-    delete this->children.at(this->children.size()-1);
+    this->children.at(this->children.size()-1)->_release();
     this->children.pop_back();
+    this->nestedDirty = true;
+    this->invalidateHash();
+}
+
+void DoctypeDTD::_adoptChild(DTD * value) {
+    this->children.push_back(value);
+    this->nestedDirty = true;
+    this->invalidateHash();
 }
 
 Node * DoctypeDTD::getChild(int pos) {
+    /* The returned child can be modified, so the nested Nodes can't be assumed unmodified anymore */
+    if((size_t)pos < this->getChildAmount()) {
+        this->nestedDirty = true;
+        this->invalidateHash();
+        this->children[pos] = (DTD *)this->children[pos]->_modifiable();
+        return this->children[pos];
+    } else {
+        return nullptr;
+    }
+}
+
+Node * DoctypeDTD::getChild(char const * name, size_t offset) {
+    int index;
+    if(this->findChild(name, &index, offset)) {
+        return this->getChild(index);
+    } else {
+        return nullptr;
+    }
+}
+
+Node const * DoctypeDTD::getChild(int pos) const {
     if((size_t)pos < this->getChildAmount())
         return this->children.at((size_t)pos);
     else
         return nullptr;
 }
 
-Node * DoctypeDTD::getChild(char const * name, size_t offset) {
+Node const * DoctypeDTD::getChild(char const * name, size_t offset) const {
     int index;
     if(this->findChild(name, &index, offset))
         return this->children.at((size_t)index);
@@ -149,7 +182,7 @@ bool DoctypeDTD::childrenEmpty(void) const {
     return this->children.empty();
 }
 
-bool DoctypeDTD::findChild(char const * nameToFind, int * index, size_t offset) {
+bool DoctypeDTD::findChild(char const * nameToFind, int * index, size_t offset) const {
     /* Check all child elements */
     for(size_t i = 0; i < this->getChildAmount(); i++) {
         if(this->children.at(i)->getName().compare(nameToFind) == 0) {
@@ -173,16 +206,24 @@ bool DoctypeDTD::findChild(char const * nameToFind, int * index, size_t offset)
 
 /* Other */
 
-std::string DoctypeDTD::print(int indentLevel) {
-    std::string result;
+void DoctypeDTD::setSingleLine(bool singleLine) {
+    this->singleLine = singleLine;
+    this->dirty = true;
+    this->invalidateHash();
+}
+
+bool DoctypeDTD::getSingleLine(void) const {
+    return this->singleLine;
+}
+
+void DoctypeDTD::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
     /* Indenting if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++)
-            result += "\t";
-    }
+    this->printIndent(result, indentLevel, options);
 
-    result += "<!" + this->name + " " + this->getRootElement();
+    result += "<!";
+    result += this->name;
+    result += " " + this->getRootElement();
 
     /* Adding link to external DTD if specified */
     if(this->attributes.find("ext_link") != this->attributes.end()) {
@@ -199,34 +240,47 @@ std::string DoctypeDTD::print(int indentLevel) {
     if(this->getChildAmount() > 0) {
         /* Printing the child element section start*/
         result += " [";
-        if(!this->singleLine)
+        if(!this->singleLine && options.mode != XmlWriteMode::Minified && !options.singleLine)
             result += "\n";
         
         /* Printing all the child elements */
+        XmlWriteOptions const & childOptions = (this->singleLine ? Node::getSingleLineOptions(options) : options);
         for(auto it : this->children) {
             if(this->singleLine)
-                result += it->print();
+                it->printTo(result, 0, childOptions);
             else
-                result += it->print(indentLevel + 1);
+                it->printTo(result, indentLevel + 1, childOptions);
         }
 
         /* Closing child element section (with indents if desired) */
-        if(this->indent && indentLevel > 0) {
-            for(int i = 0; i < indentLevel; i++)
-                result += "\t";
-        }
+        if(!this->singleLine || options.mode == XmlWriteMode::KeepOriginal)
+            this->printIndent(result, indentLevel, options);
         result += "]";
     }
 
     /* Closing DTD element */
     result += ">";
 
-    if(this->endLine)
-        result += "\n";
+    this->printLineBreak(result, options);
+}
 
-    return result;
+Node * DoctypeDTD::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) DoctypeDTD(*this, resource);
 }
 
-Node * DoctypeDTD::_copy(void) const {
-    return new DoctypeDTD(*this);
-}
\ No newline at end of file
+
+/* Hashing */
+
+uint64_t DoctypeDTD::computeHash(bool * cacheable) const {
+    uint64_t result = Node::computeHash(cacheable);
+    result = Node::hashCombine(result, this->children.size());
+    for(auto it : this->children) {
+        result = Node::hashCombine(result, it->getHash());
+        /* A child returned as modifiable can be modified without the Doctype being notified */
+        if(it->_isLeaked())
+            *cacheable = false;
+    }
+    return result;
+}
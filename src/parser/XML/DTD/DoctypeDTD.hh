@@ -29,22 +29,28 @@
 class DoctypeDTD : public DTD {
 
     protected:
-        /** Child DTD elements nested within the Doctype DTD element */
-        std::vector<DTD *> children;
+        /** Child DTD elements nested within the Doctype DTD element (copies of added DTD elements are allocated from the Doctype's memory resource) */
+        std::pmr::vector<DTD *> children;
         /** Whether the nested child elements should be rendered on a single line */
         bool singleLine;
 
+        /** Internal function which computes the hash of the Doctype DTD, including the hashes of all child DTD elements (see @ref Node::getHash) */
+        uint64_t computeHash(bool * cacheable) const;
+
     public:
         /** Constructor
          *  @param rootElement the root element of the XML document, to be specified in the Doctype DTD
          *  @param singleLine whether the nested child DTD elements should be on the same line as the DTD or the following line
          *  @param indent whether the DTD should be indented if nested
          *  @param endLine whether the DTD should end the line it's on
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        DoctypeDTD(std::string const & rootElement = "default_element", bool singleLine = false, bool indent = false, bool endLine = true);
+        DoctypeDTD(std::string const & rootElement = "default_element", bool singleLine = false, bool indent = false, bool endLine = true, std::pmr::memory_resource * resource = nullptr);
 
-        /** Copy constructor */
-        DoctypeDTD(DoctypeDTD const & original);
+        /** Copy constructor - copies the Doctype DTD, along with all its nested DTD elements
+         *  @param resource the memory resource to allocate the copy's content and nested DTD elements from (the resource of the original if null pointer)
+        */
+        DoctypeDTD(DoctypeDTD const & original, std::pmr::memory_resource * resource = nullptr);
 
         ~DoctypeDTD(void);
 
@@ -94,15 +100,26 @@ class DoctypeDTD : public DTD {
         /** Removes the last nested DTD element */
         void popBackChild(void);
 
+        /** Adds an allocated nested DTD child element to the end of the list, taking ownership of it instead of copying it
+         * Used internally - the passed DTD is deleted by this element, and must not be deleted or used by the caller afterwards
+        */
+        void _adoptChild(DTD * value);
+
         /** Returns a pointer to the internally stored nested DTD element at the given position (or null pointer if out of bounds). 
          * The function exposes the pointer to the nested DTD directly, and therefore the returned pointer should not be deleted after use.
+         * If the child is shared with a copy of this element, it is copied first, so that it can be modified without affecting the copy.
         */
         Node * getChild(int pos);
         /** Returns a pointer to the n-th internally stored nested DTD child element with the given name (or null pointer if no such child exists). 
          * The function exposes the pointer to the nested DTD directly, and therefore the returned pointer should not be deleted after use.
+         * If the child is shared with a copy of this element, it is copied first, so that it can be modified without affecting the copy.
          *  @param offset which found element to get (leave default or 0 for the first element; the amount of found named children specified by the offset is skipped)
         */
         Node * getChild(char const * name, size_t offset = 0);
+        /** Returns a read-only pointer to the nested DTD element at the given position (or null pointer if out of bounds), without copying a shared child */
+        Node const * getChild(int pos) const;
+        /** Returns a read-only pointer to the n-th nested DTD child element with the given name (or null pointer if not found), without copying a shared child */
+        Node const * getChild(char const * name, size_t offset = 0) const;
 
         /** Returns the current amount of existing child DTD elements */
         size_t getChildAmount(void) const;
@@ -115,18 +132,24 @@ class DoctypeDTD : public DTD {
          *  @param index the saved index; if index < 0, the child was not found (pass nullptr to not save index)
          *  @param offset which found element index to save (leave default or 0 for the first element; the amount of found named children specified by the offset is skipped)
         */
-        bool findChild(char const * nameToFind, int * index = nullptr, size_t offset = 0);
+        bool findChild(char const * nameToFind, int * index = nullptr, size_t offset = 0) const;
 
 
         /* Other */
 
-        /** Returns the processed XML of the Doctype DTD element */
-        std::string print(int indentLevel = 0);
+        /** Sets whether the nested child DTD elements should be rendered on a single line */
+        void setSingleLine(bool singleLine);
+        /** Gets whether the nested child DTD elements are rendered on a single line */
+        bool getSingleLine(void) const;
+
+        /** Appends the processed XML of the Doctype DTD element to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
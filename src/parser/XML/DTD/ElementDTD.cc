@@ -2,15 +2,17 @@
 
 /* Constructor */
 
-ElementDTD::ElementDTD(std::string const & elementName, std::string const & content, bool indent, bool endLine) {
+ElementDTD::ElementDTD(std::string const & elementName, std::string const & content, bool indent, bool endLine, std::pmr::memory_resource * resource)
+    : DTD(NodeTypeName::ElementDTD, resource) {
     this->setName(DTD_ELEMENT, false);
-    this->nodeType = NodeTypeName::ElementDTD;
     this->setAttribute("element_name", elementName);
     this->setAttribute("element_content", content);
     this->endLine = endLine;
     this->indent = indent;
 }
 
+ElementDTD::ElementDTD(ElementDTD const & original, std::pmr::memory_resource * resource) : DTD(original, resource) {}
+
 
 /* Specific content manipulation member functions */
 
@@ -44,6 +46,17 @@ std::string ElementDTD::getElementContent(void) const {
     return this->getAttribute("element_content");
 }
 
+void ElementDTD::setElementModifier(std::string const & elementModifier) {
+    if(elementModifier.empty())
+        this->delAttribute("element_modifier");
+    else
+        this->setAttribute("element_modifier", elementModifier);
+}
+
+std::string ElementDTD::getElementModifier(void) const {
+    return this->getAttribute("element_modifier");
+}
+
 void ElementDTD::setElementName(std::string const & elementName) {
     this->setAttribute("element_name", elementName);
 }
@@ -76,39 +89,36 @@ void ElementDTD::getContent(std::string & elementName, std::string & elementCont
 void ElementDTD::delContent(void) {
     this->delAttribute("element_name");
     this->delAttribute("element_content");
+    this->delAttribute("element_modifier");
 }
 
 
 /* Other functions */
 
-std::string ElementDTD::print(int indentLevel) {
-    std::string result;
+void ElementDTD::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
     /* Starting with indent if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
-    }
-    result += "<!" + this->name + " ";
+    this->printIndent(result, indentLevel, options);
+    result += "<!";
+    result += this->name;
+    result += " ";
 
     result += this->getAttribute("element_name") + " ";
 
     if(this->getAttribute("element_content").compare(DTD_CONTENT_EMPTY) == 0 || this->getAttribute("element_content").compare(DTD_CONTENT_ANY) == 0) {
         result += this->getAttribute("element_content");
     } else {
-        result += "(" + this->getAttribute("element_content") + ")";
+        result += "(" + this->getAttribute("element_content") + ")" + this->getAttribute("element_modifier");
     }
 
     /* End, with linebreak if desired */
     result += ">";
-    if(this->endLine)
-        result += "\n";
-
-    return result;
+    this->printLineBreak(result, options);
 }
 
 
-Node * ElementDTD::_copy(void) const {
-    return new ElementDTD(*this);
+Node * ElementDTD::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) ElementDTD(*this, resource);
 }
\ No newline at end of file
@@ -21,6 +21,7 @@
  * The recognized attributes for this class are:
  *  - 'element_name' ... the name of the element which this DTD describes
  *  - 'element_content' ... the content of the element description
+ *  - 'element_modifier' ... the modifier following the brackets of the content ('?', '*' or '+', none if not present)
 */
 class ElementDTD : public DTD {
 
@@ -30,8 +31,14 @@ class ElementDTD : public DTD {
          *  @param content the content of the element description (rendered in parentheses)
          *  @param indent whether the DTD should be indented if nested
          *  @param endLine whether the DTD should end the line it's on
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        ElementDTD(std::string const & elementName = "default_element", std::string const & elementContent = "", bool indent = true, bool endLine = true);
+        ElementDTD(std::string const & elementName = "default_element", std::string const & elementContent = "", bool indent = true, bool endLine = true, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
+        */
+        ElementDTD(ElementDTD const & original, std::pmr::memory_resource * resource = nullptr);
 
 
         /* Specific content manipulation member functions */
@@ -56,6 +63,12 @@ class ElementDTD : public DTD {
         /** Returns the specified Element content, as a single string */
         std::string getElementContent(void) const;
 
+        /** Sets the modifier following the brackets of the content ("?", "*" or "+", or an empty string for none), such as in (a | b)* */
+        void setElementModifier(std::string const & elementModifier);
+
+        /** Returns the modifier following the brackets of the content (an empty string if none) */
+        std::string getElementModifier(void) const;
+
         /** Sets the name of the described XML element */
         void setElementName(std::string const & elementName);
 
@@ -82,13 +95,14 @@ class ElementDTD : public DTD {
 
         /* Other functions */
 
-        /** Returns the processed XML of the Element DTD, with the specified content enclosed in brackets, if applicable */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML of the Element DTD to the given string, with the specified content enclosed in brackets followed by the modifier, if applicable */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
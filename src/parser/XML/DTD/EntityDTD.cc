@@ -1,8 +1,8 @@
 #include "EntityDTD.hh"
 
-EntityDTD::EntityDTD(std::string const & entityName, std::string const & entityValue, bool stringValue, bool indent, bool endLine) {
+EntityDTD::EntityDTD(std::string const & entityName, std::string const & entityValue, bool stringValue, bool indent, bool endLine, std::pmr::memory_resource * resource)
+    : DTD(NodeTypeName::EntityDTD, resource) {
     this->setName(DTD_ENTITY, false);
-    this->nodeType = NodeTypeName::EntityDTD;
     this->setEntityName(entityName);
     this->setEntityValue(entityValue);
     this->stringValue = stringValue;
@@ -10,6 +10,10 @@ EntityDTD::EntityDTD(std::string const & entityName, std::string const & entityV
     this->endLine = endLine;
 }
 
+EntityDTD::EntityDTD(EntityDTD const & original, std::pmr::memory_resource * resource) : DTD(original, resource) {
+    this->stringValue = original.stringValue;
+}
+
 void EntityDTD::setEntityName(std::string const & name) {
     this->setAttribute("entity_name", name);
 }
@@ -21,6 +25,8 @@ std::string EntityDTD::getEntityName(void) const {
 void EntityDTD::setEntityValue(std::string const & value, bool isString) {
     this->setAttribute("entity_value", value);
     this->stringValue = isString;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 std::string EntityDTD::getEntityValue(void) const {
@@ -29,6 +35,8 @@ std::string EntityDTD::getEntityValue(void) const {
 
 void EntityDTD::setStringValue(bool isString) {
     this->stringValue = isString;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool EntityDTD::getStringValue(void) const {
@@ -54,17 +62,14 @@ void EntityDTD::delContent(void) {
 
 /* Other functions */
 
-std::string EntityDTD::print(int indentLevel) {
-    std::string result;
+void EntityDTD::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
     /* Indent if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
-    }
+    this->printIndent(result, indentLevel, options);
 
-    result += "<!" + this->name + " " + this->getEntityName() + " ";
+    result += "<!";
+    result += this->name;
+    result += " " + this->getEntityName() + " ";
     
     if(this->stringValue) 
         result += "\"" + this->getEntityValue() + "\"";
@@ -73,12 +78,11 @@ std::string EntityDTD::print(int indentLevel) {
     
     result += ">";
 
-    if(this->endLine)
-        result += "\n";
-
-    return result;
+    this->printLineBreak(result, options);
 }
 
-Node * EntityDTD::_copy(void) const {
-    return new EntityDTD(*this);
+Node * EntityDTD::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) EntityDTD(*this, resource);
 }
\ No newline at end of file
@@ -35,8 +35,14 @@ class EntityDTD : public DTD {
          *  @param stringValue if true, the value is treated as a string and is enclosed in quotes (set to false for fully custom value, e.g. for external entities)
          *  @param indent whether the DTD should be indented if nested
          *  @param endLine whether the DTD should end the line it's on
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        EntityDTD(std::string const & entityName = "_default_entity", std::string const & entityValue = "_default_entity_value", bool stringValue = true, bool indent = true, bool endLine = true);
+        EntityDTD(std::string const & entityName = "_default_entity", std::string const & entityValue = "_default_entity_value", bool stringValue = true, bool indent = true, bool endLine = true, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
+        */
+        EntityDTD(EntityDTD const & original, std::pmr::memory_resource * resource = nullptr);
 
         /** Sets the 'entity_name' attribute of the XML Entity */
         void setEntityName(std::string const & name);
@@ -68,13 +74,14 @@ class EntityDTD : public DTD {
 
         /* Other functions */
 
-        /** Returns the processed XML of the Entity DTD */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML of the Entity DTD to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
@@ -0,0 +1,79 @@
+#include "NameTable.hh"
+
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+/* Internal storage */
+
+/** The interned strings, and the ids of the strings (keyed by views of the stored strings, which never move in the deque) */
+struct NameStorage {
+    std::shared_mutex lock;
+    std::deque<std::string> strings;
+    std::unordered_map<std::string_view, uint32_t> ids;
+
+    NameStorage(void) {
+        /* The empty string is always the first one, so that NAME_NONE is its id */
+        this->strings.emplace_back();
+        this->ids.emplace(std::string_view(this->strings.back()), NAME_NONE);
+    }
+};
+
+static NameStorage & storage(void) {
+    static NameStorage instance;
+    return instance;
+}
+
+
+/* Public static functions */
+
+uint32_t NameTable::intern(std::string_view value) {
+    NameStorage & names = storage();
+    {
+        std::shared_lock<std::shared_mutex> guard(names.lock);
+        auto it = names.ids.find(value);
+        if(it != names.ids.end())
+            return it->second;
+    }
+    /* Interning under the exclusive lock, the string possibly interned by another thread in the meantime */
+    std::unique_lock<std::shared_mutex> guard(names.lock);
+    auto it = names.ids.find(value);
+    if(it != names.ids.end())
+        return it->second;
+    uint32_t id = (uint32_t)names.strings.size();
+    names.strings.emplace_back(value);
+    names.ids.emplace(std::string_view(names.strings.back()), id);
+    return id;
+}
+
+bool NameTable::find(std::string_view value, uint32_t * id) {
+    NameStorage & names = storage();
+    std::shared_lock<std::shared_mutex> guard(names.lock);
+    auto it = names.ids.find(value);
+    if(it == names.ids.end())
+        return false;
+    *id = it->second;
+    return true;
+}
+
+std::string NameTable::lookup(uint32_t id) {
+    NameStorage & names = storage();
+    std::shared_lock<std::shared_mutex> guard(names.lock);
+    if(id < names.strings.size())
+        return names.strings[id];
+    return "";
+}
+
+ExpandedName NameTable::expand(std::string_view namespaceURI, std::string_view localName) {
+    ExpandedName result;
+    result.namespaceId = NameTable::intern(namespaceURI);
+    result.localNameId = NameTable::intern(localName);
+    return result;
+}
+
+size_t NameTable::size(void) {
+    NameStorage & names = storage();
+    std::shared_lock<std::shared_mutex> guard(names.lock);
+    return names.strings.size();
+}
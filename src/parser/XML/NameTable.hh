@@ -0,0 +1,74 @@
+/**
+ * @file NameTable.hh
+ * @author Linux-Tech-Tips
+ * @brief Interned names and namespaces header
+ *
+ * The header declaring the process-wide table of interned strings (namespace URIs and local names),
+ * and the expanded name of a Node, a pair of interned ids which is compared as two integers
+ */
+#ifndef NAME_TABLE_H
+#define NAME_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+
+/** The id of the empty string - as a namespace id, meaning no namespace */
+#define NAME_NONE 0u
+/** The id of a name which couldn't be resolved (e.g. a prefix without any namespace bound to it), never equal to any interned id */
+#define NAME_UNRESOLVED 0xFFFFFFFFu
+
+/** The namespace bound to the "xml" prefix in every document */
+#define NAMESPACE_XML "http://www.w3.org/XML/1998/namespace"
+/** The namespace of the namespace declaring "xmlns" attributes */
+#define NAMESPACE_XMLNS "http://www.w3.org/2000/xmlns/"
+
+/** The namespace URI and the local name of an element or attribute, as ids interned in the @ref NameTable */
+struct ExpandedName {
+    /** The id of the namespace URI (NAME_NONE if in no namespace, NAME_UNRESOLVED if the prefix isn't bound) */
+    uint32_t namespaceId = NAME_UNRESOLVED;
+    /** The id of the local name (the part of the name after the prefix) */
+    uint32_t localNameId = NAME_UNRESOLVED;
+
+    /** Returns whether both the namespace and the local name are resolved */
+    bool isResolved(void) const { return this->namespaceId != NAME_UNRESOLVED && this->localNameId != NAME_UNRESOLVED; }
+
+    /** Returns whether both names are resolved and equal (names which aren't resolved never match) */
+    bool matches(ExpandedName const & other) const { return this->isResolved() && this->namespaceId == other.namespaceId && this->localNameId == other.localNameId; }
+
+    bool operator==(ExpandedName const & other) const { return this->namespaceId == other.namespaceId && this->localNameId == other.localNameId; }
+    bool operator!=(ExpandedName const & other) const { return !(*this == other); }
+};
+
+/**
+ * @class NameTable
+ * @author Linux-Tech-Tips
+ * @brief Process-wide table of interned names
+ *
+ * Assigns each distinct string a permanent id, so that names resolved in any document (on any thread) can be compared as integers.
+ * Interned strings are never removed, so the table only grows with the amount of distinct names and namespaces, not with the amount of documents.
+ * All functions are thread-safe - looking up an interned string only takes a shared lock.
+*/
+class NameTable {
+
+    public:
+        /** Returns the id of the given string, interning it if it isn't interned yet (the empty string is always NAME_NONE) */
+        static uint32_t intern(std::string_view value);
+
+        /** Saves the id of the given string into id if it's interned, without interning it
+         *  @return false if the string isn't interned (nothing is saved)
+        */
+        static bool find(std::string_view value, uint32_t * id);
+
+        /** Returns the interned string with the given id (empty if the id isn't interned) */
+        static std::string lookup(uint32_t id);
+
+        /** Returns the expanded name of the given namespace URI (empty for no namespace) and local name, interning both */
+        static ExpandedName expand(std::string_view namespaceURI, std::string_view localName);
+
+        /** Returns the amount of interned strings */
+        static size_t size(void);
+
+};
+
+#endif /* NAME_TABLE_H */
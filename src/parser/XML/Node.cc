@@ -1,20 +1,129 @@
 #include "Node.hh"
 
+#include <cstddef>
+#include <cstring>
+
+/* Internal auxiliary structures */
+
+/** The header stored in front of each allocated Node object, so that the object can be returned to the resource it was allocated from */
+struct NodeAllocation {
+    /** The memory resource the Node object was allocated from */
+    std::pmr::memory_resource * resource;
+    /** The size of the whole allocation, including the header */
+    size_t size;
+};
+
+/** The space taken by the header in front of each allocated Node object (keeping the object itself at the maximum alignment) */
+static size_t const allocationHeaderSize = ((sizeof(NodeAllocation) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t)) * alignof(std::max_align_t);
+
+
 /* Private member functions */
 
-bool Node::checkName(std::string name, bool xmlReserved) {
-    return std::regex_match(name, std::regex("(_|[a-zA-Z])[\\w\\-\\.]*")) && (!xmlReserved || name != "xml");
+bool Node::checkName(std::string const & name, bool xmlReserved) {
+    /* Checked by hand, matching the expression ((_|[a-zA-Z])[\w\-\.]*:)?(_|[a-zA-Z])[\w\-\.]* (an optional namespace prefix and the local name)
+     * without the cost of running a regular expression for each Node */
+    bool start = true;
+    bool prefixed = false;
+    for(char c : name) {
+        bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        if(start) {
+            if(!letter)
+                return false;
+            start = false;
+        } else if(c == ':') {
+            if(prefixed)
+                return false;
+            prefixed = true;
+            start = true;
+        } else if(!(letter || (c >= '0' && c <= '9') || c == '-' || c == '.')) {
+            return false;
+        }
+    }
+    if(start)
+        return false;
+    return (!xmlReserved || name != "xml");
+}
+
+
+/* Protected constructor */
+
+Node::Node(NodeTypeName nodeType, std::pmr::memory_resource * resource)
+    : name(resource ? resource : std::pmr::get_default_resource()), attributes(resource ? resource : std::pmr::get_default_resource()),
+      attributeNames(resource ? resource : std::pmr::get_default_resource()) {
+    this->nodeType = nodeType;
+    this->endLine = true;
+    this->indent = true;
+    this->sourceBegin = std::string::npos;
+    this->sourceEnd = std::string::npos;
+    this->dirty = true;
+    this->nestedDirty = true;
+    this->references = 1;
+    this->leaked = false;
+    this->hash = 0;
 }
 
 /* Constructor */
 
-Node::Node(std::string const & name, bool endLine, bool indent) {
+Node::Node(std::string const & name, bool endLine, bool indent, std::pmr::memory_resource * resource) : Node(NodeTypeName::Node, resource) {
     this->setName(name);
-    this->nodeType = NodeTypeName::Node;
     this->endLine = endLine;
     this->indent = indent;
 }
 
+Node::Node(Node const & original, std::pmr::memory_resource * resource)
+    : name(original.name, resource ? resource : original.getResource()), attributes(original.attributes, resource ? resource : original.getResource()),
+      expandedName(original.expandedName), attributeNames(original.attributeNames, resource ? resource : original.getResource()) {
+    this->nodeType = original.nodeType;
+    this->endLine = original.endLine;
+    this->indent = original.indent;
+    /* The copy represents the same loaded text as the original */
+    this->sourceBegin = original.sourceBegin;
+    this->sourceEnd = original.sourceEnd;
+    this->dirty = original.dirty;
+    this->nestedDirty = original.nestedDirty;
+    /* The copy is a new Node, only referenced by its creator */
+    this->references = 1;
+    this->leaked = false;
+    this->hash = original.hash.load(std::memory_order_relaxed);
+}
+
+
+/* Allocation */
+
+void * Node::operator new(size_t size) {
+    return Node::operator new(size, nullptr);
+}
+
+void * Node::operator new(size_t size, std::pmr::memory_resource * resource) {
+    if(!resource)
+        resource = std::pmr::get_default_resource();
+
+    /* Saving the resource and the size in front of the object, so that delete doesn't need to know them */
+    size += allocationHeaderSize;
+    void * memory = resource->allocate(size, alignof(std::max_align_t));
+    NodeAllocation * header = (NodeAllocation *)memory;
+    header->resource = resource;
+    header->size = size;
+    return (char *)memory + allocationHeaderSize;
+}
+
+void Node::operator delete(void * pointer) {
+    if(pointer) {
+        NodeAllocation * header = (NodeAllocation *)((char *)pointer - allocationHeaderSize);
+        header->resource->deallocate(header, header->size, alignof(std::max_align_t));
+    }
+}
+
+void Node::operator delete(void * pointer, std::pmr::memory_resource * resource) {
+    /* The resource is saved in the header as well */
+    (void)resource;
+    Node::operator delete(pointer);
+}
+
+std::pmr::memory_resource * Node::getResource(void) const {
+    return this->attributes.get_allocator().resource();
+}
+
 /* Public member functions */
 
 /* Name */
@@ -29,10 +138,14 @@ void Node::setName(std::string const & name, bool checkName) {
     } else {
         this->name = name;
     }
+    /* The new name isn't resolved in any scope */
+    this->expandedName = ExpandedName();
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 std::string Node::getName(void) const {
-    return this->name;
+    return std::string(this->name);
 }
 
 /* Type */
@@ -45,19 +158,46 @@ NodeTypeName Node::getNodeType(void) const {
 /* Attribute */
 
 void Node::setAttribute(std::string const & name, std::string const & value) {
-    this->attributes[name] = value;
+    /* Looking up with a view, so that no key string is allocated unless the attribute is new */
+    auto it = this->attributes.find(std::string_view(name));
+    if(it != this->attributes.end()) {
+        it->second = value;
+    } else {
+        /* The new attribute shifts the order of the resolved names */
+        this->attributes.emplace(name, value);
+        this->attributeNames.clear();
+    }
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 std::string Node::getAttribute(std::string const & name) const {
-    if(this->attributes.find(name) != this->attributes.end())
-        return this->attributes.at(name);
+    auto it = this->attributes.find(std::string_view(name));
+    if(it != this->attributes.end())
+        return std::string(it->second);
     else
         return "";
 }
 
+bool Node::hasAttribute(std::string const & name) const {
+    return (this->attributes.find(std::string_view(name)) != this->attributes.end());
+}
+
 void Node::delAttribute(std::string const & name) {
-    if(this->attributes.find(name) != this->attributes.end())
-        this->attributes.erase(name);
+    auto it = this->attributes.find(std::string_view(name));
+    if(it != this->attributes.end()) {
+        this->attributes.erase(it);
+        this->attributeNames.clear();
+    }
+    this->dirty = true;
+    this->invalidateHash();
+}
+
+void Node::clearAttributes(void) {
+    this->attributes.clear();
+    this->attributeNames.clear();
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 size_t Node::getAttributeNumber(void) const {
@@ -68,11 +208,76 @@ bool Node::isAttributeEmpty(void) const {
     return this->attributes.empty();
 }
 
+NodeAttributes const & Node::getAttributes(void) const {
+    return this->attributes;
+}
+
+
+/* Namespaces */
+
+ExpandedName Node::getExpandedName(void) const {
+    return this->expandedName;
+}
+
+std::string Node::getNamespaceURI(void) const {
+    if(!this->expandedName.isResolved())
+        return "";
+    return NameTable::lookup(this->expandedName.namespaceId);
+}
+
+std::string Node::getPrefix(void) const {
+    size_t colon = this->name.find(':');
+    if(colon == std::string::npos)
+        return "";
+    return std::string(std::string_view(this->name).substr(0, colon));
+}
+
+std::string Node::getLocalName(void) const {
+    size_t colon = this->name.find(':');
+    if(colon == std::string::npos)
+        return std::string(this->name);
+    return std::string(std::string_view(this->name).substr(colon + 1));
+}
+
+std::string Node::getAttribute(ExpandedName const & name) const {
+    /* The resolved names are in the order of the attributes map */
+    auto it = this->attributes.begin();
+    for(size_t i = 0; i < this->attributeNames.size(); i++, ++it) {
+        if(this->attributeNames[i].matches(name))
+            return std::string(it->second);
+    }
+    return "";
+}
+
+bool Node::hasAttribute(ExpandedName const & name) const {
+    for(ExpandedName const & it : this->attributeNames) {
+        if(it.matches(name))
+            return true;
+    }
+    return false;
+}
+
+bool Node::hasAttributeNames(void) const {
+    return this->attributeNames.size() == this->attributes.size();
+}
+
+void Node::_setExpandedName(ExpandedName name) {
+    this->expandedName = name;
+}
+
+void Node::_setAttributeNames(std::vector<ExpandedName> const & names) {
+    if(names.size() != this->attributes.size())
+        throw std::invalid_argument("Error: The amount of attribute names doesn't match the amount of attributes");
+    this->attributeNames.assign(names.begin(), names.end());
+}
+
 
 /* Other*/
 
 void Node::setEndLine(bool endLine) {
     this->endLine = endLine;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool Node::getEndLine(void) const {
@@ -81,39 +286,193 @@ bool Node::getEndLine(void) const {
 
 void Node::setIndent(bool indent) {
     this->indent = indent;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool Node::getIndent(void) const {
     return this->indent;
 }
 
-std::string Node::print(int indentLevel) {
+std::string Node::print(int indentLevel, XmlWriteOptions const & options) {
     std::string result;
+    this->printTo(result, indentLevel, options);
+    return result;
+}
+
+void Node::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
     
     /* Indent if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++)
-            result += "\t";    
-    }
+    this->printIndent(result, indentLevel, options);
 
-    result += "<" + this->name;
+    result += "<";
+    result += this->name;
 
     /* Attributes if any */
-    for(auto it : this->attributes) {
+    this->printAttributes(result);
+
+    result += (options.mode == XmlWriteMode::Minified ? "/>" : " />");
+
+    /* Line break if not single line */
+    this->printLineBreak(result, options);
+}
+
+void Node::printIndent(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
+    if(indentLevel <= 0)
+        return;
+    if(options.mode == XmlWriteMode::KeepOriginal && this->indent)
+        result.append((size_t)indentLevel, '\t');
+    else if(options.mode == XmlWriteMode::Indented && options.indentSize > 0 && !options.singleLine)
+        result.append((size_t)indentLevel * (size_t)options.indentSize, ' ');
+}
+
+void Node::printLineBreak(std::string & result, XmlWriteOptions const & options) const {
+    if((options.mode == XmlWriteMode::Indented && !options.singleLine) || (options.mode == XmlWriteMode::KeepOriginal && this->endLine))
+        result += "\n";
+}
+
+XmlWriteOptions const & Node::getSingleLineOptions(XmlWriteOptions const & options) {
+    /* Keeping the Indented mode, so that self-closing tags are printed the same as on the other lines */
+    static XmlWriteOptions const singleLine = { XmlWriteMode::Indented, 0, true };
+    return (options.mode == XmlWriteMode::Indented ? singleLine : options);
+}
+
+void Node::printAttributes(std::string & result) const {
+    for(auto const & it : this->attributes) {
         result += " ";
         result += it.first;
-        result += "=\"" + it.second + "\"";
+        result += "=\"";
+        result += it.second;
+        result += "\"";
     }
+}
 
-    result += " />";
 
-    /* Line break if not single line */
-    if(this->endLine)
-        result += "\n";
+/* Hashing */
+
+void Node::invalidateHash(void) {
+    this->hash.store(0, std::memory_order_relaxed);
+}
+
+uint64_t Node::computeHash(bool * cacheable) const {
+    (void)cacheable;
+    uint64_t result = Node::hashCombine(0, (uint64_t)this->nodeType);
+    result = Node::hashBytes(result, this->name);
+    /* The attributes are always in the same (sorted) order */
+    result = Node::hashCombine(result, this->attributes.size());
+    for(auto const & it : this->attributes) {
+        result = Node::hashBytes(result, it.first);
+        result = Node::hashBytes(result, it.second);
+    }
+    return result;
+}
+
+uint64_t Node::storeHash(uint64_t result, bool cacheable) const {
+    /* 0 marks a hash which isn't computed */
+    if(result == 0)
+        result = 1;
+    if(cacheable)
+        this->hash.store(result, std::memory_order_relaxed);
+    return result;
+}
+
+uint64_t Node::hashBytes(uint64_t seed, std::string_view data) {
+    uint64_t result = seed;
+    size_t i = 0;
+    for(; i + 8 <= data.length(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data.data() + i, 8);
+        result = Node::hashCombine(result, word);
+    }
+    uint64_t rest = 0;
+    std::memcpy(&rest, data.data() + i, data.length() - i);
+    result = Node::hashCombine(result, rest);
+    return Node::hashCombine(result, data.length());
+}
+
+uint64_t Node::hashCombine(uint64_t seed, uint64_t value) {
+    /* Multiplying into 128 bits and folding the halves together, so that every bit of both values affects every bit of the result */
+    unsigned __int128 product = (unsigned __int128)(seed ^ 0xa0761d6478bd642fULL) * (value ^ 0xe7037ed1a0b428dbULL);
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+uint64_t Node::getHash(void) const {
+    uint64_t cached = this->hash.load(std::memory_order_relaxed);
+    if(cached != 0)
+        return cached;
+    bool cacheable = true;
+    return this->storeHash(this->computeHash(&cacheable), cacheable);
+}
+
+bool Node::_isLeaked(void) const {
+    return this->leaked;
+}
+
+
+/* Modification tracking */
+
+bool Node::isDirty(void) const {
+    return this->dirty;
+}
+
+bool Node::isNestedDirty(void) const {
+    return this->nestedDirty;
+}
+
+void Node::_setSource(size_t begin, size_t end) {
+    this->sourceBegin = begin;
+    this->sourceEnd = end;
+    /* A Node detached from the loaded text has to be printed whole */
+    this->dirty = (begin == std::string::npos);
+    this->nestedDirty = this->dirty;
+}
 
+size_t Node::_getSourceBegin(void) const {
+    return this->sourceBegin;
+}
+
+size_t Node::_getSourceEnd(void) const {
+    return this->sourceEnd;
+}
+
+Node * Node::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) Node(*this, resource);
+}
+
+
+/* Sharing */
+
+Node * Node::_share(std::pmr::memory_resource * resource) {
+    if(!resource)
+        resource = this->getResource();
+    if(this->leaked || resource != this->getResource())
+        return this->_copy(resource);
+    this->references.fetch_add(1, std::memory_order_relaxed);
+    return this;
+}
+
+void Node::_release(void) {
+    if(this->_releaseReference())
+        delete this;
+}
+
+bool Node::_releaseReference(void) {
+    /* The last parent deletes the Node (acquiring all modifications done by the other parents before they released it) */
+    return (this->references.fetch_sub(1, std::memory_order_acq_rel) == 1);
+}
+
+Node * Node::_modifiable(void) {
+    Node * result = this;
+    if(this->_isShared()) {
+        result = this->_copy();
+        this->_release();
+    }
+    result->leaked = true;
     return result;
 }
 
-Node * Node::_copy(void) const {
-    return new Node(*this);
+bool Node::_isShared(void) const {
+    return (this->references.load(std::memory_order_acquire) > 1);
 }
@@ -3,15 +3,24 @@
  * @author Linux-Tech-Tips
  * @brief Base XML Node class declaration header
  *
- * The header declaring the base XML Node class, containing a name and attributes, and a virtual print function
- * 
+ * The header declaring the base XML Node class, containing a name and attributes, and a virtual print function.
+ * All memory of a Node (the Node object if allocated using new, its strings, attributes and nested Nodes) can be taken from a specified std::pmr::memory_resource.
  */
 #ifndef NODE_H
 #define NODE_H
 
 #include <string>
+#include <string_view>
+#include <map>
 #include <stdexcept>
 #include <regex>
+#include <memory_resource>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+
+#include "NameTable.hh"
+#include "value_util.hh"
 
 /** An enumeration type defining named XML Node types, for convenience 
  * To test whether an instance of Node * type is a specific inheriting class, use this enumeration
@@ -41,6 +50,33 @@ enum class NodeTypeName {
     EntityDTD
 };
 
+/** The formatting of printed XML, see @ref XmlWriteOptions */
+enum class XmlWriteMode {
+    /** Indenting with tabs and ending lines as set on each Node (see @ref Node::setIndent and @ref Node::setEndLine) */
+    KeepOriginal,
+    /** Without any formatting whitespace - no indents, no line breaks, and no space before the end of self-closing tags */
+    Minified,
+    /** Every Node on its own line, indented by a fixed amount of spaces per nesting level (the content of single-line elements stays on one line) */
+    Indented
+};
+
+/**
+ * @struct XmlWriteOptions
+ * @author Linux-Tech-Tips
+ * @brief Options for printing and saving XML
+*/
+struct XmlWriteOptions {
+    /** The formatting of the printed XML */
+    XmlWriteMode mode = XmlWriteMode::KeepOriginal;
+    /** The amount of spaces per nesting level (Indented only) */
+    int indentSize = 4;
+    /** Whether all Nodes are printed on a single line, without indents or line breaks (Indented only, used for the content of single-line elements) */
+    bool singleLine = false;
+};
+
+/** The container holding the attributes of a Node, allocated from the memory resource of the Node (compares keys with any string type) */
+typedef std::pmr::map<std::pmr::string, std::pmr::string, std::less<>> NodeAttributes;
+
 /** 
  * @class Node
  * @author Linux-Tech-Tips
@@ -48,12 +84,21 @@ enum class NodeTypeName {
  * 
  * The base XML Node class, containing a name, attributes, general XML Node settings and a virtual print function. 
  * Is expected to be inherited from by extending classes, defining specific nodes with special behavior. 
+ * 
+ * Each Node uses a memory resource for its strings, attributes and nested Nodes (the default resource if none specified), 
+ * which can also be used to allocate the Node object itself, using 'new(resource) Node(..., resource)'. 
+ * Nodes allocated with new can always be deleted with delete, regardless of the memory resource used. 
+ * The memory resource must outlive all Nodes using it.
+ * 
+ * Nested Nodes are shared by copies of their parent (copy-on-write) - copying a parent only adds a reference to each nested Node,
+ * and a shared nested Node is only copied once a modifiable pointer to it is requested from the parent (see @ref _modifiable).
+ * Shared Nodes are released using @ref _release instead of delete.
 */
 class Node {
 
     protected:
         /** The name of the node, serves as an identifier and is printed in XML */
-        std::string name;
+        std::pmr::string name;
         /** The type of the XML node */
         NodeTypeName nodeType;
 
@@ -62,10 +107,61 @@ class Node {
         /** Whether the element should take the indent level into consideration */
         bool indent;
         /** The attributes of the node in key-value pairs, both keys and values printed in XML */
-        std::map<std::string, std::string> attributes;
+        NodeAttributes attributes;
+
+        /** The namespace and local name of the Node, resolved by the document it was loaded into (unresolved otherwise, see @ref XmlDocument::resolveNamespaces) */
+        ExpandedName expandedName;
+        /** The resolved namespaces and local names of the attributes, in the order of the attributes map (empty if not resolved, or if an attribute was added or deleted since) */
+        std::pmr::vector<ExpandedName> attributeNames;
+
+        /** The position of the first character of the Node's declaration in the text it was loaded from (std::string::npos if not loaded from text) */
+        size_t sourceBegin;
+        /** The position after the last character of the Node's declaration in the text it was loaded from, including the line break ending the Node, if any */
+        size_t sourceEnd;
+        /** Whether the Node itself (its name, attributes, content or settings) was modified since it was loaded */
+        bool dirty;
+        /** Whether any nested Nodes may have been modified, added or removed since the Node was loaded (also set when a modifiable nested Node is returned) */
+        bool nestedDirty;
+
+        /** The amount of parents (or documents) sharing the Node */
+        std::atomic<size_t> references;
+        /** Whether a modifiable pointer to the Node was returned by its parent, in which case the Node is never shared, since it can be modified through the pointer at any time */
+        bool leaked;
+        /** The cached hash of the Node's content and nested Nodes (0 if not computed yet, or if the Node was modified since) */
+        mutable std::atomic<uint64_t> hash;
+
+        /** Internal function which discards the cached hash, called by all functions modifying the Node or its nested Nodes */
+        void invalidateHash(void);
+
+        /** Internal function which computes the hash of the Node (see @ref getHash), extended by inheriting classes with additional content
+         *  @param cacheable set to false if the hash can't be cached, because a nested Node can be modified without this Node being notified
+        */
+        virtual uint64_t computeHash(bool * cacheable) const;
+
+        /** Internal function which returns the computed hash as returned by @ref getHash (never 0), caching it if cacheable */
+        uint64_t storeHash(uint64_t result, bool cacheable) const;
+
+        /** Internal auxiliary function which returns the given hash combined with the hash of the given bytes (including their length) */
+        static uint64_t hashBytes(uint64_t seed, std::string_view data);
+
+        /** Internal function which appends the indent of the Node at the given level to the result, as set by the write options (nothing if minified) */
+        void printIndent(std::string & result, int indentLevel, XmlWriteOptions const & options) const;
+        /** Internal function which appends the line break ending the Node to the result, as set by the write options (nothing if minified) */
+        void printLineBreak(std::string & result, XmlWriteOptions const & options) const;
+        /** Internal function which appends the attributes of the Node to the result, each preceded by a space */
+        void printAttributes(std::string & result) const;
+        /** Internal auxiliary function which returns the write options the nested Nodes of single-line Nodes are printed with
+         * (on a single line if indenting, so that they stay on the line of their parent)
+        */
+        static XmlWriteOptions const & getSingleLineOptions(XmlWriteOptions const & options);
 
         /** Internal function to check whether a given name is XML-compliant */
-        bool checkName(std::string name, bool xmlReserved = true);
+        bool checkName(std::string const & name, bool xmlReserved = true);
+
+        /** Constructor used by inheriting classes - sets the Node type and the memory resource, without setting or checking a name 
+         *  @param resource the memory resource to allocate the Node's content from (the default resource if null pointer)
+        */
+        Node(NodeTypeName nodeType, std::pmr::memory_resource * resource);
 
     public:
         /* Constructors */
@@ -73,13 +169,34 @@ class Node {
          *  @param name the name of the Node
          *  @param endLine whether the Node should end the line it's on
          *  @param indent whether the Node should be indented if nested
+         *  @param resource the memory resource to allocate the Node's content from (the default resource if null pointer)
+        */
+        Node(std::string const & name = "_default_node", bool endLine = true, bool indent = true, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
         */
-        Node(std::string const & name = "_default_node", bool endLine = true, bool indent = true);
+        Node(Node const & original, std::pmr::memory_resource * resource = nullptr);
 
         /* Destructor */
         virtual ~Node(void) = default;
 
 
+        /* Allocation */
+
+        /** Allocates a Node object from the default memory resource */
+        static void * operator new(size_t size);
+        /** Allocates a Node object from the given memory resource (the default resource if null pointer) */
+        static void * operator new(size_t size, std::pmr::memory_resource * resource);
+        /** Deallocates a Node object, returning the memory to the resource it was allocated from */
+        static void operator delete(void * pointer);
+        /** Deallocates a Node object whose constructor has thrown an exception */
+        static void operator delete(void * pointer, std::pmr::memory_resource * resource);
+
+        /** Returns the memory resource used by the Node */
+        std::pmr::memory_resource * getResource(void) const;
+
+
         /* Member functions */
 
         /* Name */
@@ -106,12 +223,56 @@ class Node {
         virtual void setAttribute(std::string const & name, std::string const & value);
         /** Returns the current value of the attribute with the given name */
         virtual std::string getAttribute(std::string const & name) const;
+        /** Returns whether the attribute with the given name exists */
+        virtual bool hasAttribute(std::string const & name) const;
         /** Deletes the attribute with the specified name */
         virtual void delAttribute(std::string const & name);
+        /** Deletes all attributes of the node */
+        virtual void clearAttributes(void);
         /** Returns the current amount of existing attributes */
         virtual size_t getAttributeNumber(void) const;
         /** Returns whether the attributes map is empty */
         virtual bool isAttributeEmpty(void) const;
+        /** Returns a constant reference to the attributes map, to go through all attributes of the node */
+        NodeAttributes const & getAttributes(void) const;
+        /** Converts the value of the attribute with the given name into the given type (bool, a number, see @ref value_parse), saving it into value.
+         * Reads the stored value in place, without copying it or throwing - the value is unchanged unless converted.
+         *  @return ValueError::None if converted, ValueError::Missing if the attribute doesn't exist, ValueError::Invalid or ValueError::OutOfRange otherwise
+        */
+        template <typename T>
+        ValueError getAttributeAs(std::string_view name, T * value) const {
+            auto it = this->attributes.find(name);
+            if(it == this->attributes.end())
+                return ValueError::Missing;
+            return value_parse(std::string_view(it->second), value);
+        }
+
+
+        /* Namespaces */
+
+        /** Returns the resolved namespace and local name of the node (unresolved if the document didn't resolve it, or if the name was changed since) */
+        ExpandedName getExpandedName(void) const;
+        /** Returns the namespace URI of the node (empty if in no namespace, or if not resolved) */
+        std::string getNamespaceURI(void) const;
+        /** Returns the prefix of the node's name (the part before ':', empty if none) */
+        std::string getPrefix(void) const;
+        /** Returns the local name of the node (the part of the name after the prefix, if any) */
+        std::string getLocalName(void) const;
+        /** Returns the value of the attribute with the given resolved namespace and local name (empty if not found, or if the attributes aren't resolved) */
+        std::string getAttribute(ExpandedName const & name) const;
+        /** Returns whether the attribute with the given resolved namespace and local name exists (false if the attributes aren't resolved) */
+        bool hasAttribute(ExpandedName const & name) const;
+        /** Returns whether the resolved names of the attributes are known (see @ref _setAttributeNames) */
+        bool hasAttributeNames(void) const;
+
+        /** Sets the resolved namespace and local name of the node, without marking it as modified
+         * Used internally when resolving namespaces - the name must correspond to the node's name
+        */
+        void _setExpandedName(ExpandedName name);
+        /** Sets the resolved namespaces and local names of all attributes, in the order of the attributes map, without marking the node as modified
+         * Used internally when resolving namespaces - names must contain one name for each attribute
+        */
+        void _setAttributeNames(std::vector<ExpandedName> const & names);
 
 
         /* Other */
@@ -125,12 +286,77 @@ class Node {
         /** Gets whether the element is indented */
         virtual bool getIndent(void) const;
         /** Returns the processed XML of the current node's name and attributes in XML angle brackets */
-        virtual std::string print(int indentLevel = 0);
+        virtual std::string print(int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions());
+        /** Appends the processed XML of the current node to the given string (used by print, so that nested nodes are printed into a single string)
+         *  @param options the formatting of the printed XML (see @ref XmlWriteOptions)
+        */
+        virtual void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
+
+
+
+        /* Hashing */
+
+        /** Returns a 64-bit hash of the Node's type, name, attributes, content and all nested Nodes (not covering formatting, such as indentation or line breaks),
+         * so that Nodes with equal hashes can be assumed to have equal content. The hash is cached, and only recomputed once the Node or a nested Node is modified.
+         * A nested Node returned as modifiable (see @ref _modifiable) can be modified without its parent being notified, so the parents of such Nodes
+         * recompute their hash on each call (reusing the cached hashes of all other nested Nodes). 
+         * Can be called by any amount of threads at the same time, as long as the Node isn't modified (e.g. in a frozen document).
+        */
+        uint64_t getHash(void) const;
+
+        /** Returns the given hash combined with the given value, as used to combine the hashes of nested Nodes (and of the root-level Nodes of a document) */
+        static uint64_t hashCombine(uint64_t seed, uint64_t value);
+
+        /** Returns whether a modifiable pointer to the Node was returned by its parent (see @ref _modifiable) */
+        bool _isLeaked(void) const;
+
+
+        /* Modification tracking */
+
+        /** Returns whether the Node itself was modified since it was loaded (always true for Nodes not loaded from text) */
+        bool isDirty(void) const;
+        /** Returns whether any nested Nodes may have been modified, added or removed since the Node was loaded */
+        bool isNestedDirty(void) const;
+
+        /** Sets the range of the text the Node was loaded from, and marks the Node and its nested Nodes as unmodified.
+         * Used internally when loading - pass std::string::npos as both positions to detach the Node from the loaded text
+        */
+        void _setSource(size_t begin, size_t end);
+        /** Returns the position of the first character of the Node in the text it was loaded from (std::string::npos if not loaded from text) */
+        size_t _getSourceBegin(void) const;
+        /** Returns the position after the last character of the Node in the text it was loaded from (std::string::npos if not loaded from text) */
+        size_t _getSourceEnd(void) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        virtual Node * _copy(void) const;
+        virtual Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
+
+
+        /* Sharing (used internally by the parents of allocated Nodes) */
+
+        /** Returns this Node with a reference added for a new parent, or a copy of it if it can't be shared 
+         * (if a modifiable pointer to it was returned, or if the new parent uses a different memory resource)
+         *  @param resource the memory resource of the new parent (the resource of this Node if null pointer)
+        */
+        Node * _share(std::pmr::memory_resource * resource = nullptr);
+
+        /** Removes the reference of a parent, deleting the Node once it isn't referenced by any parent */
+        void _release(void);
+
+        /** Removes the reference of a parent without deleting the Node, returning whether it was the last reference (in which case the caller has to delete the Node).
+         * Used to delete nested Nodes without recursing (see @ref XmlElement::~XmlElement)
+        */
+        bool _releaseReference(void);
+
+        /** Returns a Node only referenced by the calling parent, to be modified - this Node if it isn't shared, otherwise a copy of it
+         * (releasing the parent's reference to this Node). The returned Node is never shared from then on.
+        */
+        Node * _modifiable(void);
+
+        /** Returns whether the Node is referenced by more than one parent */
+        bool _isShared(void) const;
 
 };
 
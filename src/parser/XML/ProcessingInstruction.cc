@@ -1,41 +1,34 @@
 #include "ProcessingInstruction.hh"
 
-ProcessingInstruction::ProcessingInstruction(std::string const & name, bool endLine, bool indent) {
+ProcessingInstruction::ProcessingInstruction(std::string const & name, bool endLine, bool indent, std::pmr::memory_resource * resource)
+    : Node(NodeTypeName::ProcessingInstruction, resource) {
     this->setName(name, false);
-    this->nodeType = NodeTypeName::ProcessingInstruction;
     this->endLine = endLine;
     this->indent = indent;
 }
 
+ProcessingInstruction::ProcessingInstruction(ProcessingInstruction const & original, std::pmr::memory_resource * resource) : Node(original, resource) {}
 
-std::string ProcessingInstruction::print(int indentLevel) {
-    std::string result;
+
+void ProcessingInstruction::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
     /* Indenting if desired */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
-    }
+    this->printIndent(result, indentLevel, options);
 
-    result += "<?" + this->name;
+    result += "<?";
+    result += this->name;
 
     /* Adding any user-defined attributes */
-    for(auto it : this->attributes) {
-        result += " ";
-        result += it.first;
-        result += "=\"" + it.second + "\"";
-    }
+    this->printAttributes(result);
 
     result += "?>";
 
-    if(this->endLine)
-        result += "\n";
-
-    return result;
+    this->printLineBreak(result, options);
 }
 
 
-Node * ProcessingInstruction::_copy(void) const {
-    return new ProcessingInstruction(*this);
+Node * ProcessingInstruction::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) ProcessingInstruction(*this, resource);
 }
\ No newline at end of file
@@ -26,16 +26,23 @@ class ProcessingInstruction : public Node {
          *  @param name the name/target of the processing instruction - shows up first when printed
          *  @param endLine whether the element should end the line it's on
          *  @param indent whether the element should be indented if nested
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        ProcessingInstruction(std::string const & name = "_default_processing_instruction", bool endLine = true, bool indent = false);
+        ProcessingInstruction(std::string const & name = "_default_processing_instruction", bool endLine = true, bool indent = false, std::pmr::memory_resource * resource = nullptr);
 
-        /** Returns the processed XML of the current Processing Instruction, including the target and any attributes */
-        std::string print(int indentLevel = 0);
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
+        */
+        ProcessingInstruction(ProcessingInstruction const & original, std::pmr::memory_resource * resource = nullptr);
+
+        /** Appends the processed XML of the current Processing Instruction, including the target and any attributes, to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
@@ -1,9 +1,9 @@
 #include "TextElement.hh"
 
 /* Private member functions */
-std::string TextElement::escapeContent(void) {
+std::string TextElement::escapeContent(void) const {
     std::string result;
-    for(char & it : this->textContent) {
+    for(char const & it : this->textContent) {
         switch(it) {
             case '"':
                 result += "&quot;";
@@ -30,34 +30,43 @@ std::string TextElement::escapeContent(void) {
 /* Constructors */
 TextElement::TextElement(
         std::string const & name, std::string const & content, 
-        bool showTag, bool indent, bool escapeSpecial
-    ) : TextElement(name, content, showTag, indent, showTag, escapeSpecial) {}
+        bool showTag, bool indent, bool escapeSpecial, std::pmr::memory_resource * resource
+    ) : TextElement(name, content, showTag, indent, showTag, escapeSpecial, resource) {}
 
-TextElement::TextElement(std::string const & name, std::string const & content, bool showTag, bool indent, bool endLine, bool escapeSpecial) {
+TextElement::TextElement(std::string const & name, std::string const & content, bool showTag, bool indent, bool endLine, bool escapeSpecial, std::pmr::memory_resource * resource)
+    : Node(NodeTypeName::TextElement, resource), textContent(content, this->getResource()) {
     this->setName(name);
-    this->nodeType = NodeTypeName::TextElement;
-    this->textContent = content;
     this->showTag = showTag;
     this->indent= indent;
     this->escapeSpecial = escapeSpecial;
     this->endLine = endLine;
 }
 
+TextElement::TextElement(TextElement const & original, std::pmr::memory_resource * resource)
+    : Node(original, resource), textContent(original.textContent, this->getResource()) {
+    this->showTag = original.showTag;
+    this->escapeSpecial = original.escapeSpecial;
+}
+
 /* Member functions */
 
 /* Text content */
 void TextElement::setContent(std::string const & content) {
     this->textContent = content;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
-std::string TextElement::getContent(void) {
-    return this->textContent;
+std::string TextElement::getContent(void) const {
+    return std::string(this->textContent);
 }
 
 
 /* Other */
 void TextElement::setShowTag(bool showTag) {
     this->showTag = showTag;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool TextElement::getShowTag(void) const {
@@ -66,28 +75,22 @@ bool TextElement::getShowTag(void) const {
 
 void TextElement::setEscapeSpecial(bool escapeSpecial) {
     this->escapeSpecial = escapeSpecial;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool TextElement::getEscapeSpecial(void) const {
     return this->escapeSpecial;
 }
 
-std::string TextElement::print(int indentLevel) {
-    std::string result;
+void TextElement::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
     /* Indent at the start */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
-    }
+    this->printIndent(result, indentLevel, options);
     /* Printing tag start if desired */
     if(this->showTag) {
-        result += "<" + this->name;
-        for(auto it : this->attributes) {
-            result += " ";
-            result += it.first;
-            result += "=\"" + it.second + "\"";
-        }
+        result += "<";
+        result += this->name;
+        this->printAttributes(result);
         result += ">";
     }
 
@@ -99,14 +102,26 @@ std::string TextElement::print(int indentLevel) {
     }
 
     /* Printing tag end if desired */
-    if(this->showTag)
-        result += "</" + this->name + ">";
-    if(this->endLine)
-        result += "\n";
+    if(this->showTag) {
+        result += "</";
+        result += this->name;
+        result += ">";
+    }
+    this->printLineBreak(result, options);
     
-    return result;
 }
 
-Node * TextElement::_copy(void) const {
-    return new TextElement(*this);
-}
\ No newline at end of file
+Node * TextElement::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) TextElement(*this, resource);
+}
+
+
+/* Hashing */
+
+uint64_t TextElement::computeHash(bool * cacheable) const {
+    uint64_t result = Node::computeHash(cacheable);
+    result = Node::hashCombine(result, ((uint64_t)this->showTag << 1) | (uint64_t)this->escapeSpecial);
+    return Node::hashBytes(result, this->textContent);
+}
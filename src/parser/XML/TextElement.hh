@@ -28,7 +28,7 @@ class TextElement: public Node {
 
     protected:
         /** Escapes any XML special characters in the element's content */
-        std::string escapeContent(void);
+        std::string escapeContent(void) const;
 
     protected:
         /** Whether the XML tag with the name and attributes should be shown */
@@ -36,7 +36,10 @@ class TextElement: public Node {
         /** Whether special characters are escaped upon rendering */
         bool escapeSpecial;
         /** The actual text content of the element */
-        std::string textContent;
+        std::pmr::string textContent;
+
+        /** Internal function which computes the hash of the element, including its text content (see @ref Node::getHash) */
+        uint64_t computeHash(bool * cacheable) const;
     
     public:
         /* Constructors */
@@ -48,8 +51,9 @@ class TextElement: public Node {
          *  @param showTag whether the XML tag with the name and optionally attributes is shown
          *  @param indent whether the element should be indented if nested
          *  @param escapeSpecial whether XML special characters should be escaped
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        TextElement(std::string const & name = "_default_text_element", std::string const & content = "", bool showTag = true, bool indent = true, bool escapeSpecial = true);
+        TextElement(std::string const & name = "_default_text_element", std::string const & content = "", bool showTag = true, bool indent = true, bool escapeSpecial = true, std::pmr::memory_resource * resource = nullptr);
         /** Constructor
          *  @param name the name of the element
          *  @param content the text content of the element
@@ -57,8 +61,14 @@ class TextElement: public Node {
          *  @param indent whether the element should be indented if nested
          *  @param endLine whether the element should end the line it's on
          *  @param escapeSpecial whether XML special characters should be escaped
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
+        */
+        TextElement(std::string const & name, std::string const & content, bool showTag, bool indent, bool endLine, bool escapeSpecial, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
         */
-        TextElement(std::string const & name, std::string const & content, bool showTag, bool indent, bool endLine, bool escapeSpecial);
+        TextElement(TextElement const & original, std::pmr::memory_resource * resource = nullptr);
 
 
         /* Member functions */
@@ -69,7 +79,15 @@ class TextElement: public Node {
         /** Sets the text content of the element */
         void setContent(std::string const & content);
         /** Returns the current text content of the element */
-        std::string getContent(void);
+        std::string getContent(void) const;
+        /** Converts the text content of the element into the given type (bool, a number, see @ref value_parse), saving it into value.
+         * Reads the stored content in place, without copying it or throwing - the value is unchanged unless converted.
+         *  @return ValueError::None if converted, ValueError::Invalid or ValueError::OutOfRange otherwise
+        */
+        template <typename T>
+        ValueError getContentAs(T * value) const {
+            return value_parse(std::string_view(this->textContent), value);
+        }
 
 
         /* Other */
@@ -82,13 +100,14 @@ class TextElement: public Node {
         void setEscapeSpecial(bool escapeSpecial);
         /** Gets whether XML special characters are to be escaped */
         bool getEscapeSpecial(void) const;
-        /** Returns the processed XML with the text content using the specified settings */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML with the text content using the specified settings to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
@@ -4,39 +4,63 @@
 /* === Public member functions === */
 
 /* Constructor */
-XmlElement::XmlElement(std::string const & name, bool singleLine, bool endLine, bool indent, bool checkName) {
+XmlElement::XmlElement(std::string const & name, bool singleLine, bool endLine, bool indent, bool checkName, std::pmr::memory_resource * resource)
+    : Node(NodeTypeName::XmlElement, resource), children(this->getResource()) {
     this->setName(name, checkName);
-    this->nodeType = NodeTypeName::XmlElement;
     this->singleLine = singleLine;
     this->indent = indent;
     this->endLine = endLine;
 }
 
 /* Copy constructor */
-XmlElement::XmlElement(XmlElement const & original) {
-    /* Copying all statically allocated members */
-    this->name = original.name;
-    this->nodeType = original.nodeType;
+XmlElement::XmlElement(XmlElement const & original, std::pmr::memory_resource * resource) : XmlElement(original, resource, true) {}
+
+XmlElement::XmlElement(XmlElement const & original, std::pmr::memory_resource * resource, bool copyChildren)
+    : Node(original, resource), children(this->getResource()) {
+    /* Copying all statically allocated members (the name and attributes are copied by the Node constructor) */
     this->singleLine = original.singleLine;
-    this->indent = original.indent;
-    this->endLine = original.endLine;
-    this->attributes = original.attributes;
-
-    /* Copying dynamically allocated child Nodes */
-    if(original.getChildAmount() > 0) {
-        for(auto it : original.children) {
-            this->pushBackChild(*it);
+    if(!copyChildren)
+        return;
+
+    /* Sharing the child Nodes with the original (adopting them directly, so that they keep representing the same loaded text)
+     * Child elements which can't be shared are copied without their children, which are then copied in turn using an explicit stack of copies and their originals
+    */
+    std::vector<std::pair<XmlElement *, XmlElement const *>> stack;
+    stack.push_back({ this, &original });
+    while(!stack.empty()) {
+        XmlElement * copy = stack.back().first;
+        XmlElement const * source = stack.back().second;
+        stack.pop_back();
+        copy->children.reserve(source->children.size());
+        for(auto it : source->children) {
+            if(it->getNodeType() == NodeTypeName::XmlElement && (it->_isLeaked() || it->getResource() != copy->getResource())) {
+                XmlElement * element = new(copy->getResource()) XmlElement(*(XmlElement const *)it, copy->getResource(), false);
+                copy->children.push_back(element);
+                stack.push_back({ element, (XmlElement const *)it });
+            } else {
+                copy->children.push_back(it->_share(copy->getResource()));
+            }
         }
     }
 }
 
 /* Destructor */
 XmlElement::~XmlElement(void) {
-    /* Deallocating any copies of child Nodes */
-    if(this->getChildAmount() > 0) {
-        for(auto it : this->children) {
-            delete it;
+    /* Releasing any child Nodes (deallocated unless shared with a copy)
+     * The children of each released child element are detached before it is deleted, and released in turn, so that deleting deep elements doesn't recurse
+    */
+    std::pmr::vector<Node *> pending(std::move(this->children));
+    while(!pending.empty()) {
+        Node * node = pending.back();
+        pending.pop_back();
+        if(!node->_releaseReference())
+            continue;
+        if(node->getNodeType() == NodeTypeName::XmlElement) {
+            XmlElement * element = (XmlElement *)node;
+            pending.insert(pending.end(), element->children.begin(), element->children.end());
+            element->children.clear();
         }
+        delete node;
     }
 }
 
@@ -47,36 +71,88 @@ XmlElement::~XmlElement(void) {
 
 /* Add/delete */
 void XmlElement::addChild(int pos, Node const & value) {
-    this->children.insert(this->children.begin() + pos, value._copy());
+    /* The added copy is detached from any loaded text, so that it is printed whole */
+    Node * child = value._copy(this->getResource());
+    child->_setSource(std::string::npos, std::string::npos);
+    this->children.insert(this->children.begin() + pos, child);
+    this->nestedDirty = true;
+    this->invalidateHash();
 }
 
 void XmlElement::delChild(int pos) {
     if((size_t)pos < this->children.size()) {
-        delete this->children.at(pos);
+        this->children.at(pos)->_release();
         this->children.erase(this->children.begin() + pos);
     } else {
         throw std::invalid_argument("Error: Can't erase at out-of-bounds index");
     }
+    this->nestedDirty = true;
+    this->invalidateHash();
 }
 
 void XmlElement::pushBackChild(Node const & value) {
-    this->children.push_back(value._copy());
+    this->addChild(this->children.size(), value);
 }
 
 void XmlElement::popBackChild(void) {
-    delete this->children.at(this->children.size()-1);
+    this->children.at(this->children.size()-1)->_release();
     this->children.pop_back();
+    this->nestedDirty = true;
+    this->invalidateHash();
+}
+
+void XmlElement::_adoptChild(Node * value) {
+    this->children.push_back(value);
+    this->nestedDirty = true;
+    this->invalidateHash();
 }
 
 /* Get a specific node */
 Node * XmlElement::getChild(int index) {
+    /* The returned child can be modified, so the nested Nodes can't be assumed unmodified anymore */
+    if((size_t)index < this->children.size()) {
+        this->nestedDirty = true;
+        this->invalidateHash();
+        this->children[index] = this->children[index]->_modifiable();
+        return this->children[index];
+    } else {
+        return nullptr;
+    }
+}
+
+Node * XmlElement::getChild(char const * childName, size_t offset) {
+    int index;
+    if(this->findChild(childName, &index, offset)) {
+        return this->getChild(index);
+    } else {
+        return nullptr;
+    }
+}
+
+Node const * XmlElement::getChild(int index) const {
     if((size_t)index < this->children.size())
         return this->children.at((size_t)index);
     else
         return nullptr;
 }
 
-Node * XmlElement::getChild(char const * childName, size_t offset) {
+Node const * XmlElement::getChild(char const * childName, size_t offset) const {
+    int index;
+    if(this->findChild(childName, &index, offset))
+        return this->children.at((size_t)index);
+    else
+        return nullptr;
+}
+
+Node * XmlElement::getChild(ExpandedName const & childName, size_t offset) {
+    int index;
+    if(this->findChild(childName, &index, offset))
+        return this->getChild(index);
+    else
+        return nullptr;
+}
+
+Node const * XmlElement::getChild(ExpandedName const & childName, size_t offset) const {
     int index;
     if(this->findChild(childName, &index, offset))
         return this->children.at((size_t)index);
@@ -100,11 +176,20 @@ size_t XmlElement::getChildAmount(char const * childName) const {
     return amount;
 }
 
+size_t XmlElement::getChildAmount(ExpandedName const & childName) const {
+    size_t amount = 0;
+    for(auto it : this->children) {
+        if(it->getExpandedName().matches(childName))
+            amount++;
+    }
+    return amount;
+}
+
 bool XmlElement::childrenEmpty(void) const {
     return this->children.empty();
 }
 
-bool XmlElement::findChild(char const * nameToFind, int * index, size_t offset) {
+bool XmlElement::findChild(char const * nameToFind, int * index, size_t offset) const {
     /* Checks all child elements */
     for(size_t i = 0; i < this->getChildAmount(); i++) {
         if(this->children[i]->getName().compare(nameToFind) == 0) {
@@ -125,65 +210,159 @@ bool XmlElement::findChild(char const * nameToFind, int * index, size_t offset)
     return false;
 }
 
+bool XmlElement::findChild(ExpandedName const & nameToFind, int * index, size_t offset) const {
+    /* Comparing the interned ids instead of the names */
+    for(size_t i = 0; i < this->children.size(); i++) {
+        if(this->children[i]->getExpandedName().matches(nameToFind)) {
+            if(offset > 0) {
+                offset--;
+            } else {
+                if(index)
+                    *index = i;
+                return true;
+            }
+        }
+    }
+    if(index)
+        *index = -1;
+    return false;
+}
+
 
 /* Other */
 void XmlElement::setSingleLine(bool singleLine) {
     this->singleLine = singleLine;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool XmlElement::getSingleLine(void) const {
     return this->singleLine;
 }
 
-std::string XmlElement::print(int indentLevel) {
-    /* Opening the element */
-    std::string result;
+bool XmlElement::printOpeningTag(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
     /* Indenting */
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++) {
-            result += "\t";
-        }
+    this->printIndent(result, indentLevel, options);
+    result += "<";
+    result += this->name;
+    this->printAttributes(result);
+
+    /* Self-closing empty element */
+    if(this->children.empty()) {
+        result += (options.mode == XmlWriteMode::Minified ? "/>" : " />");
+        this->printLineBreak(result, options);
+        return false;
     }
-    result += "<" + this->name;
-    for(auto it : this->attributes) {
-        result += " ";
-        result += it.first;
-        result += "=\"" + it.second + "\"";
+
+    /* Closing normally, the content added after */
+    result += ">";
+    if(!this->singleLine && options.mode != XmlWriteMode::Minified && !options.singleLine)
+        result += "\n";
+    return true;
+}
+
+void XmlElement::printClosingTag(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
+    /* Closing the element normally, with indents (regardless of the indent setting of the element, unless indenting by spaces) */
+    if(indentLevel > 0 && !this->singleLine) {
+        if(options.mode == XmlWriteMode::KeepOriginal)
+            result.append((size_t)indentLevel, '\t');
+        else
+            this->printIndent(result, indentLevel, options);
     }
+    result += "</";
+    result += this->name;
+    result += ">";
 
-    /* Closing normally, adding content if not empty */
-    if(this->children.size() > 0) {
-        result += ">";
-        if(!this->singleLine)
-            result += "\n";
-        
-        /* Adding child elements */
-        for(auto it : this->children) {
-            if(!this->singleLine)
-                result += it->print(indentLevel + 1);
-            else
-                result += it->print();
+    this->printLineBreak(result, options);
+}
+
+void XmlElement::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
+    /* Opening the element */
+    if(!this->printOpeningTag(result, indentLevel, options))
+        return;
+
+    /* Adding child elements, using an explicit stack of the elements being printed, along with the position of their next child, their indent level and write options */
+    struct Frame {
+        XmlElement const * element;
+        size_t next;
+        int indentLevel;
+        XmlWriteOptions const * options;
+    };
+    std::vector<Frame> stack;
+    stack.push_back({ this, 0, indentLevel, &options });
+    while(!stack.empty()) {
+        Frame & frame = stack.back();
+        if(frame.next >= frame.element->children.size()) {
+            frame.element->printClosingTag(result, frame.indentLevel, *frame.options);
+            stack.pop_back();
+            continue;
         }
 
-        /* Closing the element normally, with indents */
-        if(indentLevel > 0 && !this->singleLine) {
-            for(int i = 0; i < indentLevel; i++) {
-                result += "\t";
+        /* The children of single-line elements are printed without indents */
+        Node const * child = frame.element->children[frame.next++];
+        int childIndent = (frame.element->singleLine ? 0 : frame.indentLevel + 1);
+        XmlWriteOptions const & childOptions = (frame.element->singleLine ? Node::getSingleLineOptions(*frame.options) : *frame.options);
+        if(child->getNodeType() != NodeTypeName::XmlElement)
+            child->printTo(result, childIndent, childOptions);
+        else if(((XmlElement const *)child)->printOpeningTag(result, childIndent, childOptions))
+            stack.push_back({ (XmlElement const *)child, 0, childIndent, &childOptions });
+    }
+}
+
+Node * XmlElement::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) XmlElement(*this, resource);
+}
+
+
+/* Hashing */
+
+uint64_t XmlElement::computeHash(bool * cacheable) const {
+    /* The hashes of the child elements which aren't cached are computed first, using an explicit stack of the elements being hashed,
+     * so that hashing deep elements doesn't recurse (each element combines the hashes of its children once they are all known)
+    */
+    struct Frame {
+        XmlElement const * element;
+        size_t next;
+        uint64_t result;
+        bool cacheable;
+    };
+    std::vector<Frame> stack;
+    /* Starts hashing the given element, with the content of the element itself */
+    auto push = [&](XmlElement const * element) {
+        stack.push_back({ element, 0, 0, true });
+        stack.back().result = Node::hashCombine(element->Node::computeHash(&stack.back().cacheable), element->children.size());
+    };
+    push(this);
+
+    while(true) {
+        Frame & frame = stack.back();
+        if(frame.next < frame.element->children.size()) {
+            Node const * child = frame.element->children[frame.next++];
+            /* A child returned as modifiable can be modified without this element being notified */
+            if(child->_isLeaked())
+                frame.cacheable = false;
+            if(child->getNodeType() == NodeTypeName::XmlElement && ((XmlElement const *)child)->hash.load(std::memory_order_relaxed) == 0) {
+                push((XmlElement const *)child);
+            } else {
+                frame.result = Node::hashCombine(frame.result, child->getHash());
             }
+            continue;
         }
-        result += "</" + this->name + ">";
-    
-    /* Self-closing empty element */
-    } else {
-        result += " />";
-    }
 
-    if(this->endLine)
-        result += "\n";
+        /* All children of the element are hashed */
+        if(stack.size() == 1)
+            break;
+        uint64_t result = frame.element->storeHash(frame.result, frame.cacheable);
+        /* A hash which can't be cached makes the hashes of all elements containing it not cacheable either */
+        if(!frame.cacheable)
+            stack[stack.size()-2].cacheable = false;
+        stack.pop_back();
+        stack.back().result = Node::hashCombine(stack.back().result, result);
+    }
 
-    return result;
+    if(!stack.back().cacheable)
+        *cacheable = false;
+    return stack.back().result;
 }
-
-Node * XmlElement::_copy(void) const {
-    return new XmlElement(*this);
-}
\ No newline at end of file
@@ -27,10 +27,26 @@
 class XmlElement: public Node {
 
     protected:
-        /** The nested child Nodes of the element */
-        std::vector<Node *> children;
+        /** The nested child Nodes of the element (copies of added child Nodes are allocated from the element's memory resource), possibly shared with copies of the element */
+        std::pmr::vector<Node *> children;
         /** Whether the XmlElement should occupy only one line, including all its directly nested elements */
         bool singleLine;
+
+        /** Internal function which computes the hash of the element, including the hashes of all child elements (see @ref Node::getHash) */
+        uint64_t computeHash(bool * cacheable) const;
+
+        /** Copy constructor - copies the XmlElement, and if copyChildren is true, its child elements as well (see the public copy constructor)
+         * The child elements which can't be shared are copied without recursing, so that the depth of the element isn't limited by the size of the thread's stack
+        */
+        XmlElement(XmlElement const & original, std::pmr::memory_resource * resource, bool copyChildren);
+
+        /** Internal function which appends the opening tag of the element (or the whole element, if it has no child elements) to the given string,
+         * returning whether the child elements and the closing tag still have to be printed
+        */
+        bool printOpeningTag(std::string & result, int indentLevel, XmlWriteOptions const & options) const;
+
+        /** Internal function which appends the closing tag of the element to the given string */
+        void printClosingTag(std::string & result, int indentLevel, XmlWriteOptions const & options) const;
     
     public:
         /* Constructors (and destructor) */
@@ -41,12 +57,16 @@ class XmlElement: public Node {
          *  @param endLine whether the element should end the line it's on
          *  @param indent whether the element itself should be indented (if nested)
          *  @param checkName if true, check whether the specified name is XML compliant
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        XmlElement(std::string const & name = "_default_element", bool singleLine = false, bool endLine = true, bool indent = true, bool checkName = true);
+        XmlElement(std::string const & name = "_default_element", bool singleLine = false, bool endLine = true, bool indent = true, bool checkName = true, std::pmr::memory_resource * resource = nullptr);
 
-        /** Copy constructor - copies the XmlElement, along with all its child elements */
-        XmlElement(XmlElement const & original);
+        /** Copy constructor - copies the XmlElement, sharing all its child elements with the original until they are modified (see @ref Node)
+         *  @param resource the memory resource to allocate the copy's content and child elements from (the resource of the original if null pointer)
+        */
+        XmlElement(XmlElement const & original, std::pmr::memory_resource * resource = nullptr);
 
+        /** Destructor - releases the child elements, deleting the ones not shared with a copy (nested elements are deleted without recursing) */
         ~XmlElement(void);
 
 
@@ -65,20 +85,39 @@ class XmlElement: public Node {
         /** Remove a nested child element from the back of the list */
         void popBackChild(void);
 
+        /** Add an allocated nested child element to the end of the list, taking ownership of it instead of copying it
+         * Used internally - the passed Node is deleted by this element, and must not be deleted or used by the caller afterwards
+        */
+        void _adoptChild(Node * value);
+
         /** Get a pointer to the nested child element from the given position (or null pointer if out of bounds). 
          * The function exposes the pointer to the inner child Node directly, and therefore the returned pointer should not be deleted after use.
+         * If the child is shared with a copy of this element, it is copied first, so that it can be modified without affecting the copy.
         */
         Node * getChild(int index);
         /** Get a pointer to the n-th nested child element with the given name (or null pointer if not found or offset out of range). 
          * The function exposes the pointer to the inner child Node directly, and therefore the returned pointer should not be deleted after use.
+         * If the child is shared with a copy of this element, it is copied first, so that it can be modified without affecting the copy.
          *  @param offset which found named child to get (leave default or 0 for the first child; the amount of found named children specified by offset is skipped)
         */
         Node * getChild(char const * childName, size_t offset = 0);
+        /** Get a read-only pointer to the nested child element from the given position (or null pointer if out of bounds), without copying a shared child */
+        Node const * getChild(int index) const;
+        /** Get a read-only pointer to the n-th nested child element with the given name (or null pointer if not found), without copying a shared child */
+        Node const * getChild(char const * childName, size_t offset = 0) const;
+        /** Get a pointer to the n-th nested child element with the given resolved namespace and local name (or null pointer if not found or offset out of range), 
+         * copying a shared child first (see @ref getChild(char const *, size_t)). Only children with resolved names are matched (see @ref Node::getExpandedName).
+        */
+        Node * getChild(ExpandedName const & childName, size_t offset = 0);
+        /** Get a read-only pointer to the n-th nested child element with the given resolved namespace and local name (or null pointer if not found), without copying a shared child */
+        Node const * getChild(ExpandedName const & childName, size_t offset = 0) const;
         
         /** Get how many nested child elements are currently in this element */
         size_t getChildAmount(void) const;
         /** Get how many nested child elements with the specified name are currently in this element */
         size_t getChildAmount(char const * childName) const;
+        /** Get how many nested child elements with the specified resolved namespace and local name are currently in this element */
+        size_t getChildAmount(ExpandedName const & childName) const;
         /** Get whether no children present (the list is empty) */
         bool childrenEmpty(void) const;
 
@@ -86,7 +125,12 @@ class XmlElement: public Node {
          * @param index the saved index; if index < 0, element was not found (pass nullptr to not save index)
          * @param offset which named child to look for (leave default or 0 for the first child; the amount of found named children specified by offset is skipped)
         */
-        bool findChild(char const * nameToFind, int * index = nullptr, size_t offset = 0);
+        bool findChild(char const * nameToFind, int * index = nullptr, size_t offset = 0) const;
+        /** Returns whether an n-th child element with the given resolved namespace and local name exists and saves the index of the n-th match (compares two integers per child)
+         * @param index the saved index; if index < 0, element was not found (pass nullptr to not save index)
+         * @param offset which matching child to look for (leave default or 0 for the first child)
+        */
+        bool findChild(ExpandedName const & nameToFind, int * index = nullptr, size_t offset = 0) const;
 
 
         /* Other */
@@ -95,13 +139,14 @@ class XmlElement: public Node {
         void setSingleLine(bool singleLine);
         /** Get whether the whole element (including all nested Elements) is rendered on a single line*/
         bool getSingleLine(void) const;
-        /** Returns the processed XML using the specified settings and content */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML using the specified settings and content to the given string (nested elements are printed using an explicit stack, without recursing) */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 
 };
 
@@ -3,10 +3,9 @@
 /* Constructor */
 XmlProlog::XmlProlog(
     std::string const & name, float xmlVersion, std::string const & encoding, std::string const & standalone, 
-    bool endLine, bool indent, bool printUserAttributes) {
+    bool endLine, bool indent, bool printUserAttributes, std::pmr::memory_resource * resource) : Node(NodeTypeName::XmlProlog, resource) {
 
         this->setName(name, false);
-        this->nodeType = NodeTypeName::XmlProlog;
         this->setAttribute("xml_version", std::to_string(xmlVersion).substr(0, 3));
         this->setAttribute("encoding", encoding);
         this->setAttribute("standalone", standalone);
@@ -15,6 +14,10 @@ XmlProlog::XmlProlog(
         this->printUserAttributes = printUserAttributes;
 }
 
+XmlProlog::XmlProlog(XmlProlog const & original, std::pmr::memory_resource * resource) : Node(original, resource) {
+    this->printUserAttributes = original.printUserAttributes;
+}
+
 /* Public member functions */
 
 
@@ -57,6 +60,8 @@ void XmlProlog::unsetStandalone(void) {
 
 void XmlProlog::setUserAttributes(bool printUserAttributes) {
     this->printUserAttributes = printUserAttributes;
+    this->dirty = true;
+    this->invalidateHash();
 }
 
 bool XmlProlog::getUserAttributes(void) const {
@@ -66,20 +71,14 @@ bool XmlProlog::getUserAttributes(void) const {
 
 /* Other member functions */
 
-std::string XmlProlog::print(int indentLevel) {
-    std::string result;
+void XmlProlog::printTo(std::string & result, int indentLevel, XmlWriteOptions const & options) const {
 
-    if(this->indent && indentLevel > 0) {
-        for(int i = 0; i < indentLevel; i++)
-            result += "\t";
-    }
+    this->printIndent(result, indentLevel, options);
 
     result += "<?xml";
 
     if(this->printUserAttributes) {
-        for(auto it : this->attributes) {
-            result += " " + it.first + "=\"" + it.second + "\"";
-        }
+        this->printAttributes(result);
     } else {
 
         if(!this->getAttribute("xml_version").empty()) {
@@ -101,13 +100,12 @@ std::string XmlProlog::print(int indentLevel) {
 
     result += "?>";
 
-    if(this->endLine)
-        result += "\n";
-
-    return result;
+    this->printLineBreak(result, options);
 }
 
 
-Node * XmlProlog::_copy(void) const {
-    return new XmlProlog(*this);
+Node * XmlProlog::_copy(std::pmr::memory_resource * resource) const {
+    if(!resource)
+        resource = this->getResource();
+    return new(resource) XmlProlog(*this, resource);
 }
\ No newline at end of file
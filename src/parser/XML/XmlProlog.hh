@@ -46,8 +46,14 @@ class XmlProlog : public Node {
          *  @param endLine whether the element should end the line it's on
          *  @param indent whether the element should be indented if nested
          *  @param printUserAttributes whether user-defined additional attributes are printed - the recommended value is 'false'
+         *  @param resource the memory resource to allocate the content from (the default resource if null pointer)
         */
-        XmlProlog(std::string const & name = "_default_prolog_element", float xmlVersion = 1.0f, std::string const & encoding = "", std::string const & standalone = STANDALONE_UNSET, bool endLine = true, bool indent = false, bool printUserAttributes = false);
+        XmlProlog(std::string const & name = "_default_prolog_element", float xmlVersion = 1.0f, std::string const & encoding = "", std::string const & standalone = STANDALONE_UNSET, bool endLine = true, bool indent = false, bool printUserAttributes = false, std::pmr::memory_resource * resource = nullptr);
+
+        /** Copy constructor
+         *  @param resource the memory resource to allocate the copy's content from (the resource of the original if null pointer)
+        */
+        XmlProlog(XmlProlog const & original, std::pmr::memory_resource * resource = nullptr);
 
         /* Default XML prolog parameter member function */
 
@@ -79,13 +85,14 @@ class XmlProlog : public Node {
 
         /* Other member functions */
 
-        /** Returns the processed XML of the prolog with the specified settings */
-        std::string print(int indentLevel = 0);
+        /** Appends the processed XML of the prolog with the specified settings to the given string */
+        void printTo(std::string & result, int indentLevel = 0, XmlWriteOptions const & options = XmlWriteOptions()) const;
 
         /** Creates a dynamically allocated copy of itself
          * Used internally - if called by an end-user, make sure to delete the copy once not needed
+         *  @param resource the memory resource to allocate the copy from (the resource of this Node if null pointer)
         */
-        Node * _copy(void) const;
+        Node * _copy(std::pmr::memory_resource * resource = nullptr) const;
 };
 
 #endif /* XML_PROLOG_H */
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "value_util.hh"
+
+#include <charconv>
+#include <system_error>
+
+/* Internal auxiliary functions */
+
+/** Returns whether the given character is XML whitespace */
+static bool isWhitespace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/** Returns the given text without the whitespace around it */
+static std::string_view trim(std::string_view text) {
+    size_t begin = 0;
+    size_t end = text.length();
+    while(begin < end && isWhitespace(text[begin]))
+        begin++;
+    while(end > begin && isWhitespace(text[end-1]))
+        end--;
+    return text.substr(begin, end - begin);
+}
+
+/** Converts the whole given text into a number using std::from_chars, saving it into value only if the whole text is a number */
+template <typename T>
+static ValueError parseNumber(std::string_view text, T * value) {
+    text = trim(text);
+    /* std::from_chars doesn't accept a leading '+', which XML Schema numbers may have */
+    if(text.length() > 1 && text[0] == '+' && text[1] != '-')
+        text.remove_prefix(1);
+    if(text.empty())
+        return ValueError::Invalid;
+
+    T result;
+    std::from_chars_result converted = std::from_chars(text.data(), text.data() + text.length(), result);
+    if(converted.ec == std::errc::result_out_of_range)
+        return ValueError::OutOfRange;
+    if(converted.ec != std::errc() || converted.ptr != text.data() + text.length())
+        return ValueError::Invalid;
+    *value = result;
+    return ValueError::None;
+}
+
+
+/* Conversion functions */
+
+ValueError value_parse(std::string_view text, bool * value) {
+    text = trim(text);
+    if(text == "true" || text == "1") {
+        *value = true;
+    } else if(text == "false" || text == "0") {
+        *value = false;
+    } else {
+        return ValueError::Invalid;
+    }
+    return ValueError::None;
+}
+
+ValueError value_parse(std::string_view text, int * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, long * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, long long * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, unsigned int * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, unsigned long * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, unsigned long long * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, float * value) {
+    return parseNumber(text, value);
+}
+
+ValueError value_parse(std::string_view text, double * value) {
+    return parseNumber(text, value);
+}
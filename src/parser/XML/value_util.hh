@@ -0,0 +1,42 @@
+/**
+ * @file value_util.hh
+ * @author Linux-Tech-Tips
+ * @brief Typed value conversion
+ *
+ * Contains functions which convert the text of attribute values and text content into numbers and booleans, used by the typed accessors of the Nodes
+ * (see @ref Node::getAttributeAs and @ref TextElement::getContentAs). The text is read in place using std::from_chars, without copying it or throwing.
+ */
+
+#ifndef VALUE_UTIL_H
+#define VALUE_UTIL_H
+
+#include <string_view>
+
+/** The result of a typed value conversion */
+enum class ValueError {
+    /** The value was converted */
+    None,
+    /** The attribute doesn't exist */
+    Missing,
+    /** The text isn't a value of the requested type */
+    Invalid,
+    /** The text is a number which can't be represented in the requested type */
+    OutOfRange
+};
+
+/** Converts the given text into a value of the given type, saving it into value (unchanged unless converted).
+ * Whitespace around the value is ignored, and numbers may start with '+'. Booleans are "true", "false", "1" or "0" (as in XML Schema).
+ * Floating-point numbers are read in decimal or scientific notation, and as "inf" or "nan".
+ *  @return ValueError::None if converted, ValueError::Invalid or ValueError::OutOfRange otherwise
+*/
+ValueError value_parse(std::string_view text, bool * value);
+ValueError value_parse(std::string_view text, int * value);
+ValueError value_parse(std::string_view text, long * value);
+ValueError value_parse(std::string_view text, long long * value);
+ValueError value_parse(std::string_view text, unsigned int * value);
+ValueError value_parse(std::string_view text, unsigned long * value);
+ValueError value_parse(std::string_view text, unsigned long long * value);
+ValueError value_parse(std::string_view text, float * value);
+ValueError value_parse(std::string_view text, double * value);
+
+#endif /* VALUE_UTIL_H */
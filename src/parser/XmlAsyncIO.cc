@@ -0,0 +1,411 @@
+#include "XmlAsyncIO.hh"
+
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#include "file_util.hh"
+
+
+/* Internal auxiliary structures */
+
+/** A file being read or written in chunks */
+struct AsyncTransfer {
+    /** Whether the data is written (or read) */
+    bool write;
+    /** The transferred file */
+    int fd;
+    /** The data written into (or read from) the file */
+    char * data;
+    /** The amount of chunks not yet transferred */
+    std::atomic<size_t> remaining;
+    /** The first error which occured (0 if none) */
+    std::atomic<int> error;
+    /** Called once all chunks are transferred */
+    std::function<void(int)> done;
+};
+
+#if defined(__linux__) && defined(__NR_io_uring_setup)
+
+/** An io_uring instance, accessed using raw system calls, calling the handler of each operation from its completion thread */
+struct IoRing {
+    /** The io_uring file descriptor */
+    int fd;
+    /** The submission queue ring mapping */
+    void * sqRing;
+    /** The size of the submission queue ring mapping */
+    size_t sqRingSize;
+    /** The completion queue ring mapping (same as the submission queue ring mapping if the kernel maps both at once) */
+    void * cqRing;
+    /** The size of the completion queue ring mapping */
+    size_t cqRingSize;
+    /** The submission queue entries */
+    io_uring_sqe * sqes;
+    /** The size of the submission queue entries mapping */
+    size_t sqesSize;
+
+    /* Pointers into the mapped rings */
+    unsigned * sqTail;
+    unsigned * sqMask;
+    unsigned * sqArray;
+    unsigned * cqHead;
+    unsigned * cqTail;
+    unsigned * cqMask;
+    io_uring_cqe * cqes;
+
+    /** Lock held while submitting */
+    std::mutex lock;
+    /** The thread calling the handlers of completed operations */
+    std::thread completions;
+
+    /** Creates the io_uring instance, returning null pointer if io_uring isn't available or not recent enough */
+    static std::unique_ptr<IoRing> create(unsigned entries);
+
+    /** Submits an operation, whose handler is called with the result from the completion thread (and deleted afterwards, null pointer stops the completion thread) */
+    void submit(uint8_t opcode, int fd, void * address, unsigned length, uint64_t offset, std::function<void(int)> * handler);
+
+    /** Calls the handlers of completed operations, until stopped */
+    void complete(void);
+
+    ~IoRing(void);
+};
+
+std::unique_ptr<IoRing> IoRing::create(unsigned entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if(fd < 0)
+        return nullptr;
+    /* Needing the kernel to keep completions which don't fit into the completion queue, and to support non-vectored reads and writes (fast poll came after them) */
+    if(!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_FAST_POLL)) {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if(params.features & IORING_FEAT_SINGLE_MMAP) {
+        if(cqRingSize > sqRingSize)
+            sqRingSize = cqRingSize;
+        cqRingSize = sqRingSize;
+    }
+    size_t sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    void * sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    void * cqRing = sqRing;
+    if(sqRing != MAP_FAILED && !(params.features & IORING_FEAT_SINGLE_MMAP))
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    void * sqes = MAP_FAILED;
+    if(sqRing != MAP_FAILED && cqRing != MAP_FAILED)
+        sqes = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) {
+        if(cqRing != MAP_FAILED && cqRing != sqRing)
+            munmap(cqRing, cqRingSize);
+        if(sqRing != MAP_FAILED)
+            munmap(sqRing, sqRingSize);
+        close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<IoRing> ring = std::make_unique<IoRing>();
+    ring->fd = fd;
+    ring->sqRing = sqRing;
+    ring->sqRingSize = sqRingSize;
+    ring->cqRing = cqRing;
+    ring->cqRingSize = cqRingSize;
+    ring->sqes = (io_uring_sqe *)sqes;
+    ring->sqesSize = sqesSize;
+
+    char * sq = (char *)ring->sqRing;
+    char * cq = (char *)ring->cqRing;
+    ring->sqTail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sqMask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)(sq + params.sq_off.array);
+    ring->cqHead = (unsigned *)(cq + params.cq_off.head);
+    ring->cqTail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cqMask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (io_uring_cqe *)(cq + params.cq_off.cqes);
+
+    ring->completions = std::thread(&IoRing::complete, ring.get());
+    return ring;
+}
+
+void IoRing::submit(uint8_t opcode, int fd, void * address, unsigned length, uint64_t offset, std::function<void(int)> * handler) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    /* Each entry is submitted right away, so the submission queue always has space for the next one */
+    unsigned tail = *this->sqTail;
+    unsigned index = tail & *this->sqMask;
+    io_uring_sqe * sqe = &this->sqes[index];
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->opcode = opcode;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)address;
+    sqe->len = length;
+    sqe->off = offset;
+    sqe->user_data = (uint64_t)(uintptr_t)handler;
+    this->sqArray[index] = index;
+    __atomic_store_n(this->sqTail, tail + 1, __ATOMIC_RELEASE);
+    /* Retrying while the kernel is busy (e.g. waiting for the completion thread to make space for completions) */
+    while(syscall(__NR_io_uring_enter, this->fd, 1, 0, 0, nullptr, 0) < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+        std::this_thread::yield();
+    }
+}
+
+void IoRing::complete(void) {
+    while(true) {
+        unsigned head = *this->cqHead;
+        if(head == __atomic_load_n(this->cqTail, __ATOMIC_ACQUIRE)) {
+            syscall(__NR_io_uring_enter, this->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            continue;
+        }
+        io_uring_cqe cqe = this->cqes[head & *this->cqMask];
+        __atomic_store_n(this->cqHead, head + 1, __ATOMIC_RELEASE);
+        std::function<void(int)> * handler = (std::function<void(int)> *)(uintptr_t)cqe.user_data;
+        /* The kernel orders the submission before the completion, but taking the submission lock makes the order visible to thread sanitizers as well */
+        { std::lock_guard<std::mutex> guard(this->lock); }
+        if(handler == nullptr)
+            return;
+        (*handler)(cqe.res);
+        delete handler;
+    }
+}
+
+IoRing::~IoRing(void) {
+    /* Stopping the completion thread using an operation which does nothing */
+    this->submit(IORING_OP_NOP, -1, nullptr, 0, 0, nullptr);
+    this->completions.join();
+    munmap(this->sqes, this->sqesSize);
+    if(this->cqRing != this->sqRing)
+        munmap(this->cqRing, this->cqRingSize);
+    munmap(this->sqRing, this->sqRingSize);
+    close(this->fd);
+}
+
+#define RING_AVAILABLE 1
+
+#else
+
+/** Placeholder for systems without io_uring, never created */
+struct IoRing {};
+
+#define RING_AVAILABLE 0
+
+#endif
+
+
+/* Protected member functions */
+
+void XmlAsyncIO::beginOperation(void) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    ++this->unfinished;
+}
+
+void XmlAsyncIO::endOperation(void) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    if(--this->unfinished == 0)
+        this->finished.notify_all();
+}
+
+void XmlAsyncIO::transfer(bool write, int fd, char * data, size_t size, std::function<void(int)> done) {
+    std::shared_ptr<AsyncTransfer> transfer = std::make_shared<AsyncTransfer>();
+    transfer->write = write;
+    transfer->fd = fd;
+    transfer->data = data;
+    transfer->remaining = (size + ASYNC_CHUNK_SIZE - 1) / ASYNC_CHUNK_SIZE;
+    transfer->error = 0;
+    transfer->done = std::move(done);
+
+    if(!this->ring || size == 0) {
+        /* Transferring the chunks on a worker thread */
+        this->pool.submit([transfer, size]() {
+            for(size_t offset = 0; offset < size && transfer->error == 0; ) {
+                size_t length = std::min<size_t>(ASYNC_CHUNK_SIZE - offset % ASYNC_CHUNK_SIZE, size - offset);
+                ssize_t result = (transfer->write ? pwrite(transfer->fd, transfer->data + offset, length, offset) : pread(transfer->fd, transfer->data + offset, length, offset));
+                if(result < 0 && errno != EINTR)
+                    transfer->error = errno;
+                else if(result == 0)
+                    transfer->error = EIO;
+                else if(result > 0)
+                    offset += (size_t)result;
+            }
+            transfer->done(transfer->error);
+        });
+        return;
+    }
+    for(size_t offset = 0; offset < size; offset += ASYNC_CHUNK_SIZE) {
+        this->submitChunk(transfer, offset, std::min<size_t>(ASYNC_CHUNK_SIZE, size - offset));
+    }
+}
+
+void XmlAsyncIO::submitChunk(std::shared_ptr<AsyncTransfer> transfer, size_t offset, size_t length) {
+#if RING_AVAILABLE
+    /* The handler runs on the completion thread, so anything which may block (submitting again, calling done) is passed to the worker threads */
+    std::function<void(int)> * handler = new std::function<void(int)>([this, transfer, offset, length](int result) {
+        if(result == -EINTR || result == -EAGAIN) {
+            this->pool.submit([this, transfer, offset, length]() { this->submitChunk(transfer, offset, length); });
+            return;
+        }
+        if(result > 0 && (size_t)result < length) {
+            size_t done = (size_t)result;
+            this->pool.submit([this, transfer, offset, length, done]() { this->submitChunk(transfer, offset + done, length - done); });
+            return;
+        }
+        if(result < 0) {
+            int expected = 0;
+            transfer->error.compare_exchange_strong(expected, -result);
+        } else if(result == 0) {
+            /* The file got shorter while reading */
+            int expected = 0;
+            transfer->error.compare_exchange_strong(expected, EIO);
+        }
+        if(--transfer->remaining == 0)
+            this->pool.submit([transfer]() { transfer->done(transfer->error); });
+    });
+    this->ring->submit((transfer->write ? IORING_OP_WRITE : IORING_OP_READ), transfer->fd, transfer->data + offset, (unsigned)length, offset, handler);
+#else
+    (void)transfer;
+    (void)offset;
+    (void)length;
+#endif
+}
+
+
+/* Constructor and destructor */
+
+XmlAsyncIO::XmlAsyncIO(size_t threadAmount, bool useRing) : pool(threadAmount), unfinished(0) {
+#if RING_AVAILABLE
+    if(useRing)
+        this->ring = IoRing::create(ASYNC_RING_ENTRIES);
+#else
+    (void)useRing;
+#endif
+}
+
+XmlAsyncIO::~XmlAsyncIO(void) {
+    /* Waiting before destroying the ring and the pool, since unfinished operations use both */
+    std::unique_lock<std::mutex> guard(this->lock);
+    this->finished.wait(guard, [this]() { return this->unfinished == 0; });
+}
+
+bool XmlAsyncIO::isRingUsed(void) const {
+    return this->ring != nullptr;
+}
+
+
+/* Loading */
+
+void XmlAsyncIO::load(char const * filePath, LoadCallback callback) {
+    this->beginOperation();
+    int fd = open(filePath, O_RDONLY | O_CLOEXEC);
+    if(fd < 0) {
+        std::exception_ptr error = std::make_exception_ptr(std::invalid_argument("Error: Cannot open the file to load"));
+        this->pool.submit([this, error, callback]() {
+            callback(nullptr, error);
+            this->endOperation();
+        });
+        return;
+    }
+    struct stat info;
+    if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        close(fd);
+        /* Not a regular file (so the size isn't known upfront), reading the whole file on a worker thread instead */
+        std::string path = filePath;
+        this->pool.submit([this, path, callback]() {
+            try {
+                std::unique_ptr<XmlDocument> document = std::make_unique<XmlDocument>();
+                document->loadFromString(file_readString(path.c_str()));
+                callback(std::move(document), nullptr);
+            } catch(...) {
+                callback(nullptr, std::current_exception());
+            }
+            this->endOperation();
+        });
+        return;
+    }
+
+    std::shared_ptr<std::string> data = std::make_shared<std::string>((size_t)info.st_size, '\0');
+    this->transfer(false, fd, &(*data)[0], data->length(), [this, fd, data, callback](int error) {
+        close(fd);
+        try {
+            if(error != 0)
+                throw std::invalid_argument(std::string("Error: Cannot read the file to load: ") + std::strerror(error));
+            std::unique_ptr<XmlDocument> document = std::make_unique<XmlDocument>();
+            /* Decompressing a gzip-compressed file after reading it, since the chunks are read all at once */
+            if(file_isCompressed(*data))
+                document->loadFromString(file_decompressString(*data));
+            else
+                document->loadFromString(*data);
+            callback(std::move(document), nullptr);
+        } catch(...) {
+            callback(nullptr, std::current_exception());
+        }
+        this->endOperation();
+    });
+}
+
+std::future<std::unique_ptr<XmlDocument>> XmlAsyncIO::load(char const * filePath) {
+    std::shared_ptr<std::promise<std::unique_ptr<XmlDocument>>> promise = std::make_shared<std::promise<std::unique_ptr<XmlDocument>>>();
+    std::future<std::unique_ptr<XmlDocument>> result = promise->get_future();
+    this->load(filePath, [promise](std::unique_ptr<XmlDocument> document, std::exception_ptr error) {
+        if(error)
+            promise->set_exception(error);
+        else
+            promise->set_value(std::move(document));
+    });
+    return result;
+}
+
+
+/* Saving */
+
+void XmlAsyncIO::save(XmlDocument const & document, char const * filePath, SaveCallback callback) {
+    this->beginOperation();
+    std::string path = filePath;
+    /* The copy shares the Nodes with the document, so it's cheap to take and isn't affected by later modifications */
+    std::shared_ptr<XmlDocument const> copy = std::make_shared<XmlDocument const>(document);
+    this->pool.submit([this, path, copy, callback]() {
+        try {
+            std::shared_ptr<std::string> data = std::make_shared<std::string>(copy->printEncoded());
+            int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+            if(fd < 0)
+                throw std::invalid_argument("Error: Cannot open the file to save");
+            this->transfer(true, fd, &(*data)[0], data->length(), [this, fd, data, callback](int error) {
+                if(close(fd) != 0 && error == 0)
+                    error = errno;
+                if(error != 0)
+                    callback(std::make_exception_ptr(std::invalid_argument(std::string("Error: Cannot write the file to save: ") + std::strerror(error))));
+                else
+                    callback(nullptr);
+                this->endOperation();
+            });
+        } catch(...) {
+            callback(std::current_exception());
+            this->endOperation();
+        }
+    });
+}
+
+std::future<void> XmlAsyncIO::save(XmlDocument const & document, char const * filePath) {
+    std::shared_ptr<std::promise<void>> promise = std::make_shared<std::promise<void>>();
+    std::future<void> result = promise->get_future();
+    this->save(document, filePath, [promise](std::exception_ptr error) {
+        if(error)
+            promise->set_exception(error);
+        else
+            promise->set_value();
+    });
+    return result;
+}
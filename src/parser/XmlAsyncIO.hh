@@ -0,0 +1,120 @@
+/**
+ * @file XmlAsyncIO.hh
+ * @author Linux-Tech-Tips
+ * @brief Asynchronous XML Document loading and saving header
+ *
+ * The header declaring the asynchronous loader and saver of XML Documents, which never blocks the calling thread on reading, parsing, printing or writing
+ */
+#ifndef XML_ASYNC_IO_H
+#define XML_ASYNC_IO_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <exception>
+
+#include "XmlDocument.hh"
+#include "ThreadPool.hh"
+
+/** The size of the chunks files are read and written in, each chunk starting at a multiple of the size */
+#define ASYNC_CHUNK_SIZE (1u << 20)
+
+/** The submission queue size of the io_uring instance used by @ref XmlAsyncIO */
+#define ASYNC_RING_ENTRIES 64u
+
+struct IoRing;
+struct AsyncTransfer;
+
+/**
+ * @class XmlAsyncIO
+ * @author Linux-Tech-Tips
+ * @brief Asynchronous XML Document loading and saving
+ *
+ * Loads and saves XML Documents without blocking the calling thread (e.g. the thread of an event loop), returning a future,
+ * or calling the given callback once finished. Callbacks are called on one of the worker threads of the instance, and must not block for long.
+ *
+ * Files are read and written in chunks of ASYNC_CHUNK_SIZE bytes, all chunks of a file submitted at once. On Linux, the chunks are transferred
+ * by an io_uring instance, and otherwise (or if io_uring isn't available) by the worker threads. Parsing and printing always run on the worker threads.
+ * Only opening the file to load runs on the calling thread.
+ *
+ * Saving works with a copy of the document taken when called (which shares the Nodes with the document, see @ref XmlDocument::XmlDocument(XmlDocument const &, std::pmr::memory_resource *)),
+ * so the document can be modified or destroyed right after the call.
+ * Destroying the instance waits until all started operations are finished.
+*/
+class XmlAsyncIO {
+
+    public:
+        /** The callback called once a document is loaded, with the loaded document, or with the exception thrown while loading (and null pointer as the document) */
+        typedef std::function<void(std::unique_ptr<XmlDocument> document, std::exception_ptr error)> LoadCallback;
+
+        /** The callback called once a document is saved, with the exception thrown while saving (or null pointer if saved successfully) */
+        typedef std::function<void(std::exception_ptr error)> SaveCallback;
+
+    protected:
+        /** The worker threads parsing, printing and calling callbacks (and transferring chunks if the io_uring instance isn't used) */
+        ThreadPool pool;
+        /** The io_uring instance transferring the chunks (null pointer if not used) */
+        std::unique_ptr<IoRing> ring;
+
+        /** Lock held while changing the amount of unfinished operations */
+        std::mutex lock;
+        /** Notified when all operations are finished */
+        std::condition_variable finished;
+        /** The amount of started, but not yet finished operations */
+        size_t unfinished;
+
+        /** Internal function counting a started operation */
+        void beginOperation(void);
+
+        /** Internal function counting a finished operation */
+        void endOperation(void);
+
+        /** Internal function which reads (or writes) the given data from (or to) the file in chunks, and calls done on a worker thread with the error number (0 if transferred successfully) */
+        void transfer(bool write, int fd, char * data, size_t size, std::function<void(int)> done);
+
+        /** Internal function which submits a chunk of the transfer (or the rest of a partially transferred chunk) to the io_uring instance */
+        void submitChunk(std::shared_ptr<AsyncTransfer> transfer, size_t offset, size_t length);
+
+    public:
+        /** Constructor - creates the given amount of worker threads (the amount of hardware threads if 0)
+         *  @param useRing whether io_uring should be used to transfer the chunks, if available (the worker threads are used otherwise)
+        */
+        explicit XmlAsyncIO(size_t threadAmount = 0, bool useRing = true);
+
+        /** Copying is not supported, since the operations belong to a single instance */
+        XmlAsyncIO(XmlAsyncIO const & original) = delete;
+        /** Copying is not supported, since the operations belong to a single instance */
+        XmlAsyncIO & operator=(XmlAsyncIO const & original) = delete;
+
+        /** Destructor - waits until all started operations are finished */
+        ~XmlAsyncIO(void);
+
+        /** Returns whether the chunks are transferred using io_uring */
+        bool isRingUsed(void) const;
+
+
+        /* Loading */
+
+        /** Starts loading the XML file on the given path, calling the callback once loaded (or once loading fails) */
+        void load(char const * filePath, LoadCallback callback);
+
+        /** Starts loading the XML file on the given path, returning the future loaded document (the future throws the exception thrown while loading) */
+        std::future<std::unique_ptr<XmlDocument>> load(char const * filePath);
+
+
+        /* Saving */
+
+        /** Starts saving the given document into the given path (as @ref XmlDocument::printEncoded), calling the callback once saved (or once saving fails) */
+        void save(XmlDocument const & document, char const * filePath, SaveCallback callback);
+
+        /** Starts saving the given document into the given path (as @ref XmlDocument::printEncoded), returning a future which is ready once saved
+         * (the future throws the exception thrown while saving)
+        */
+        std::future<void> save(XmlDocument const & document, char const * filePath);
+
+};
+
+#endif /* XML_ASYNC_IO_H */
@@ -0,0 +1,88 @@
+#include "XmlBatchLoader.hh"
+
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+/* Batch result */
+
+bool XmlBatchResult::isLoaded(void) const {
+    return this->document != nullptr;
+}
+
+
+/* Constructor */
+
+XmlBatchLoader::XmlBatchLoader(size_t threadAmount) : pool(threadAmount) {}
+
+
+/* Loading */
+
+std::vector<XmlBatchResult> XmlBatchLoader::load(std::vector<std::string> const & filePaths) {
+    std::vector<XmlBatchResult> results(filePaths.size());
+
+    /* Ordering the files from the largest, so that the largest files don't start last and finish long after the rest */
+    std::vector<std::pair<off_t, size_t>> order;
+    order.reserve(filePaths.size());
+    for(size_t i = 0; i < filePaths.size(); i++) {
+        results[i].path = filePaths[i];
+        struct stat info;
+        if(stat(filePaths[i].c_str(), &info) != 0) {
+            results[i].error = "Error: Cannot access the file to load";
+            continue;
+        }
+        order.push_back({info.st_size, i});
+    }
+    std::stable_sort(order.begin(), order.end(), [](std::pair<off_t, size_t> const & a, std::pair<off_t, size_t> const & b) { return a.first > b.first; });
+
+    /* Counting the unfinished files of this batch, since other batches may use the pool at the same time */
+    std::mutex lock;
+    std::condition_variable finished;
+    size_t remaining = order.size();
+    for(std::pair<off_t, size_t> const & file : order) {
+        XmlBatchResult * result = &results[file.second];
+        this->pool.submit([result, &lock, &finished, &remaining]() {
+            try {
+                std::unique_ptr<XmlDocument> document = std::make_unique<XmlDocument>();
+                document->load(result->path.c_str());
+                result->document = std::move(document);
+            } catch(std::exception const & e) {
+                result->error = e.what();
+            } catch(...) {
+                result->error = "Error: Unknown error while loading the file";
+            }
+            std::lock_guard<std::mutex> guard(lock);
+            if(--remaining == 0)
+                finished.notify_all();
+        });
+    }
+
+    std::unique_lock<std::mutex> guard(lock);
+    finished.wait(guard, [&remaining]() { return remaining == 0; });
+    return results;
+}
+
+std::vector<XmlBatchResult> XmlBatchLoader::loadDirectory(char const * directoryPath, char const * extension) {
+    std::vector<std::string> filePaths;
+    std::error_code error;
+    std::filesystem::directory_iterator it(directoryPath, error);
+    if(error)
+        throw std::invalid_argument("Error: Cannot read the directory to load");
+    for(; it != std::filesystem::directory_iterator(); it.increment(error)) {
+        if(error)
+            throw std::invalid_argument("Error: Cannot read the directory to load");
+        std::filesystem::path const & path = it->path();
+        if(it->is_regular_file(error) && (extension[0] == '\0' || path.extension() == extension))
+            filePaths.push_back(path.string());
+    }
+    std::sort(filePaths.begin(), filePaths.end());
+    return this->load(filePaths);
+}
+
+size_t XmlBatchLoader::getThreadAmount(void) const {
+    return this->pool.getThreadAmount();
+}
@@ -0,0 +1,72 @@
+/**
+ * @file XmlBatchLoader.hh
+ * @author Linux-Tech-Tips
+ * @brief Parallel loader of many XML files header
+ *
+ * The header declaring the batch loader, which loads a list of XML files (or all XML files in a directory) in parallel
+ */
+#ifndef XML_BATCH_LOADER_H
+#define XML_BATCH_LOADER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "XmlDocument.hh"
+#include "ThreadPool.hh"
+
+/**
+ * @struct XmlBatchResult
+ * @author Linux-Tech-Tips
+ * @brief The result of loading a single file of a batch
+*/
+struct XmlBatchResult {
+    /** The path of the loaded file */
+    std::string path;
+    /** The loaded document (null pointer if loading failed) */
+    std::unique_ptr<XmlDocument> document;
+    /** The error message if loading failed (empty if loaded successfully) */
+    std::string error;
+
+    /** Returns whether the file was loaded successfully */
+    bool isLoaded(void) const;
+};
+
+/**
+ * @class XmlBatchLoader
+ * @author Linux-Tech-Tips
+ * @brief Parallel loader of many XML files
+ *
+ * Loads batches of XML files on a work-stealing @ref ThreadPool, each file read and parsed by one worker,
+ * so that reading some files overlaps with parsing others. The largest files are started first, and idle workers steal the remaining files,
+ * so that a few large files among many small ones don't leave the other workers waiting at the end of the batch.
+ *
+ * The results are returned in the order of the input paths, each containing either the loaded document or the error which occured while loading it -
+ * an error in one file doesn't stop the other files from loading. The same loader (and its worker threads) can be used for any amount of batches,
+ * and may be used by multiple threads at the same time.
+*/
+class XmlBatchLoader {
+
+    protected:
+        /** The worker threads loading the files */
+        ThreadPool pool;
+
+    public:
+        /** Constructor - creates a loader with the given amount of worker threads (the amount of hardware threads if 0) */
+        explicit XmlBatchLoader(size_t threadAmount = 0);
+
+        /** Loads all files on the given paths, returning the results in the same order as the paths */
+        std::vector<XmlBatchResult> load(std::vector<std::string> const & filePaths);
+
+        /** Loads all files in the given directory (not including subdirectories) with the given extension, returning the results sorted by path.
+         * Throws std::invalid_argument if the directory can't be read.
+         *  @param extension the extension of the loaded files, including the dot (pass an empty string to load all files)
+        */
+        std::vector<XmlBatchResult> loadDirectory(char const * directoryPath, char const * extension = ".xml");
+
+        /** Returns the amount of worker threads */
+        size_t getThreadAmount(void) const;
+
+};
+
+#endif /* XML_BATCH_LOADER_H */
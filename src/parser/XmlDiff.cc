@@ -0,0 +1,279 @@
+#include "XmlDiff.hh"
+
+#include <unordered_map>
+#include <deque>
+#include <algorithm>
+
+/* Internal auxiliary functions */
+
+/** Returns the nested Nodes of the given Node (none if it can't contain nested Nodes) */
+static std::vector<Node const *> getChildren(Node const * node) {
+    std::vector<Node const *> result;
+    if(node->getNodeType() == NodeTypeName::XmlElement) {
+        XmlElement const * element = (XmlElement const *)node;
+        result.reserve(element->getChildAmount());
+        for(size_t i = 0; i < element->getChildAmount(); i++) {
+            result.push_back(element->getChild((int)i));
+        }
+    } else if(node->getNodeType() == NodeTypeName::DoctypeDTD) {
+        DoctypeDTD const * doctype = (DoctypeDTD const *)node;
+        result.reserve(doctype->getChildAmount());
+        for(size_t i = 0; i < doctype->getChildAmount(); i++) {
+            result.push_back(doctype->getChild((int)i));
+        }
+    }
+    return result;
+}
+
+/** Returns the path step naming the given Node - "text()" for text without a tag, "comment()" for comments and the name of the Node otherwise */
+static std::string getStep(Node const * node) {
+    if(node->getNodeType() == NodeTypeName::TextElement && !((TextElement const *)node)->getShowTag())
+        return "text()";
+    if(node->getNodeType() == NodeTypeName::Comment)
+        return "comment()";
+    return node->getName();
+}
+
+/** Returns the path of each of the given siblings, as the path of their parent followed by the step and position among the siblings with the same step */
+static std::vector<std::string> getPaths(std::string const & parentPath, std::vector<Node const *> const & siblings) {
+    std::vector<std::string> result;
+    result.reserve(siblings.size());
+    std::unordered_map<std::string, size_t> amounts;
+    for(Node const * it : siblings) {
+        std::string name = getStep(it);
+        size_t position = ++amounts[name];
+        result.push_back(parentPath + "/" + name + "[" + std::to_string(position) + "]");
+    }
+    return result;
+}
+
+/** Returns the text content of the given Node, saving whether it has any into hasText */
+static std::string getText(Node const * node, bool * hasText) {
+    *hasText = true;
+    if(node->getNodeType() == NodeTypeName::TextElement)
+        return ((TextElement const *)node)->getContent();
+    if(node->getNodeType() == NodeTypeName::Comment)
+        return ((Comment const *)node)->getContent();
+    *hasText = false;
+    return "";
+}
+
+/** Returns the given value quoted, for printing */
+static std::string quote(std::string const & value) {
+    return "\"" + value + "\"";
+}
+
+
+/* Edit */
+
+std::string XmlDiffEdit::toString(void) const {
+    switch(this->operation) {
+        case XmlDiffOperation::Insert:
+            return "insert " + this->newPath;
+        case XmlDiffOperation::Delete:
+            return "delete " + this->path;
+        case XmlDiffOperation::Move:
+            return "move " + this->path + " -> " + this->newPath;
+        case XmlDiffOperation::AttributeChange:
+            return "attribute " + this->path + " " + this->attribute + ": " + quote(this->oldValue) + " -> " + quote(this->newValue);
+        default:
+            return "text " + this->path + ": " + quote(this->oldValue) + " -> " + quote(this->newValue);
+    }
+}
+
+
+/* Protected member functions */
+
+std::string XmlDiff::getKey(Node const * node) const {
+    std::string result = std::to_string((int)node->getNodeType());
+    result += '\0';
+    result += node->getName();
+    for(std::string const & it : this->keyAttributes) {
+        if(node->hasAttribute(it)) {
+            result += '\0';
+            result += it;
+            result += '=';
+            result += node->getAttribute(it);
+            break;
+        }
+    }
+    return result;
+}
+
+void XmlDiff::compareChildren(std::string const & path, std::string const & newPath, std::vector<Node const *> const & original, std::vector<Node const *> const & modified,
+                              std::vector<XmlDiffEdit> & result, std::vector<NodePair> & pending) const {
+    /* The index of the original child matched to each modified child (-1 if unmatched) */
+    std::vector<long> matches(modified.size(), -1);
+    std::vector<bool> matched(original.size(), false);
+    size_t unmatched = modified.size();
+
+    /* Unchanged children in the same position, which is the case for most children */
+    for(size_t i = 0; i < original.size() && i < modified.size(); i++) {
+        if(original[i]->getHash() == modified[i]->getHash()) {
+            matches[i] = (long)i;
+            matched[i] = true;
+            unmatched--;
+        }
+    }
+
+    /* Unchanged children anywhere among the siblings */
+    if(unmatched > 0) {
+        std::unordered_map<uint64_t, std::deque<size_t>> byHash;
+        for(size_t i = 0; i < original.size(); i++) {
+            if(!matched[i])
+                byHash[original[i]->getHash()].push_back(i);
+        }
+        for(size_t i = 0; i < modified.size() && !byHash.empty(); i++) {
+            if(matches[i] >= 0)
+                continue;
+            auto it = byHash.find(modified[i]->getHash());
+            if(it == byHash.end())
+                continue;
+            matches[i] = (long)it->second.front();
+            matched[it->second.front()] = true;
+            unmatched--;
+            it->second.pop_front();
+            if(it->second.empty())
+                byHash.erase(it);
+        }
+    }
+
+    /* Changed children with the same key, in order */
+    if(unmatched > 0) {
+        std::unordered_map<std::string, std::deque<size_t>> byKey;
+        for(size_t i = 0; i < original.size(); i++) {
+            if(!matched[i])
+                byKey[this->getKey(original[i])].push_back(i);
+        }
+        for(size_t i = 0; i < modified.size() && !byKey.empty(); i++) {
+            if(matches[i] >= 0)
+                continue;
+            auto it = byKey.find(this->getKey(modified[i]));
+            if(it == byKey.end())
+                continue;
+            matches[i] = (long)it->second.front();
+            matched[it->second.front()] = true;
+            it->second.pop_front();
+            if(it->second.empty())
+                byKey.erase(it);
+        }
+    }
+
+    /* The longest run of matched children which kept their order (the longest increasing sequence of original indices, in the modified order) stays in place */
+    std::vector<size_t> tails;
+    std::vector<long> previous(modified.size(), -1);
+    for(size_t i = 0; i < modified.size(); i++) {
+        if(matches[i] < 0)
+            continue;
+        auto it = std::lower_bound(tails.begin(), tails.end(), matches[i], [&](size_t tail, long value) { return matches[tail] < value; });
+        if(it != tails.begin())
+            previous[i] = (long)*(it - 1);
+        if(it == tails.end())
+            tails.push_back(i);
+        else
+            *it = i;
+    }
+    std::vector<bool> inPlace(modified.size(), false);
+    for(long i = (tails.empty() ? -1 : (long)tails.back()); i >= 0; i = previous[i]) {
+        inPlace[i] = true;
+    }
+
+    /* The paths are only computed for the children of Nodes with changed content */
+    std::vector<std::string> paths = getPaths(path, original);
+    std::vector<std::string> newPaths = getPaths(newPath, modified);
+
+    for(size_t i = 0; i < original.size(); i++) {
+        if(!matched[i])
+            result.push_back({ XmlDiffOperation::Delete, paths[i], "", original[i], nullptr, "", "", "" });
+    }
+    for(size_t i = 0; i < modified.size(); i++) {
+        if(matches[i] >= 0 && !inPlace[i])
+            result.push_back({ XmlDiffOperation::Move, paths[matches[i]], newPaths[i], original[matches[i]], modified[i], "", "", "" });
+    }
+    for(size_t i = 0; i < modified.size(); i++) {
+        if(matches[i] < 0)
+            result.push_back({ XmlDiffOperation::Insert, "", newPaths[i], nullptr, modified[i], "", "", "" });
+    }
+
+    /* Matched children with different content are compared in turn */
+    for(size_t i = 0; i < modified.size(); i++) {
+        if(matches[i] >= 0 && original[matches[i]]->getHash() != modified[i]->getHash())
+            pending.push_back({ original[matches[i]], modified[i], paths[matches[i]], newPaths[i] });
+    }
+}
+
+void XmlDiff::compareContent(NodePair const & pair, std::vector<XmlDiffEdit> & result) {
+    /* Both attribute maps are sorted by name, so they are compared in a single pass */
+    NodeAttributes const & original = pair.original->getAttributes();
+    NodeAttributes const & modified = pair.modified->getAttributes();
+    auto it = original.begin();
+    auto modifiedIt = modified.begin();
+    while(it != original.end() || modifiedIt != modified.end()) {
+        if(modifiedIt == modified.end() || (it != original.end() && it->first < modifiedIt->first)) {
+            result.push_back({ XmlDiffOperation::AttributeChange, pair.path, pair.newPath, pair.original, pair.modified, std::string(it->first), std::string(it->second), "" });
+            ++it;
+        } else if(it == original.end() || modifiedIt->first < it->first) {
+            result.push_back({ XmlDiffOperation::AttributeChange, pair.path, pair.newPath, pair.original, pair.modified, std::string(modifiedIt->first), "", std::string(modifiedIt->second) });
+            ++modifiedIt;
+        } else {
+            if(it->second != modifiedIt->second)
+                result.push_back({ XmlDiffOperation::AttributeChange, pair.path, pair.newPath, pair.original, pair.modified, std::string(it->first), std::string(it->second), std::string(modifiedIt->second) });
+            ++it;
+            ++modifiedIt;
+        }
+    }
+
+    bool hasText;
+    std::string text = getText(pair.original, &hasText);
+    if(hasText) {
+        std::string newText = getText(pair.modified, &hasText);
+        if(text != newText)
+            result.push_back({ XmlDiffOperation::TextChange, pair.path, pair.newPath, pair.original, pair.modified, "", text, newText });
+    }
+}
+
+
+/* Constructor */
+
+XmlDiff::XmlDiff(std::vector<std::string> const & keyAttributes) : keyAttributes(keyAttributes) {}
+
+
+/* Public member functions */
+
+std::vector<XmlDiffEdit> XmlDiff::compare(XmlDocument const & original, XmlDocument const & modified) const {
+    std::vector<XmlDiffEdit> result;
+    if(original.getHash() == modified.getHash())
+        return result;
+
+    std::vector<Node const *> originalNodes;
+    for(size_t i = 0; i < original.getChildAmount(); i++) {
+        originalNodes.push_back(original.getNode((int)i));
+    }
+    std::vector<Node const *> modifiedNodes;
+    for(size_t i = 0; i < modified.getChildAmount(); i++) {
+        modifiedNodes.push_back(modified.getNode((int)i));
+    }
+
+    /* The changed pairs are compared depth-first using an explicit stack (pushed in reverse, so that they are compared in document order) */
+    std::vector<NodePair> found;
+    this->compareChildren("", "", originalNodes, modifiedNodes, result, found);
+    std::vector<NodePair> pairs(found.rbegin(), found.rend());
+    while(!pairs.empty()) {
+        NodePair pair = std::move(pairs.back());
+        pairs.pop_back();
+        XmlDiff::compareContent(pair, result);
+        found.clear();
+        this->compareChildren(pair.path, pair.newPath, getChildren(pair.original), getChildren(pair.modified), result, found);
+        pairs.insert(pairs.end(), found.rbegin(), found.rend());
+    }
+    return result;
+}
+
+std::string XmlDiff::print(std::vector<XmlDiffEdit> const & edits) {
+    std::string result;
+    for(XmlDiffEdit const & it : edits) {
+        result += it.toString();
+        result += "\n";
+    }
+    return result;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file XmlDiff.hh
+ * @author Linux-Tech-Tips
+ * @brief Structural difference between XML Documents header
+ *
+ * The header declaring the structural diff engine, which compares two XML Documents Node by Node and returns the edits turning one into the other
+ */
+#ifndef XML_DIFF_H
+#define XML_DIFF_H
+
+#include <string>
+#include <vector>
+
+#include "XmlDocument.hh"
+
+/** The kinds of edits found by @ref XmlDiff */
+enum class XmlDiffOperation {
+    /** A Node of the modified document which isn't in the original document */
+    Insert,
+    /** A Node of the original document which isn't in the modified document */
+    Delete,
+    /** A Node moved to a different position among its siblings */
+    Move,
+    /** An attribute added, removed or changed */
+    AttributeChange,
+    /** The text content of a text element or comment changed */
+    TextChange
+};
+
+/**
+ * @struct XmlDiffEdit
+ * @author Linux-Tech-Tips
+ * @brief A single edit found by @ref XmlDiff
+ *
+ * Nodes are addressed by paths of the form "/root[1]/item[3]" - the name of each Node on the way from the document,
+ * followed by its position among the siblings with the same name (starting at 1). Text without a tag and comments
+ * are named "text()" and "comment()", as in "/root[1]/text()[2]"
+*/
+struct XmlDiffEdit {
+    /** The kind of the edit */
+    XmlDiffOperation operation;
+    /** The path of the Node in the original document (empty for Insert) */
+    std::string path;
+    /** The path of the Node in the modified document (empty for Delete) */
+    std::string newPath;
+    /** The Node in the original document (null pointer for Insert) */
+    Node const * original;
+    /** The Node in the modified document (null pointer for Delete) */
+    Node const * modified;
+    /** The name of the changed attribute (AttributeChange only) */
+    std::string attribute;
+    /** The original value of the attribute or text (empty if the attribute was added) */
+    std::string oldValue;
+    /** The modified value of the attribute or text (empty if the attribute was removed) */
+    std::string newValue;
+
+    /** Returns a single line describing the edit, e.g. 'attribute /root[1]/item[2] id: "1" -> "2"' */
+    std::string toString(void) const;
+};
+
+/**
+ * @class XmlDiff
+ * @author Linux-Tech-Tips
+ * @brief Structural diff engine between two XML Documents
+ *
+ * Compares two documents by their structure rather than their printed text, so formatting differences (indentation, line breaks) are ignored.
+ * Subtrees are first compared by their hashes (see @ref Node::getHash), so unchanged subtrees are skipped without visiting their Nodes,
+ * and the time to compare two versions of a document depends on the size of the changes, rather than on the size of the documents.
+ *
+ * The children of two matching Nodes are matched in three passes: unchanged children in the same position, unchanged children anywhere among the siblings,
+ * and then changed children with the same type, name and key attribute (the first of the key attributes the child has, e.g. "id").
+ * Unmatched children are deleted or inserted, and matched children out of their original order are moved (keeping the longest run of children in order in place).
+ * Matched children with different hashes are compared in turn. A Node moved to a different parent is reported as deleted and inserted.
+ * The documents must not be modified while the edits are used, since the edits point to their Nodes.
+*/
+class XmlDiff {
+
+    protected:
+        /** Two matching Nodes with different content, which are compared in turn */
+        struct NodePair {
+            Node const * original;
+            Node const * modified;
+            std::string path;
+            std::string newPath;
+        };
+
+        /** The names of the attributes identifying elements among their siblings, in the order of priority */
+        std::vector<std::string> keyAttributes;
+
+        /** Internal function which returns the key of the given Node, matched among the siblings of the Node */
+        std::string getKey(Node const * node) const;
+
+        /** Internal function which matches the given children of two matching Nodes (or the root-level Nodes of the documents),
+         * adding the edits to the result and the matched children with different content to the pairs to compare
+        */
+        void compareChildren(std::string const & path, std::string const & newPath, std::vector<Node const *> const & original, std::vector<Node const *> const & modified,
+                             std::vector<XmlDiffEdit> & result, std::vector<NodePair> & pending) const;
+
+        /** Internal function which compares the attributes and text of two matching Nodes, adding the edits to the result */
+        static void compareContent(NodePair const & pair, std::vector<XmlDiffEdit> & result);
+
+    public:
+        /** Constructor
+         *  @param keyAttributes the names of the attributes identifying elements among their siblings, in the order of priority
+        */
+        explicit XmlDiff(std::vector<std::string> const & keyAttributes = { "id", "key", "name" });
+
+        /** Returns the edits turning the original document into the modified one (empty if the documents have the same content), in document order -
+         * the changes of each Node and the insertions, deletions and moves of its children come before the changes of its children
+        */
+        std::vector<XmlDiffEdit> compare(XmlDocument const & original, XmlDocument const & modified) const;
+
+        /** Returns the given edits as text, one edit per line (see @ref XmlDiffEdit::toString) */
+        static std::string print(std::vector<XmlDiffEdit> const & edits);
+
+};
+
+#endif /* XML_DIFF_H */
@@ -1,46 +1,321 @@
 #include "XmlDocument.hh"
+#include "FrozenXmlDocument.hh"
+
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+
+/** Returns the seconds elapsed since the given time point */
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** A namespace declaration in scope, as the ids of its prefix (NAME_NONE for the default namespace) and its namespace URI */
+typedef std::pair<uint32_t, uint32_t> NamespaceBinding;
+
+/** Returns the id of the namespace bound to the given prefix by the innermost declaration in scope 
+ * (NAME_NONE for the default namespace if none declared, NAME_UNRESOLVED for other undeclared prefixes) 
+*/
+static uint32_t lookupNamespace(std::vector<NamespaceBinding> const & bindings, std::string_view prefix) {
+    uint32_t prefixId;
+    if(NameTable::find(prefix, &prefixId)) {
+        for(size_t i = bindings.size(); i > 0; i--) {
+            if(bindings[i-1].first == prefixId)
+                return bindings[i-1].second;
+        }
+    }
+    return (prefix.empty() ? NAME_NONE : NAME_UNRESOLVED);
+}
+
+/** Resolves the names of the given Node and its attributes, adding the namespaces it declares to the bindings
+ * (returns false without changing anything if the Node isn't an element or a tagged text element)
+ *  @param attributeNames a list reused for the names of the attributes of each Node
+*/
+static bool resolveNames(Node * node, std::vector<NamespaceBinding> & bindings, std::vector<ExpandedName> & attributeNames) {
+    NodeTypeName type = node->getNodeType();
+    if(type != NodeTypeName::XmlElement && !(type == NodeTypeName::TextElement && ((TextElement const *)node)->getShowTag()))
+        return false;
+
+    /* The declarations of the element apply to its own name and attributes as well */
+    NodeAttributes const & attributes = node->getAttributes();
+    for(auto const & it : attributes) {
+        std::string_view key(it.first);
+        if(key == "xmlns")
+            bindings.emplace_back(NAME_NONE, NameTable::intern(it.second));
+        else if(key.compare(0, 6, "xmlns:") == 0)
+            bindings.emplace_back(NameTable::intern(key.substr(6)), NameTable::intern(it.second));
+    }
+
+    std::string name = node->getName();
+    std::string_view view(name);
+    size_t colon = view.find(':');
+    ExpandedName expanded;
+    if(colon == std::string::npos) {
+        expanded.namespaceId = lookupNamespace(bindings, std::string_view());
+        expanded.localNameId = NameTable::intern(view);
+    } else {
+        expanded.namespaceId = lookupNamespace(bindings, view.substr(0, colon));
+        expanded.localNameId = NameTable::intern(view.substr(colon + 1));
+    }
+    node->_setExpandedName(expanded);
+
+    /* Unprefixed attributes are in no namespace (the default namespace doesn't apply to them) */
+    attributeNames.clear();
+    for(auto const & it : attributes) {
+        std::string_view key(it.first);
+        size_t attributeColon = key.find(':');
+        ExpandedName attribute;
+        if(key == "xmlns") {
+            attribute.namespaceId = NameTable::intern(NAMESPACE_XMLNS);
+            attribute.localNameId = NameTable::intern(key);
+        } else if(attributeColon == std::string::npos) {
+            attribute.namespaceId = NAME_NONE;
+            attribute.localNameId = NameTable::intern(key);
+        } else {
+            attribute.namespaceId = lookupNamespace(bindings, key.substr(0, attributeColon));
+            attribute.localNameId = NameTable::intern(key.substr(attributeColon + 1));
+        }
+        attributeNames.push_back(attribute);
+    }
+    node->_setAttributeNames(attributeNames);
+    return true;
+}
+
+/**
+ * Finds whether a character occurs within ranges of a text, which are searched in the order of their first positions,
+ * so that each part of the text is searched at most once, however many of the ranges contain it
+*/
+struct CharacterFinder {
+    std::string const & text;
+    char character;
+    /** The position the last search started at, and the position of the first occurrence found after it (the length of the text if none) */
+    size_t from;
+    size_t found;
+
+    CharacterFinder(std::string const & text, char character) : text(text), character(character), from(std::string::npos), found(0) {}
+
+    /** Returns whether the character occurs between begin and end */
+    bool occursIn(size_t begin, size_t end) {
+        /* Searching again only if the last found occurrence is before the range (or the range starts before the last search) */
+        if(begin < this->from || begin > this->found) {
+            void const * position = std::memchr(this->text.data() + begin, this->character, this->text.length() - begin);
+            this->from = begin;
+            this->found = (position ? (char const *)position - this->text.data() : this->text.length());
+        }
+        return (this->found < end);
+    }
+};
 
 /* Protected member functions */
 
+void XmlDocument::collectStats(void) {
+    /* Going through all Nodes, with an explicit stack of Nodes left to process along with their depth */
+    std::vector<std::pair<Node const *, size_t>> stack;
+    for(size_t i = this->nodes.size(); i > 0; i--) {
+        stack.push_back({this->nodes[i-1], 1});
+    }
+    while(!stack.empty()) {
+        std::pair<Node const *, size_t> current = stack.back();
+        stack.pop_back();
+        this->stats->addNode(current.first, current.second);
+
+        if(current.first->getNodeType() == NodeTypeName::XmlElement) {
+            XmlElement const * element = (XmlElement const *)current.first;
+            for(size_t i = element->getChildAmount(); i > 0; i--) {
+                stack.push_back({element->getChild(i-1), current.second + 1});
+            }
+        } else if(current.first->getNodeType() == NodeTypeName::DoctypeDTD) {
+            DoctypeDTD const * doctype = (DoctypeDTD const *)current.first;
+            for(size_t i = doctype->getChildAmount(); i > 0; i--) {
+                stack.push_back({doctype->getChild(i-1), current.second + 1});
+            }
+        }
+    }
+}
+
+size_t XmlDocument::appendGap(std::string & result, std::string const & source, size_t begin, size_t end) {
+    size_t first = begin;
+    while(first < end && std::isspace((unsigned char)source[first]))
+        first++;
+
+    /* Whitespace only - appending whole */
+    if(first == end) {
+        result.append(source, begin, end - begin);
+        return end - begin;
+    }
+
+    /* Otherwise keeping the whitespace before the line of the first removed Node, and after the line of the last removed Node */
+    size_t last = end;
+    while(std::isspace((unsigned char)source[last-1]))
+        last--;
+    size_t leading = source.rfind('\n', first);
+    if(leading == std::string::npos || leading < begin)
+        leading = begin;
+    else
+        leading++;
+    size_t trailing = source.find('\n', last);
+    if(trailing == std::string::npos || trailing >= end)
+        trailing = last;
+    else
+        trailing++;
+    result.append(source, begin, leading - begin);
+    result.append(source, trailing, end - trailing);
+    return (leading - begin) + (end - trailing);
+}
+
+/** Returns the amount of nested Nodes of the given parent (the amount of root-level Nodes of the document if null pointer) */
+static size_t getNestedAmount(Node const * parent, std::pmr::vector<Node *> const & nodes) {
+    if(parent && parent->getNodeType() == NodeTypeName::XmlElement)
+        return ((XmlElement const *)parent)->getChildAmount();
+    else if(parent && parent->getNodeType() == NodeTypeName::DoctypeDTD)
+        return ((DoctypeDTD const *)parent)->getChildAmount();
+    return nodes.size();
+}
+
+void XmlDocument::printSourceNodes(std::string & result, Node const * parent, size_t begin, size_t end, int indentLevel, size_t & copied) const {
+    /* The Nodes whose nested Nodes are being printed, with the position of the next nested Node, the position in the loaded text up to which everything was printed,
+     * the end of the range of the nested Nodes and the end of the parent in the loaded text (the rest of the parent is copied after the nested Nodes)
+    */
+    struct Frame {
+        Node const * parent;
+        size_t amount;
+        size_t next;
+        size_t position;
+        size_t end;
+        size_t parentEnd;
+        int indentLevel;
+    };
+    std::string const & source = *this->source;
+    std::vector<Frame> stack;
+    stack.push_back({ parent, getNestedAmount(parent, this->nodes), 0, begin, end, end, indentLevel });
+
+    while(!stack.empty()) {
+        Frame & frame = stack.back();
+        if(frame.next >= frame.amount) {
+            copied += XmlDocument::appendGap(result, source, frame.position, frame.end);
+            result.append(source, frame.end, frame.parentEnd - frame.end);
+            copied += frame.parentEnd - frame.end;
+            stack.pop_back();
+            continue;
+        }
+
+        size_t i = frame.next++;
+        Node const * node;
+        if(frame.parent == nullptr)
+            node = this->nodes[i];
+        else if(frame.parent->getNodeType() == NodeTypeName::XmlElement)
+            node = ((XmlElement const *)frame.parent)->getChild(i);
+        else
+            node = ((DoctypeDTD const *)frame.parent)->getChild(i);
+
+        /* Nodes not loaded from the text (or moved from their original position) are printed whole */
+        if(node->_getSourceBegin() == std::string::npos || node->_getSourceBegin() < frame.position || node->_getSourceEnd() > frame.end) {
+            node->printTo(result, frame.indentLevel);
+            continue;
+        }
+
+        copied += XmlDocument::appendGap(result, source, frame.position, node->_getSourceBegin());
+        frame.position = node->_getSourceEnd();
+        size_t contentBegin, contentEnd;
+        int contentIndent;
+        if(this->printSourceNode(result, node, frame.indentLevel, copied, &contentBegin, &contentEnd, &contentIndent))
+            stack.push_back({ node, getNestedAmount(node, this->nodes), 0, contentBegin, contentEnd, node->_getSourceEnd(), contentIndent });
+    }
+}
+
+bool XmlDocument::printSourceNode(std::string & result, Node const * node, int indentLevel, size_t & copied, size_t * contentBegin, size_t * contentEnd, int * contentIndent) const {
+    std::string const & source = *this->source;
+    size_t begin = node->_getSourceBegin();
+    size_t end = node->_getSourceEnd();
+
+    /* Unmodified Node - copied whole */
+    if(!node->isDirty() && !node->isNestedDirty()) {
+        result.append(source, begin, end - begin);
+        copied += end - begin;
+        return false;
+    }
+
+    /* Unmodified Node with modified nested Nodes - copying the part before the nested Nodes, the nested Nodes and the part after them are appended by the caller */
+    if(!node->isDirty()) {
+        /* The range of the nested Nodes in the loaded text (between the tag parts of an element, or within the square brackets of a Doctype) */
+        *contentBegin = std::string::npos;
+        *contentEnd = std::string::npos;
+        bool singleLine = false;
+        if(node->getNodeType() == NodeTypeName::XmlElement) {
+            *contentBegin = begin;
+            XmlDocument::getNextTagPart(source, contentBegin);
+            /* Self-closing elements have no content to print nested Nodes into, and elements without nested Nodes are printed self-closing */
+            if(source[*contentBegin-2] == '/' || ((XmlElement const *)node)->childrenEmpty())
+                *contentBegin = std::string::npos;
+            *contentEnd = source.rfind('<', end - 1);
+            singleLine = ((XmlElement const *)node)->getSingleLine();
+        } else if(node->getNodeType() == NodeTypeName::DoctypeDTD) {
+            *contentBegin = source.find('[', begin);
+            if(*contentBegin != std::string::npos)
+                (*contentBegin)++;
+            *contentEnd = source.rfind(']', end - 1);
+            singleLine = ((DoctypeDTD const *)node)->getSingleLine();
+        }
+
+        if(*contentBegin != std::string::npos && *contentEnd != std::string::npos && *contentBegin <= *contentEnd && *contentEnd < end) {
+            result.append(source, begin, *contentBegin - begin);
+            copied += *contentBegin - begin;
+            *contentIndent = (singleLine ? 0 : indentLevel + 1);
+            return true;
+        }
+    }
+
+    /* Modified Node - printed whole, without the indent if it's already copied from the text before the Node */
+    size_t printBegin = result.length();
+    node->printTo(result, indentLevel);
+    if(begin > 0 && (source[begin-1] == '\t' || source[begin-1] == ' ')) {
+        size_t indentEnd = printBegin;
+        while(indentEnd < result.length() && result[indentEnd] == '\t')
+            indentEnd++;
+        result.erase(printBegin, indentEnd - printBegin);
+    }
+    return false;
+}
+
 /* Protected static - auxiliary functions for XML parsing/processing */
 
 std::string XmlDocument::getNextTagPart(std::string const & content, size_t * i) {
-    std::string result;
-
     /* If incorrect parameters passed, empty string returned */
     if((*i) >= content.length()) {
-        return result;
+        return std::string();
     }
 
-    /* Saving first character, initializing the tag counter to keep track of '<>' and processing content */
-    result += content[*i];
-    (*i)++;
+    size_t begin = *i;
+    *i = XmlDocument::findTagPartEnd(content, begin, content.length());
+    return content.substr(begin, (*i) - begin);
+}
+
+size_t XmlDocument::findTagPartEnd(std::string const & content, size_t i, size_t end) {
+    /* Skipping the first character, initializing the tag counter to keep track of '<>' and processing content */
+    i++;
     int tagCounter = 1;
     /* inQuotes - what type of quote the parser is in, or 0 if not in quotes */
     char inQuotes = 0;
 
-    for(; (tagCounter > 0) && ((*i) < content.length()); (*i)++) {
-        /* Adding next character to the result */
-        result += content[*i];
-
+    for(; (tagCounter > 0) && (i < end); i++) {
         /* If the parser is within quoted (double or single) text, only look for the quote */
         if(inQuotes) {
-            if(content[*i] == inQuotes && content[(*i)-1] != '\\') {
+            if(content[i] == inQuotes && content[i-1] != '\\') {
                 inQuotes = 0;
             }
         /* If the parser is not in quoted text, look for '<>' and increment or decrement the tag counter (+check quotes) */
         } else {
-            if(content[*i] == '"' || content[*i] == '\'') {
-                inQuotes = content[*i];
-            } else if(content[*i] == '<') {
+            if(content[i] == '"' || content[i] == '\'') {
+                inQuotes = content[i];
+            } else if(content[i] == '<') {
                 tagCounter++;
-            } else if(content[*i] == '>') {
+            } else if(content[i] == '>') {
                 tagCounter--;
             }
         }
     }
 
-    return result;
+    return i;
 }
 
 std::string XmlDocument::getTagName(std::string const & tag, int * endIndex) {
@@ -143,7 +418,8 @@ void XmlDocument::saveAttributes(std::string const & tag, Node * nodeObject, int
     }
 }
 
-Node * XmlDocument::getXMLObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent) {
+Node * XmlDocument::getXMLObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent, std::pmr::memory_resource * resource, size_t sourceBegin,
+                                 size_t maxDepth) {
 
     /* Result variable initialized to nullptr, so that nullptr is returned if anything goes wrong */
     Node * result = nullptr;
@@ -163,44 +439,53 @@ Node * XmlDocument::getXMLObject(std::string const & trimmedNode, std::string co
 
         case NodeTypeName::Comment:
             content = trimmedNode.substr(5, trimmedNode.length()-9);
-            result = new Comment(nodeName, content, false, endLine, indent);
+            result = new(resource) Comment(nodeName, content, false, endLine, indent, resource);
             break;
         
         case NodeTypeName::ProcessingInstruction:
-            result = new ProcessingInstruction(nodeName, endLine, indent);
+            result = new(resource) ProcessingInstruction(nodeName, endLine, indent, resource);
             XmlDocument::saveAttributes(trimmedNode, result);
             break;
         
         case NodeTypeName::TextElement:
-            result = new TextElement(nodeName, content, innerContent, indent, endLine, false);
+            result = new(resource) TextElement(nodeName, content, innerContent, indent, endLine, false, resource);
+            /* Only a Text Element enclosed in a tag can have attributes */
+            if(innerContent)
+                XmlDocument::saveAttributes(trimmedNode, result);
             break;
         
         case NodeTypeName::XmlElement:
-            result = new XmlElement(nodeName, (content.find('\n') == std::string::npos), endLine, indent, true);
+            result = new(resource) XmlElement(nodeName, (content.find('\n') == std::string::npos), endLine, indent, true, resource);
             XmlDocument::saveAttributes(trimmedNode, result);
-            /* Adding processed internal content */
+            /* Adding processed internal content (built without recursing, the element taking ownership of the allocated Nodes) */
             if(innerContent && !content.empty()) {
-                for(std::pair<std::string, NodeTypeName> it : XmlDocument::getNodes(content)) {
-                    /* Add child Node (since XmlDocument::getNodeObject allocates the Node dynamically, the allocated instance is deleted afterwards) */
-                    Node * childNode = XmlDocument::getNodeObject(it.first, it.second);
-                    /* Check that allocated correctly before adding */
-                    if(childNode != nullptr) {
-                        ((XmlElement *)result)->pushBackChild(*childNode);
-                        delete childNode;
-                    }
+                /* The position of the content in the loaded text (the opening tag part ends at the first '\0' marker) */
+                size_t contentBegin = (sourceBegin == std::string::npos ? std::string::npos : sourceBegin + trimmedNode.find('\0'));
+                std::vector<Node *> children;
+                try {
+                    /* The nested Nodes are one level deeper than the element */
+                    if(maxDepth == 1)
+                        throw std::invalid_argument("Error: Nodes nested deeper than the maximum depth of 1");
+                    XmlDocument::buildNodes(content, 0, content.length(), XmlDocument::findClosingTags(content), resource, contentBegin, (maxDepth == 0 ? 0 : maxDepth - 1), XmlParseOptions(), children);
+                } catch(...) {
+                    result->_release();
+                    throw;
+                }
+                for(Node * it : children) {
+                    ((XmlElement *)result)->_adoptChild(it);
                 }
             }
             break;
 
         case NodeTypeName::XmlProlog:
-            result = new XmlProlog(nodeName);
+            result = new(resource) XmlProlog(nodeName, 1.0f, "", STANDALONE_UNSET, true, false, false, resource);
             XmlDocument::saveAttributes(trimmedNode, result);
             result->setIndent(indent);
             result->setEndLine(endLine);
             break;
         
         default:
-            result = new Node(nodeName, endLine, indent);
+            result = new(resource) Node(nodeName, endLine, indent, resource);
             XmlDocument::saveAttributes(trimmedNode, result);
             break;
     }
@@ -208,7 +493,7 @@ Node * XmlDocument::getXMLObject(std::string const & trimmedNode, std::string co
     return result;
 }
 
-Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent) {
+Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent, std::pmr::memory_resource * resource, size_t sourceBegin) {
     
     /* Result variable initialized to nullptr, so that nullptr is returned if anything goes wrong */
     Node * result = nullptr;
@@ -219,14 +504,20 @@ Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string co
     /* Splitting attributes */
     std::string buffer;
     char inQuotes = 0;
+    /* The amount of brackets nested in the outer brackets of a content model */
+    size_t nested = 0;
     for(size_t i = 2 + nodeName.length(); i < trimmedNode.length(); i++) {
         /* Character for the current iteration */
         char c = trimmedNode[i];
         /* Case 1: In Quotes */
         if(inQuotes != 0) {
             buffer += c;
-            /* Testing if non-escaped end of quote found */
-            if(c == inQuotes && trimmedNode[i-1] != '\\') {
+            /* Testing if non-escaped end of quote found (brackets can be nested in content models, e.g. "(a, (b | c)+)") */
+            if(inQuotes == ')' && c == '(') {
+                nested++;
+            } else if(c == inQuotes && nested > 0) {
+                nested--;
+            } else if(c == inQuotes && trimmedNode[i-1] != '\\') {
                 inQuotes = 0;
             }
         /* Case 2: Out of quotes */
@@ -264,7 +555,7 @@ Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string co
         case NodeTypeName::AttributeDTD:
             /* If more than 2 attributes, the Node is processed, otherwise the declaration is invalid */
             if(attr.size() >= 3) {
-                result = new AttributeDTD(attr[0], attr[1], attr[2]);
+                result = new(resource) AttributeDTD(attr[0], attr[1], attr[2], DTD_ATTR_IMPLIED, false, true, true, resource);
                 result->setIndent(indent);
                 result->setEndLine(endLine);
                 /* Saving the content as a string if single quote-surrounded content field, otherwise as the literal present value */
@@ -285,15 +576,29 @@ Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string co
         
         case NodeTypeName::DoctypeDTD:
             if(attr.size() >= 1) {
-                result = new DoctypeDTD(attr[0], (trimmedNode.find('\n') == std::string::npos), indent, endLine);
+                result = new(resource) DoctypeDTD(attr[0], (trimmedNode.find('\n') == std::string::npos), indent, endLine, resource);
                 /* Processing nested DTD nodes (checking if the last element starts with a square bracket) */
                 if(attr.size() >= 2 || attr[attr.size()-1][0] == '[') {
-                    for(std::pair<std::string, NodeTypeName> it : XmlDocument::getNodes(attr[attr.size()-1].substr(1, attr[attr.size()-1].length()-2))) {
-                        Node * childNode = XmlDocument::getNodeObject(it.first, it.second);
-                        if(childNode != nullptr) {
-                            ((DoctypeDTD *)result)->pushBackChild(*((DTD *)childNode));
-                            delete childNode;
+                    /* The position of the nested declarations in the loaded text (after the '[' starting the last attribute) */
+                    size_t contentBegin = (sourceBegin == std::string::npos ? std::string::npos : sourceBegin + trimmedNode.rfind(attr[attr.size()-1]) + 1);
+                    std::vector<std::pair<size_t, size_t>> ranges;
+                    std::vector<std::pair<std::string, NodeTypeName>> declarations = XmlDocument::getNodes(attr[attr.size()-1].substr(1, attr[attr.size()-1].length()-2), &ranges);
+                    try {
+                        for(size_t i = 0; i < declarations.size(); i++) {
+                            /* Elements and Doctypes can't be declared within a Doctype (skipped, so that nested Doctypes can't make the parsing recurse) */
+                            if(declarations[i].second == NodeTypeName::XmlElement || declarations[i].second == NodeTypeName::DoctypeDTD)
+                                continue;
+                            Node * childNode = (contentBegin == std::string::npos)
+                                ? XmlDocument::getNodeObject(declarations[i].first, declarations[i].second, resource)
+                                : XmlDocument::getNodeObject(declarations[i].first, declarations[i].second, resource, contentBegin + ranges[i].first, contentBegin + ranges[i].second);
+                            if(childNode != nullptr) {
+                                ((DoctypeDTD *)result)->_adoptChild((DTD *)childNode);
+                            }
                         }
+                    } catch(...) {
+                        /* Deleting the Doctype along with the nested Nodes added so far */
+                        result->_release();
+                        throw;
                     }
                 }
                 /* Adding ext if desired */
@@ -310,14 +615,22 @@ Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string co
 
         case NodeTypeName::ElementDTD:
             if(attr.size() >= 2) {
-                result = new ElementDTD(attr[0], (attr[1].find('(') != std::string::npos ? attr[1].substr(1, attr[1].length()-2) : attr[1]), indent, endLine);
+                /* A content model is saved without its outer brackets, and with the modifier following them (e.g. "(a | b)*") saved separately */
+                std::string modifier;
+                if(attr[1].find('(') != std::string::npos && attr[1].length() > 2 && std::strchr("?*+", attr[1].back()) != nullptr) {
+                    modifier = attr[1].substr(attr[1].length()-1);
+                    attr[1].pop_back();
+                }
+                result = new(resource) ElementDTD(attr[0], (attr[1].find('(') != std::string::npos ? attr[1].substr(1, attr[1].length()-2) : attr[1]), indent, endLine, resource);
+                if(!modifier.empty())
+                    ((ElementDTD *)result)->setElementModifier(modifier);
             }
             break;
         
         case NodeTypeName::EntityDTD:
             if(attr.size() >= 2) {
                 /* Creating a new EntityDTD with the known values */
-                result = new EntityDTD(attr[0]);
+                result = new(resource) EntityDTD(attr[0], "_default_entity_value", true, true, true, resource);
                 result->setIndent(indent);
                 result->setEndLine(endLine);
                 /* Setting the entity value based on the read attributes */
@@ -352,212 +665,335 @@ Node * XmlDocument::getDTDObject(std::string const & trimmedNode, std::string co
                     buffer += " ";
             }
             /* Creating the default DTD */
-            result = new DTD(nodeName, buffer, indent, endLine);
+            result = new(resource) DTD(nodeName, buffer, indent, endLine, resource);
             break;
     }
 
     return result;
 }
 
+std::vector<std::pair<size_t, size_t>> XmlDocument::findClosingTags(std::string const & text) {
+    std::vector<std::pair<size_t, size_t>> result;
+    /* The elements which aren't closed yet, as the position and length of their name, and their index in the result */
+    struct OpenTag {
+        size_t name;
+        size_t length;
+        size_t index;
+    };
+    std::vector<OpenTag> open;
+
+    size_t length = text.length();
+    size_t i = 0;
+    while(i < length) {
+        /* Only the tags are processed, skipping the text between them */
+        void const * found = std::memchr(text.data() + i, '<', length - i);
+        if(!found)
+            break;
+        size_t tag = (char const *)found - text.data();
 
-/* Static member functions */
-
-std::vector<std::pair<std::string, NodeTypeName>> XmlDocument::getNodes(std::string const & fileContent) {
-    std::vector<std::pair<std::string, NodeTypeName>> result;
-
-    /* The temporary buffer the current Node declaration string is stored in */
-    std::string buffer;
-    /* The detected type of the last processed Node declaration */
-    NodeTypeName currentNode = NodeTypeName::Node;
+        /* Comments (until the next "-->"), DTD and PI tag parts can't contain elements */
+        if(text.compare(tag+1, 3, "!--") == 0) {
+            size_t commentEnd = text.find("-->", tag+4);
+            i = (commentEnd == std::string::npos ? length : commentEnd + 3);
+            continue;
+        }
+        i = XmlDocument::findTagPartEnd(text, tag, length);
+        if(tag + 1 >= length || text[tag+1] == '!' || text[tag+1] == '?')
+            continue;
+
+        /* The name of the element - text until the first whitespace, '>' or '/' */
+        bool closing = (text[tag+1] == '/');
+        size_t name = tag + (closing ? 2 : 1);
+        size_t nameEnd = name;
+        while(nameEnd < i && !std::isspace((unsigned char)text[nameEnd]) && text[nameEnd] != '>' && text[nameEnd] != '/')
+            nameEnd++;
+
+        /* Opening tag part of an element with content (self-closing elements have none) */
+        if(!closing) {
+            if(i - tag < 2 || text[i-2] != '/' || text[i-1] != '>') {
+                open.push_back({ name, nameEnd - name, result.size() });
+                result.emplace_back(tag, std::string::npos);
+            }
+            continue;
+        }
 
+        /* Closing tag part - closes the innermost open element with the same name, leaving the elements opened after it unclosed (ignored if there is none) */
+        for(size_t j = open.size(); j > 0; j--) {
+            if(open[j-1].length == nameEnd - name && text.compare(open[j-1].name, open[j-1].length, text, name, nameEnd - name) == 0) {
+                result[open[j-1].index].second = tag;
+                open.resize(j-1);
+                break;
+            }
+        }
+    }
 
-    /* Main processing loop, parses all characters within the text content */
-    size_t i = 0;
-    while(i < fileContent.length()) {
+    return result;
+}
 
-        /* Fall into corresponding processing loop based on the type of content */
-        
+bool XmlDocument::scanDeclaration(std::string const & text, size_t begin, size_t * i, size_t end, std::vector<std::pair<size_t, size_t>> const & closingTags, NodeDeclaration * declaration) {
+    while(true) {
         /* Ignore whitespace not enclosed within Nodes */
-        if(isspace(fileContent[i])) {
-            i++;
-        
-        /* Any content starting with '<' */
-        } else if(fileContent[i] == '<') {
-
-            /* Comment - process until next "-->" reached */
-            if(fileContent.substr(i+1, 3).compare("!--") == 0) {
-                
-                /* Check that last processed characters (i-3 so that even the last '>' gets added to the buffer) weren't "-->" in condition */
-                for(; (fileContent.substr(i-3, 3).compare("-->") != 0) && (i < fileContent.length()); i++) {
-                    buffer += fileContent[i];
-                }
-
-                /* Saving Node type */
-                currentNode = NodeTypeName::Comment;
-            
-
-            /* DTD or PI content - process until corresponding '>' reached */
-            } else if(fileContent[i+1] == '!' || fileContent[i+1] == '?') {
+        while((*i) < end && std::isspace((unsigned char)text[*i]))
+            (*i)++;
+        if((*i) >= end)
+            return false;
+
+        size_t nodeBegin = *i;
+        declaration->tagEnd = std::string::npos;
+        declaration->closingBegin = std::string::npos;
+
+        /* Plaintext content not starting with '<' (representable as TextElement) - until new Node started */
+        if(text[nodeBegin] != '<') {
+            void const * found = std::memchr(text.data() + nodeBegin, '<', end - nodeBegin);
+            *i = (found ? (size_t)((char const *)found - text.data()) : end);
+            declaration->type = NodeTypeName::TextElement;
+
+        /* Comment - until the next "-->" (the shortest possible comment being "<!---->") */
+        } else if(end - nodeBegin >= 4 && text.compare(nodeBegin+1, 3, "!--") == 0) {
+            size_t commentEnd = text.find("-->", nodeBegin+4);
+            *i = ((commentEnd == std::string::npos || commentEnd + 3 > end) ? end : commentEnd + 3);
+            declaration->type = NodeTypeName::Comment;
+
+        /* DTD or PI content - until the corresponding '>' */
+        } else if(nodeBegin + 1 < end && (text[nodeBegin+1] == '!' || text[nodeBegin+1] == '?')) {
+            *i = XmlDocument::findTagPartEnd(text, nodeBegin, end);
+            size_t tagEnd = *i;
+            auto startsWith = [&](char const * prefix) {
+                size_t length = std::strlen(prefix);
+                return (nodeBegin + 1 + length <= tagEnd && text.compare(nodeBegin+1, length, prefix) == 0);
+            };
+
+            /* The prolog target is exactly "xml" (not e.g. the "xml-stylesheet" processing instruction) */
+            if(tagEnd - nodeBegin > 5 && startsWith("?xml") && (std::isspace((unsigned char)text[nodeBegin+5]) || text[nodeBegin+5] == '?')) {
+                declaration->type = NodeTypeName::XmlProlog;
+            } else if(text[nodeBegin+1] == '?') {
+                declaration->type = NodeTypeName::ProcessingInstruction;
+            } else if(startsWith("!" DTD_ATTRIBUTES)) {
+                declaration->type = NodeTypeName::AttributeDTD;
+            } else if(startsWith("!" DTD_DOCTYPE)) {
+                declaration->type = NodeTypeName::DoctypeDTD;
+            } else if(startsWith("!" DTD_ELEMENT)) {
+                declaration->type = NodeTypeName::ElementDTD;
+            } else if(startsWith("!" DTD_ENTITY)) {
+                declaration->type = NodeTypeName::EntityDTD;
+            } else {
+                declaration->type = NodeTypeName::DTD;
+            }
 
-                /* Getting the part of an XML tag (in the case of single-part DTD or PI it's the whole tag) - content enclosed in <...> */
-                buffer += getNextTagPart(fileContent, &i);
+        /* Closing tag part without an opening tag part - skipped */
+        } else if(nodeBegin + 1 < end && text[nodeBegin+1] == '/') {
+            *i = XmlDocument::findTagPartEnd(text, nodeBegin, end);
+            continue;
 
-                /* Saving Node type (testing if first occurence of the desired XML content begins the buffer string) */
-                if(buffer.find("?xml") == 1) {
-                    currentNode = NodeTypeName::XmlProlog;
-                } else if(buffer[1] == '?') {
-                    currentNode = NodeTypeName::ProcessingInstruction;
-                } else {
-                    /* Testing DTD Subtypes */
-                    if(buffer.find("!" DTD_ATTRIBUTES) == 1) {
-                        currentNode = NodeTypeName::AttributeDTD;
-                    } else if(buffer.find("!" DTD_DOCTYPE) == 1) {
-                        currentNode = NodeTypeName::DoctypeDTD;
-                    } else if(buffer.find("!" DTD_ELEMENT) == 1) {
-                        currentNode = NodeTypeName::ElementDTD;
-                    } else if(buffer.find("!" DTD_ENTITY) == 1) {
-                        currentNode = NodeTypeName::EntityDTD;
-                    } else {
-                        currentNode = NodeTypeName::DTD;
-                    }
-                }
+        /* Tagged TextElement or XmlElement */
+        } else {
+            size_t tagEnd = XmlDocument::findTagPartEnd(text, nodeBegin, end);
 
+            /* Single-part immediately closed XmlElement */
+            if(tagEnd - nodeBegin >= 2 && text[tagEnd-2] == '/' && text[tagEnd-1] == '>') {
+                *i = tagEnd;
+                declaration->type = NodeTypeName::XmlElement;
 
-            /* Tagged TextElement or XmlElement - process starting tag, then go through the remaining content until corresponding closing tag found */
+            /* Content until the closing tag part (or until the end of the range, if the element isn't closed within it) */
             } else {
+                auto found = std::lower_bound(closingTags.begin(), closingTags.end(), std::make_pair(nodeBegin, (size_t)0));
+                size_t closingBegin = end;
+                if(found != closingTags.end() && found->first == nodeBegin && found->second != std::string::npos && found->second >= tagEnd && found->second < end)
+                    closingBegin = found->second;
+                declaration->tagEnd = tagEnd;
+                declaration->closingBegin = closingBegin;
+                *i = (closingBegin < end ? XmlDocument::findTagPartEnd(text, closingBegin, end) : end);
+
+                /* Whether the content contains any XML tags (making it an XmlElement instead of a TextElement with a shown tag) */
+                if(std::memchr(text.data() + tagEnd, '<', closingBegin - tagEnd))
+                    declaration->type = NodeTypeName::XmlElement;
+                else
+                    declaration->type = NodeTypeName::TextElement;
+            }
+        }
 
-                /* Getting the Tag part started by the '<' at the current i (moves i to the end of the tag) */
-                buffer += getNextTagPart(fileContent, &i);
+        /* A line break right after the declaration ends its line, and an indented declaration is preceded by a tab or space and ends its line */
+        declaration->begin = nodeBegin;
+        declaration->end = *i;
+        declaration->endLine = ((*i) < end && text[*i] == '\n');
+        declaration->indent = (declaration->endLine && nodeBegin > begin && (text[nodeBegin-1] == '\t' || text[nodeBegin-1] == ' '));
+        return true;
+    }
+}
 
-                /* Single-part immediately closed XmlElement - the tag part already saved to buffer, so set type to XmlElement and skip the rest */
-                if(buffer.substr(buffer.length()-2, 2).compare("/>") == 0) {
-                    currentNode = NodeTypeName::XmlElement;
-                
-                /* Process content until the closing tag is reached (ignoring the closing tags of nested elements of the same name) */
-                } else {
+std::string XmlDocument::getDeclarationText(std::string const & text, NodeDeclaration const & declaration) {
+    std::string result;
+    result.reserve(declaration.end - declaration.begin + 4);
 
-                    /* Inserting '\0' to the border between the tag part and content, to differentiate */
-                    buffer += '\0';
-                    
-                    /* The name of the node - text between the start and the first occurence of a blank space or a closing '>', whichever is smaller */
-                    std::string nodeName = buffer.substr(1, std::min(buffer.find(" "), buffer.find(">"))-1);
-                    /* How deeply nested the program is in any node with the set nodeName */
-                    int nodeCounter = 1;
-                    /* Whether the inner content of the Node contains any XML tags (making it an XmlElement instead of a TextElement with a shown tag) */
-                    bool containsXml = false;
-                    /* Which type of quotes the processing is in, if in any */
-                    char inQuotes = 0;
-                    /* Whether the processing is inside an XML comment */
-                    bool comment = false;
-                    
-                    for(; (nodeCounter > 0) && (i < fileContent.length()); i++) {
-                        if(inQuotes) {
-                            /* If in quotes, the only check done is whether the end of the quotes reached */
-                            if(fileContent[i] == inQuotes && fileContent[i-1] != '\\') {
-                                inQuotes = 0;
-                            }
-                        } else if(comment) {
-                            /* If in a comment, only check whether the end of the comment reached */
-                            if(fileContent.substr(i, 3).compare("-->") == 0) {
-                                comment = false;
-                            }
-                        } else {
-                            /* If tag opening angle bracket found (and not in quotes), process what the tag is */
-                            if(fileContent[i] == '<') {
-                                /* Comment if the angle bracket starts an XML comment */
-                                if(fileContent.substr(i, 3).compare("<--") == 0) {
-                                    comment = true;
-                                /* Increment or decrement nodeCounter if tag name found (ignore if irrelevant tag) */
-                                } else if(fileContent.substr(i+1, nodeName.length()).compare(nodeName) == 0) {
-                                    nodeCounter++;
-                                } else if(fileContent.substr(i+1, nodeName.length()+1).compare("/" + nodeName) == 0) {
-                                    nodeCounter--;
-                                }
-
-                                /* Saving that tag content contains xml if angle bracket found and not final node part */
-                                if(!containsXml && nodeCounter > 0)
-                                    containsXml = true;
-                            
-                            /* Checking for an opening quote (if not angle bracket starting tag) */
-                            } else if(fileContent[i] == '"' || fileContent[i] == '\'') {
-                                inQuotes = fileContent[i];
-                            }
-                        }
-                        /* Adding content to buffer unless the end reached */
-                        if(nodeCounter > 0)
-                            buffer += fileContent[i];
-                    }
+    /* Adding leading tab or trailing linebreak if any exist, to keep new line formatting more consistent with loaded documents */
+    if(declaration.indent)
+        result += '\t';
+    if(declaration.tagEnd == std::string::npos) {
+        result.append(text, declaration.begin, declaration.end - declaration.begin);
+    } else {
+        /* Inserting the '\0' character to the borders between the tag parts and the content, to differentiate */
+        result.append(text, declaration.begin, declaration.tagEnd - declaration.begin);
+        result += '\0';
+        result.append(text, declaration.tagEnd, declaration.closingBegin - declaration.tagEnd);
+        result += '\0';
+        result.append(text, declaration.closingBegin, declaration.end - declaration.closingBegin);
+    }
+    if(declaration.endLine)
+        result += '\n';
 
-                    /* Decrementing as last step of loop incremented i, so that i stays at the '<' character of the second Node part */
-                    i--;
-                    /* Inserting the '\0' character to differentiate content from the closing tag part */
-                    buffer += '\0';
-                    /* Saving the closing Tag part of the content */
-                    buffer += getNextTagPart(fileContent, &i);
-
-                    /* Saving Node type and closing tag part after corresponding closing tag part found */
-                    if(containsXml)
-                        currentNode = NodeTypeName::XmlElement;
-                    else
-                        currentNode = NodeTypeName::TextElement;
-                }
+    return result;
+}
 
+void XmlDocument::buildNodes(std::string const & text, size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> const & closingTags, std::pmr::memory_resource * resource,
+                             size_t sourceBegin, size_t maxDepth, XmlParseOptions const & options, std::vector<Node *> & nodes) {
+    /* The elements whose content is being built, with the position of the next declaration, the range of the content and the range of the element in the loaded text
+     * (the first level being the given range, without an element)
+    */
+    struct Level {
+        XmlElement * element;
+        size_t position;
+        size_t begin;
+        size_t end;
+        size_t sourceBegin;
+        size_t sourceEnd;
+    };
+    std::vector<Level> levels;
+    levels.push_back({ nullptr, begin, begin, end, std::string::npos, std::string::npos });
+
+    /* The elements are built in the order of their positions, so each part of the text is only searched for line breaks and tabs once */
+    CharacterFinder lineBreaks(text, '\n');
+    CharacterFinder tabs(text, '\t');
+    size_t firstNode = nodes.size();
+    NodeDeclaration declaration;
+
+    try {
+        while(!levels.empty()) {
+            Level & level = levels.back();
+            if(!XmlDocument::scanDeclaration(text, level.begin, &level.position, level.end, closingTags, &declaration)) {
+                /* Saving the range of the loaded text, which also marks the element as unmodified (after all nested Nodes were added) */
+                if(level.element != nullptr && sourceBegin != std::string::npos)
+                    level.element->_setSource(level.sourceBegin, level.sourceEnd);
+                levels.pop_back();
+                continue;
+            }
+            if(maxDepth > 0 && levels.size() > maxDepth)
+                throw std::invalid_argument("Error: Nodes nested deeper than the maximum depth of " + std::to_string(maxDepth));
+
+            /* Skipping ignored comments before building anything (whitespace-only text outside of tags is never declared) */
+            if(declaration.type == NodeTypeName::Comment && options.ignoreComments)
+                continue;
+            /* A tag containing only whitespace is built as an empty element */
+            bool blank = (declaration.type == NodeTypeName::TextElement && declaration.tagEnd != std::string::npos && options.ignoreWhitespace &&
+                          std::all_of(text.begin() + declaration.tagEnd, text.begin() + declaration.closingBegin, [](char c) { return std::isspace((unsigned char)c); }));
+
+            XmlElement * parent = level.element;
+            size_t nodeBegin = (sourceBegin == std::string::npos ? std::string::npos : sourceBegin + declaration.begin);
+            size_t nodeEnd = (sourceBegin == std::string::npos ? std::string::npos : sourceBegin + declaration.end + (declaration.endLine ? 1 : 0));
+
+            /* Elements with nested Nodes are built from their opening tag part, their nested Nodes being built in turn, other Nodes are built whole */
+            bool nested = (declaration.type == NodeTypeName::XmlElement && declaration.tagEnd != std::string::npos);
+            std::string tag;
+            Node * node;
+            if(nested || blank) {
+                tag = text.substr(declaration.begin, declaration.tagEnd - declaration.begin);
+                std::string nodeName = XmlDocument::getTagName(tag);
+                if(nodeName.empty())
+                    nodeName = "_default_node_name";
+                /* The element is indented if any tab is found within it */
+                bool indent = (declaration.indent || tabs.occursIn(declaration.begin, declaration.end));
+                bool singleLine = !lineBreaks.occursIn(declaration.tagEnd, declaration.closingBegin);
+                node = new(resource) XmlElement(nodeName, singleLine, declaration.endLine, indent, true, resource);
+            } else {
+                node = XmlDocument::getNodeObject(XmlDocument::getDeclarationText(text, declaration), declaration.type, resource, nodeBegin, nodeEnd);
             }
 
-        /* Plaintext content not starting with '<' (representable as TextElement) - save to buffer until new Node started */
-        } else {
-            
-            /* Saving to buffer */
-            for(; (fileContent[i] != '<') && (i < fileContent.length()); i++) {
-                buffer += fileContent[i];
+            if(node == nullptr) {
+                if(parent == nullptr)
+                    std::cerr << "WARNING: Error on loading XML node from string" << std::endl;
+                continue;
             }
-            /* Saving Node type */
-            currentNode = NodeTypeName::TextElement;
-        
-        }
 
-        /* Checking whether the buffer is only whitespace characters */
-        bool bufferBlank = true;
-        if(!buffer.empty()) {
-            for(char c : buffer) {
-                if(!std::isspace(c) && c != '\0') {
-                    bufferBlank = false;
-                    break;
-                }
+            /* Adding the Node to its parent (which takes ownership of the allocated instance) before processing it further, so that it's deleted along with it on errors */
+            if(parent != nullptr)
+                parent->_adoptChild(node);
+            else
+                nodes.push_back(node);
+
+            if(nested) {
+                XmlDocument::saveAttributes(tag, node);
+                levels.push_back({ (XmlElement *)node, declaration.tagEnd, declaration.tagEnd, declaration.closingBegin, nodeBegin, nodeEnd });
+            } else if(blank) {
+                XmlDocument::saveAttributes(tag, node);
+                if(sourceBegin != std::string::npos)
+                    node->_setSource(nodeBegin, nodeEnd);
             }
         }
-
-        /* If buffer not empty after processing, dump buffer and empty it for the next processing step */
-        if(!bufferBlank) {
-            /* Adding leading tab or trailing linebreak if any exist, to keep new line formatting more consistend with loaded documents */
-            if(fileContent[i] == '\n')
-                buffer += '\n';
-
-            /* Length is adjusted by 2 if '\0' character-based marker found in the buffer */
-            int bLength = buffer.length() - (buffer.find('\0') == std::string::npos ? 0 : 2);
-            /* Check that buffer length is smaller than current i to prevent checking -1st character when the XML tag in buffer starts the file directly, 
-               if so, check the character before the buffer for a whitespace to indicate indent
-            */
-            if(((size_t)bLength <= i) && (fileContent[i-bLength] == '\t' || fileContent[i-bLength] == ' '))
-                buffer = '\t' + buffer;
-            
-            /* Adding node to the result */
-            result.push_back({buffer, currentNode});
-            /* Resetting the detected node type to the default values */
-            currentNode = NodeTypeName::Node;
+    } catch(...) {
+        /* Releasing the Nodes built so far (nested Nodes are released by their parents) */
+        for(size_t i = firstNode; i < nodes.size(); i++) {
+            nodes[i]->_release();
         }
+        nodes.resize(firstNode);
+        throw;
+    }
+}
 
-        /* Emptying buffer if anything left over (including whitespace) */
-        if(!buffer.empty()) {
-            buffer.clear();
+void XmlDocument::resolveNodeNamespaces(Node * root, bool modifiable) {
+    /* The prefixes bound in every document */
+    std::vector<NamespaceBinding> bindings;
+    bindings.emplace_back(NameTable::intern("xml"), NameTable::intern(NAMESPACE_XML));
+    bindings.emplace_back(NameTable::intern("xmlns"), NameTable::intern(NAMESPACE_XMLNS));
+    std::vector<ExpandedName> attributeNames;
+    if(!resolveNames(root, bindings, attributeNames) || root->getNodeType() != NodeTypeName::XmlElement)
+        return;
+
+    /* Going through the nested elements with an explicit stack, each element saving the amount of bindings in scope outside of it */
+    struct Scope {
+        XmlElement * element;
+        size_t next;
+        size_t outerBindings;
+    };
+    std::vector<Scope> scopes;
+    scopes.push_back({ (XmlElement *)root, 0, 2 });
+    while(!scopes.empty()) {
+        Scope & scope = scopes.back();
+        if(scope.next >= scope.element->getChildAmount()) {
+            bindings.resize(scope.outerBindings);
+            scopes.pop_back();
+            continue;
         }
+        int index = (int)scope.next++;
+        Node * child = (modifiable ? scope.element->getChild(index) : const_cast<Node *>(((XmlElement const *)scope.element)->getChild(index)));
+        size_t outerBindings = bindings.size();
+        if(resolveNames(child, bindings, attributeNames) && child->getNodeType() == NodeTypeName::XmlElement)
+            scopes.push_back({ (XmlElement *)child, 0, outerBindings });
+        else
+            bindings.resize(outerBindings);
+    }
+}
+
+
+/* Static member functions */
 
+std::vector<std::pair<std::string, NodeTypeName>> XmlDocument::getNodes(std::string const & fileContent, std::vector<std::pair<size_t, size_t>> * ranges) {
+    std::vector<std::pair<std::string, NodeTypeName>> result;
+
+    /* Finding the closing tag parts once, so that the content of each element isn't scanned character by character */
+    std::vector<std::pair<size_t, size_t>> closingTags = XmlDocument::findClosingTags(fileContent);
+
+    /* Adding each declaration to the result, along with its range in the content (including the line break ending it) */
+    NodeDeclaration declaration;
+    size_t i = 0;
+    while(XmlDocument::scanDeclaration(fileContent, 0, &i, fileContent.length(), closingTags, &declaration)) {
+        result.push_back({ XmlDocument::getDeclarationText(fileContent, declaration), declaration.type });
+        if(ranges)
+            ranges->push_back({ declaration.begin, (declaration.endLine ? declaration.end + 1 : declaration.end) });
     }
 
     return result;
 }
 
-Node * XmlDocument::getNodeObject(std::string const & xmlNode, NodeTypeName nodeType) {
+Node * XmlDocument::getNodeObject(std::string const & xmlNode, NodeTypeName nodeType, std::pmr::memory_resource * resource, size_t sourceBegin, size_t sourceEnd, size_t maxDepth) {
 
     /* Result variable initialized to nullptr, so that nullptr is returned if anything goes wrong */
     Node * result = nullptr;
@@ -591,57 +1027,106 @@ Node * XmlDocument::getNodeObject(std::string const & xmlNode, NodeTypeName node
 
     /* Due to how the NodeTypeName enumeration is structured (alphabetical sort, first XML followed by DTD), this will be only DTD types */
     if(nodeType >= NodeTypeName::AttributeDTD) {
-        result = XmlDocument::getDTDObject(trimmedNode, nodeName, nodeType, endLine, indent);
+        result = XmlDocument::getDTDObject(trimmedNode, nodeName, nodeType, endLine, indent, resource, sourceBegin);
     } else {
-        result = XmlDocument::getXMLObject(trimmedNode, nodeName, nodeType, endLine, indent);
+        result = XmlDocument::getXMLObject(trimmedNode, nodeName, nodeType, endLine, indent, resource, sourceBegin, maxDepth);
     }
 
+    /* Saving the range of the loaded text, which also marks the Node as unmodified (after all nested Nodes were added) */
+    if(result != nullptr && sourceBegin != std::string::npos)
+        result->_setSource(sourceBegin, sourceEnd);
+
     return result;
 }
 
 
 /* Constructors */
 
-XmlDocument::XmlDocument(char const * filePath) {
-    this->filePath = filePath;
-    this->loadFromString(file_readString(filePath));
+XmlDocument::XmlDocument(char const * filePath, XmlStats * stats, std::pmr::memory_resource * resource)
+    : nodes(resource ? resource : std::pmr::get_default_resource()) {
+    this->stats = stats;
+    this->incrementalSave = false;
+    this->encoding = TextEncoding::UTF8;
+    this->maxDepth = XML_DEFAULT_MAX_DEPTH;
+    this->writeOptions = XmlWriteOptions();
+    this->parseOptions = XmlParseOptions();
+    this->load(filePath);
 }
 
-XmlDocument::XmlDocument(XmlDocument const & original) {
+XmlDocument::XmlDocument(XmlDocument const & original, std::pmr::memory_resource * resource)
+    : nodes(resource ? resource : original.getResource()) {
     /* Setting new members to original members */
     this->filePath = original.filePath;
+    this->stats = nullptr;
+    /* The copied Nodes represent the same loaded text as the original Nodes */
+    this->incrementalSave = original.incrementalSave;
+    this->source = original.source;
+    this->encoding = original.encoding;
+    this->maxDepth = original.maxDepth;
+    this->writeOptions = original.writeOptions;
+    this->parseOptions = original.parseOptions;
     /* Copying any nodes found in the original */
     if(original.getChildAmount() > 0) {
+        this->nodes.reserve(original.nodes.size());
         for(auto it : original.nodes) {
-            this->pushBackNode(*it);
+            this->nodes.push_back(it->_share(this->getResource()));
         }
     }
 }
 
-XmlDocument::XmlDocument() {
+XmlDocument::XmlDocument() : XmlDocument((std::pmr::memory_resource *)nullptr) {}
+
+XmlDocument::XmlDocument(std::pmr::memory_resource * resource) : nodes(resource ? resource : std::pmr::get_default_resource()) {
     this->filePath = "";
+    this->stats = nullptr;
+    this->incrementalSave = false;
+    this->encoding = TextEncoding::UTF8;
+    this->maxDepth = XML_DEFAULT_MAX_DEPTH;
+    this->writeOptions = XmlWriteOptions();
+    this->parseOptions = XmlParseOptions();
 }
 
 XmlDocument::~XmlDocument(void) {
-    /* Deleting any allocated child nodes */
+    /* Releasing any allocated child nodes (deallocated unless shared with a copy) */
     if(this->getChildAmount() > 0) {
         for(auto it : this->nodes) {
-            delete it;
+            it->_release();
         }
     }
 }
 
+std::pmr::memory_resource * XmlDocument::getResource(void) const {
+    return this->nodes.get_allocator().resource();
+}
+
 
 /* Get functions for internal nodes */
 
 Node * XmlDocument::getNode(int index) {
+    if((size_t)index < this->nodes.size()) {
+        this->nodes[index] = this->nodes[index]->_modifiable();
+        return this->nodes[index];
+    } else {
+        return nullptr;
+    }
+}
+
+Node * XmlDocument::getNode(char const * name, size_t offset) {
+    int index;
+    if(this->findChild(name, &index, offset))
+        return this->getNode(index);
+    else
+        return nullptr;
+}
+
+Node const * XmlDocument::getNode(int index) const {
     if((size_t)index < this->nodes.size())
         return this->nodes.at((size_t)index);
     else
         return nullptr;
 }
 
-Node * XmlDocument::getNode(char const * name, size_t offset) {
+Node const * XmlDocument::getNode(char const * name, size_t offset) const {
     int index;
     if(this->findChild(name, &index, offset))
         return this->nodes.at((size_t)index);
@@ -664,7 +1149,7 @@ size_t XmlDocument::getChildAmount(char const * name) const {
     return amount;
 }
 
-bool XmlDocument::findChild(char const * name, int * index, size_t offset) {
+bool XmlDocument::findChild(char const * name, int * index, size_t offset) const {
     /* Go through all child elements until the requested one found */
     for(size_t i = 0; i < this->getChildAmount(); i++) {
         if(this->nodes[i]->getName().compare(name) == 0) {
@@ -685,19 +1170,65 @@ bool XmlDocument::findChild(char const * name, int * index, size_t offset) {
     return false;
 }
 
+Node * XmlDocument::getNode(ExpandedName const & name, size_t offset) {
+    int index;
+    if(this->findChild(name, &index, offset))
+        return this->getNode(index);
+    else
+        return nullptr;
+}
+
+Node const * XmlDocument::getNode(ExpandedName const & name, size_t offset) const {
+    int index;
+    if(this->findChild(name, &index, offset))
+        return this->nodes.at((size_t)index);
+    else
+        return nullptr;
+}
+
+size_t XmlDocument::getChildAmount(ExpandedName const & name) const {
+    size_t amount = 0;
+    for(auto it : this->nodes) {
+        if(it->getExpandedName().matches(name))
+            amount++;
+    }
+    return amount;
+}
+
+bool XmlDocument::findChild(ExpandedName const & name, int * index, size_t offset) const {
+    /* Comparing the interned ids instead of the names */
+    for(size_t i = 0; i < this->nodes.size(); i++) {
+        if(this->nodes[i]->getExpandedName().matches(name)) {
+            if(offset > 0) {
+                offset--;
+            } else {
+                if(index)
+                    *index = i;
+                return true;
+            }
+        }
+    }
+    if(index)
+        *index = -1;
+    return false;
+}
+
 /* Member functions modifying the base internal node vector */
 
 void XmlDocument::addNode(Node const & node, int index) {
-    this->nodes.insert(this->nodes.begin() + index, node._copy());
+    /* The added copy is detached from any loaded text, so that it is printed whole */
+    Node * copy = node._copy(this->getResource());
+    copy->_setSource(std::string::npos, std::string::npos);
+    this->nodes.insert(this->nodes.begin() + index, copy);
 }
 
 void XmlDocument::pushBackNode(Node const & node) {
-    this->nodes.push_back(node._copy());
+    this->addNode(node, this->nodes.size());
 }
 
 void XmlDocument::delNode(int index) {
     if((size_t)index < this->nodes.size()) {
-        delete this->nodes.at(index);
+        this->nodes.at(index)->_release();
         this->nodes.erase(this->nodes.begin() + index);
     } else {
         throw std::invalid_argument("Error: Can't erase at out-of-bounds index");
@@ -705,7 +1236,7 @@ void XmlDocument::delNode(int index) {
 }
 
 void XmlDocument::popBackNode(void) {
-    delete this->nodes.at(this->nodes.size()-1);
+    this->nodes.at(this->nodes.size()-1)->_release();
     this->nodes.pop_back();
 }
 
@@ -713,8 +1244,10 @@ void XmlDocument::popBackNode(void) {
 /* Document manipulation functions */
 
 void XmlDocument::clear(void) {
-    /* Erasing the file path */
+    /* Erasing the file path and the loaded text */
     this->filePath = "";
+    this->source.reset();
+    this->encoding = TextEncoding::UTF8;
     /* Removing all nested nodes */
     if(this->getChildAmount() > 0) {
         while(!this->nodes.empty()) {
@@ -728,37 +1261,363 @@ void XmlDocument::load(char const * filePath) {
     this->clear();
     /* Loading Nodes from the string contained within the file */
     this->filePath = filePath;
-    this->loadFromString(file_readString(filePath));
+    auto start = std::chrono::steady_clock::now();
+    std::string xml = file_readString(filePath);
+    double readSeconds = secondsSince(start);
+    this->loadFromString(xml);
+
+    /* The read time is saved after loading from the string, which resets the load statistics */
+    if(this->stats)
+        this->stats->readSeconds = readSeconds;
 }
 
-void XmlDocument::save(char const * filePath) {
+void XmlDocument::save(char const * filePath) const {
     /* Prints the XmlDocument content into the specified file using file_writeString() */
-    file_writeString(filePath, this->print());
+    std::string xml = this->printEncoded();
+    auto start = std::chrono::steady_clock::now();
+    file_writeString(filePath, xml);
+    if(this->stats)
+        this->stats->writeSeconds = secondsSince(start);
 }
 
 void XmlDocument::loadFromString(std::string const & xml) {
-    /* Getting the XML declarations of each node */
-    std::vector<std::pair<std::string, NodeTypeName>> declarations = XmlDocument::getNodes(xml);
-    /* Getting and saving the object for each node */
-    for(std::pair<std::string, NodeTypeName> xmlNode : declarations) {
-        Node * object = XmlDocument::getNodeObject(xmlNode.first, xmlNode.second);
-        if(object != nullptr) {
-            this->pushBackNode(*object);
-            delete object;
-        } else {
-            std::cerr << "WARNING: Error on loading XML node from string" << std::endl;
-        }
+    if(this->stats) {
+        this->stats->resetLoad();
+        this->stats->bytesRead = xml.length();
+    }
+
+    /* Transcoding the text into UTF-8 (only validating UTF-8 text without a byte order mark, which is used as is) */
+    auto start = std::chrono::steady_clock::now();
+    size_t bomLength = 0;
+    this->encoding = encoding_detect(xml, &bomLength);
+    std::string transcoded;
+    if(this->encoding != TextEncoding::UTF8 || bomLength > 0) {
+        transcoded = encoding_toUtf8(xml.data() + bomLength, xml.length() - bomLength, this->encoding);
+    } else {
+        size_t errorOffset;
+        if(!encoding_validateUtf8(xml.data(), xml.length(), &errorOffset))
+            throw std::invalid_argument("Error: Invalid UTF-8 at byte " + std::to_string(errorOffset));
     }
+    std::string const & text = (this->encoding != TextEncoding::UTF8 || bomLength > 0 ? transcoded : xml);
+    if(this->stats)
+        this->stats->decodeSeconds = secondsSince(start);
+
+    /* Keeping the loaded text for incremental saving (unless any content is skipped, in which case the Nodes don't match the text) */
+    if(this->incrementalSave && !this->parseOptions.ignoreComments && !this->parseOptions.ignoreWhitespace)
+        this->source = std::make_shared<std::string const>(text);
+    else
+        this->source.reset();
+
+    /* Matching the opening and closing tag parts of all elements in the text */
+    start = std::chrono::steady_clock::now();
+    std::vector<std::pair<size_t, size_t>> closingTags = XmlDocument::findClosingTags(text);
+    if(this->stats)
+        this->stats->scanSeconds = secondsSince(start);
+    start = std::chrono::steady_clock::now();
+    /* Building the Nodes along with their ranges in the text */
+    std::vector<Node *> roots;
+    XmlDocument::buildNodes(text, 0, text.length(), closingTags, this->getResource(), 0, this->maxDepth, this->parseOptions, roots);
+    this->nodes.reserve(this->nodes.size() + roots.size());
+    for(Node * it : roots) {
+        /* The allocated Node isn't shared yet, so its namespaces are resolved in place */
+        XmlDocument::resolveNodeNamespaces(it, false);
+        /* The allocated Node is saved directly, instead of saving a copy of it */
+        this->nodes.push_back(it);
+    }
+
+    if(this->stats) {
+        this->stats->buildSeconds = secondsSince(start);
+        this->collectStats();
+    }
+}
+
+std::string XmlDocument::print(void) const {
+    std::string result;
+    auto start = std::chrono::steady_clock::now();
+
+    /* Print all nodes sequentially into a single string and return it */
+    for(auto it : this->nodes) {
+        it->printTo(result, 0, this->writeOptions);
+    }
+
+    if(this->stats) {
+        this->stats->resetSerialize();
+        this->stats->serializeSeconds = secondsSince(start);
+        this->stats->bytesWritten = result.length();
+    }
+
+    return result;
+}
+
+
+/* Encoding */
+
+TextEncoding XmlDocument::getEncoding(void) const {
+    return this->encoding;
+}
+
+TextEncoding XmlDocument::getOutputEncoding(void) const {
+    for(auto it : this->nodes) {
+        if(it->getNodeType() != NodeTypeName::XmlProlog)
+            continue;
+        TextEncoding declared;
+        std::string name = ((XmlProlog const *)it)->getEncoding();
+        if(name.empty() || !encoding_fromName(name, &declared))
+            break;
+        /* The generic "UTF-16" name doesn't specify the byte order, keeping the loaded one */
+        if(declared == TextEncoding::UTF16LE && this->encoding == TextEncoding::UTF16BE && name.find_first_of("lL") == std::string::npos)
+            declared = TextEncoding::UTF16BE;
+        return declared;
+    }
+    return this->encoding;
+}
+
+std::string XmlDocument::printEncoded(void) const {
+    std::string xml = (this->incrementalSave ? this->printIncremental() : this->print());
+    TextEncoding output = this->getOutputEncoding();
+    if(output == TextEncoding::UTF8)
+        return xml;
+    return encoding_fromUtf8(xml, output);
+}
+
+
+/* Namespaces */
+
+void XmlDocument::resolveNamespaces(void) {
+    for(size_t i = 0; i < this->nodes.size(); i++) {
+        XmlDocument::resolveNodeNamespaces(this->getNode((int)i), true);
+    }
+}
+
+
+/* Hashing */
+
+uint64_t XmlDocument::getHash(void) const {
+    /* Combining the hashes of the root-level Nodes in order */
+    uint64_t result = this->nodes.size();
+    for(auto it : this->nodes) {
+        result = Node::hashCombine(result, it->getHash());
+    }
+    return result;
+}
+
+
+/* Incremental saving */
 
+void XmlDocument::setIncrementalSave(bool incrementalSave) {
+    this->incrementalSave = incrementalSave;
 }
 
-std::string XmlDocument::print(void) {
+bool XmlDocument::getIncrementalSave(void) const {
+    return this->incrementalSave;
+}
+
+std::string XmlDocument::printIncremental(void) const {
+    /* Without any loaded text, or if reformatting the document, the whole document is printed */
+    if(!this->source || this->source->empty() || this->writeOptions.mode != XmlWriteMode::KeepOriginal)
+        return this->print();
+
     std::string result;
+    result.reserve(this->source->length());
+    size_t copied = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    this->printSourceNodes(result, nullptr, 0, this->source->length(), 0, copied);
+
+    if(this->stats) {
+        this->stats->resetSerialize();
+        this->stats->serializeSeconds = secondsSince(start);
+        this->stats->bytesWritten = result.length();
+        this->stats->bytesCopied = copied;
+    }
+
+    return result;
+}
+
+
+/* Output formatting */
+
+void XmlDocument::setWriteOptions(XmlWriteOptions const & writeOptions) {
+    this->writeOptions = writeOptions;
+}
+
+XmlWriteOptions XmlDocument::getWriteOptions(void) const {
+    return this->writeOptions;
+}
+
+
+/* Parse options */
+
+void XmlDocument::setParseOptions(XmlParseOptions const & parseOptions) {
+    this->parseOptions = parseOptions;
+}
+
+XmlParseOptions XmlDocument::getParseOptions(void) const {
+    return this->parseOptions;
+}
+
+
+/* Nesting depth */
+
+void XmlDocument::setMaxDepth(size_t maxDepth) {
+    this->maxDepth = maxDepth;
+}
+
+size_t XmlDocument::getMaxDepth(void) const {
+    return this->maxDepth;
+}
+
+
+/* Binary snapshot functions */
+
+void XmlDocument::saveBinary(char const * filePath) const {
+    std::string data = this->printBinary();
+    auto start = std::chrono::steady_clock::now();
+    file_writeString(filePath, data);
+    if(this->stats)
+        this->stats->writeSeconds = secondsSince(start);
+}
+
+void XmlDocument::loadBinary(char const * filePath) {
+    this->clear();
+    this->filePath = filePath;
+    auto start = std::chrono::steady_clock::now();
+    std::string data = file_readString(filePath);
+    double readSeconds = secondsSince(start);
+    this->loadFromBinary(data);
+
+    /* The read time is saved after loading, which resets the load statistics */
+    if(this->stats)
+        this->stats->readSeconds = readSeconds;
+}
+
+void XmlDocument::loadFromBinary(std::string const & data) {
+    /* Clearing the Nodes and the loaded text only, so that the file path set by loadBinary is kept (the snapshot has no text to save incrementally) */
+    while(!this->nodes.empty()) {
+        this->popBackNode();
+    }
+    this->source.reset();
+    if(this->stats) {
+        this->stats->resetLoad();
+        this->stats->bytesRead = data.length();
+    }
 
-    /* Print all nodes sequentially into a string and return it */
+    /* Decoding the snapshot straight into the Nodes (there is no separate scan phase) */
+    auto start = std::chrono::steady_clock::now();
+    binary_decode(data, this->nodes);
     for(auto it : this->nodes) {
-        result += it->print();
+        XmlDocument::resolveNodeNamespaces(it, false);
     }
 
+    if(this->stats) {
+        this->stats->buildSeconds = secondsSince(start);
+        this->collectStats();
+    }
+}
+
+std::string XmlDocument::printBinary(void) const {
+    auto start = std::chrono::steady_clock::now();
+    std::string result = binary_encode(this->nodes);
+    if(this->stats) {
+        this->stats->resetSerialize();
+        this->stats->serializeSeconds = secondsSince(start);
+        this->stats->bytesWritten = result.length();
+    }
     return result;
-}
\ No newline at end of file
+}
+
+
+void XmlDocument::saveImage(char const * filePath) const {
+    file_writeString(filePath, XmlImage::encode(this->nodes));
+}
+
+
+/* Freezing */
+
+std::shared_ptr<FrozenXmlDocument const> XmlDocument::freeze(void) const {
+    return std::make_shared<FrozenXmlDocument const>(*this);
+}
+
+
+/* Statistics */
+
+void XmlDocument::setStats(XmlStats * stats) {
+    this->stats = stats;
+}
+
+XmlStats * XmlDocument::getStats(void) const {
+    return this->stats;
+}
+
+
+/* DTD functions */
+
+/** Applies the attribute table to all elements in the document, walking them through the const accessors (using an explicit stack of the elements on the path to the current Node).
+ * Only the elements receiving a default are accessed as modifiable, through the path from the document, so only the shared Nodes on that path are copied
+*/
+static bool applyAttributeTable(XmlDocument * document, AttributeTable & table, std::vector<std::string> * errors, bool applyDefaults) {
+    /* The elements on the path, with the index of the next child to process (the first frame being the document itself) */
+    struct Frame {
+        Node const * element;
+        size_t next;
+    };
+    std::vector<Frame> stack = { { nullptr, 0 } };
+    XmlDocument const * constDocument = document;
+
+    bool valid = true;
+    while(!stack.empty()) {
+        Frame & frame = stack.back();
+        size_t amount = (frame.element == nullptr ? constDocument->getChildAmount() : ((XmlElement const *)frame.element)->getChildAmount());
+        if(frame.next >= amount) {
+            stack.pop_back();
+            continue;
+        }
+        size_t index = frame.next++;
+        Node const * current = (frame.element == nullptr ? constDocument->getNode((int)index) : ((XmlElement const *)frame.element)->getChild((int)index));
+
+        /* Only elements, Text Elements with a shown tag and generic Nodes can have attributes */
+        NodeTypeName type = current->getNodeType();
+        if(type == NodeTypeName::XmlElement || type == NodeTypeName::Node || (type == NodeTypeName::TextElement && ((TextElement const *)current)->getShowTag())) {
+            if(applyDefaults && table.needsDefaults(current)) {
+                /* Accessing the path from the document as modifiable (the position of each Node being the index before the next one of its parent's frame) */
+                Node * modifiable = document->getNode((int)(stack[0].next - 1));
+                for(size_t i = 1; i < stack.size(); i++) {
+                    stack[i].element = modifiable;
+                    modifiable = ((XmlElement *)modifiable)->getChild((int)(stack[i].next - 1));
+                }
+                valid = table.apply(modifiable, errors, true) && valid;
+                current = modifiable;
+            } else {
+                valid = table.check(current, errors) && valid;
+            }
+        }
+
+        if(type == NodeTypeName::XmlElement)
+            stack.push_back({ current, 0 });
+    }
+    return valid;
+}
+
+bool XmlDocument::validateAttributes(std::vector<std::string> * errors, bool applyDefaults) {
+    /* Getting the Doctype DTD of the document, nothing to validate if there isn't any */
+    DoctypeDTD * doctype = nullptr;
+    for(auto it : this->nodes) {
+        if(it->getNodeType() == NodeTypeName::DoctypeDTD) {
+            doctype = (DoctypeDTD *)it;
+            break;
+        }
+    }
+    if(doctype == nullptr)
+        return true;
+
+    /* Building the per-element table of declarations once */
+    AttributeTable table(*doctype);
+    if(table.empty())
+        return true;
+
+    /* Applying the table to all elements in the document - only the elements receiving a default (and the path to them) are accessed as modifiable */
+    bool valid = applyAttributeTable(this, table, errors, applyDefaults);
+
+    /* Checking that all collected ID references point to existing IDs */
+    return table.checkReferences(errors) && valid;
+}
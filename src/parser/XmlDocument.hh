@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 #include <utility>
+#include <memory>
+#include <memory_resource>
 
 #include "XML/Node.hh"
 #include "XML/Comment.hh"
@@ -23,7 +25,29 @@
 #include "XML/DTD/DoctypeDTD.hh"
 #include "XML/DTD/ElementDTD.hh"
 #include "XML/DTD/EntityDTD.hh"
+#include "XML/DTD/AttributeTable.hh"
 #include "file_util.hh"
+#include "binary_util.hh"
+#include "encoding_util.hh"
+#include "XmlImage.hh"
+#include "XmlStats.hh"
+
+/** The default maximum nesting depth of loaded documents (see @ref XmlDocument::setMaxDepth) */
+#define XML_DEFAULT_MAX_DEPTH 1000000
+
+/**
+ * @struct XmlParseOptions
+ * @author Linux-Tech-Tips
+ * @brief Options for loading XML, see @ref XmlDocument::setParseOptions
+*/
+struct XmlParseOptions {
+    /** Whether comments are skipped, without creating Comment Nodes */
+    bool ignoreComments = false;
+    /** Whether whitespace-only text content is skipped, elements containing only whitespace being loaded as empty elements */
+    bool ignoreWhitespace = false;
+};
+
+class FrozenXmlDocument;
 
 /** 
  * @class XmlDocument
@@ -33,6 +57,8 @@
  * The XML Document class, containing an object-oriented representation of an XML document,
  * with the capability to process a text XML declaration into objects, and the objects back into an XML declaration.
  * Formatting is not guaranteed to be kept exactly.
+ * All Nodes of the document are allocated from the memory resource specified on construction (the default resource if none specified), 
+ * so that e.g. a monotonic buffer can be used for short-lived documents, or a pool for long-lived ones. The resource must outlive the document.
 */
 class XmlDocument {
 
@@ -42,8 +68,40 @@ class XmlDocument {
 
         /** The path to the XML file */
         std::string filePath;
-        /** All root-level XML Nodes contained within the document (nested Nodes are contained within the root-level nodes) */
-        std::vector<Node *> nodes;
+        /** All root-level XML Nodes contained within the document (nested Nodes are contained within the root-level nodes), allocated from the document's memory resource */
+        std::pmr::vector<Node *> nodes;
+        /** The statistics filled in when loading, printing and saving (or null pointer if statistics are not desired) */
+        XmlStats * stats;
+        /** Whether the loaded text is kept, so that saving only prints the modified Nodes (see @ref setIncrementalSave) */
+        bool incrementalSave;
+        /** The text the document was loaded from, transcoded into UTF-8 (null pointer unless loaded with incremental saving enabled), shared with copies of the document */
+        std::shared_ptr<std::string const> source;
+        /** The encoding of the text the document was loaded from */
+        TextEncoding encoding;
+        /** The maximum nesting depth of loaded documents (see @ref setMaxDepth) */
+        size_t maxDepth;
+        /** The formatting of the printed and saved XML (see @ref setWriteOptions) */
+        XmlWriteOptions writeOptions;
+        /** The content skipped when loading (see @ref setParseOptions) */
+        XmlParseOptions parseOptions;
+
+        /** A Node declaration found in the text by @ref scanDeclaration */
+        struct NodeDeclaration {
+            /** The assumed type of the Node */
+            NodeTypeName type;
+            /** The position of the first character of the declaration */
+            size_t begin;
+            /** The position after the last character of the declaration (not including the line break ending it) */
+            size_t end;
+            /** The position after the opening tag part, if the declaration has content between two tag parts (std::string::npos otherwise) */
+            size_t tagEnd;
+            /** The position of the closing tag part, if the declaration has content between two tag parts (the end of the scanned text if it isn't closed) */
+            size_t closingBegin;
+            /** Whether the declaration ends the line it's on */
+            bool endLine;
+            /** Whether the declaration is indented (preceded by a tab or space, and ending its line) */
+            bool indent;
+        };
 
         /* Protected member functions */
 
@@ -55,6 +113,35 @@ class XmlDocument {
         */
         static std::string getNextTagPart(std::string const & content, size_t * i);
 
+        /** Internal auxiliary function which returns the position after the end of the XML tag part started by the '<' at the index i in the content (at most end) */
+        static size_t findTagPartEnd(std::string const & content, size_t i, size_t end);
+
+        /** Internal auxiliary function which goes through all tags in the text once, and returns the position of the opening tag part of each element with content,
+         * paired with the position of its closing tag part (std::string::npos if it isn't closed), sorted by the opening position.
+         * A closing tag closes the innermost open element with the same name, so that the content of an element can be skipped without scanning it again.
+        */
+        static std::vector<std::pair<size_t, size_t>> findClosingTags(std::string const & text);
+
+        /** Internal auxiliary function which finds the next Node declaration in the range of the text between begin and end, starting at the position i
+         * (which is moved after the declaration), returning false if there are no more declarations in the range
+         *  @param closingTags the positions of the closing tag parts, as returned by @ref findClosingTags for the text
+        */
+        static bool scanDeclaration(std::string const & text, size_t begin, size_t * i, size_t end, std::vector<std::pair<size_t, size_t>> const & closingTags, NodeDeclaration * declaration);
+
+        /** Internal auxiliary function which returns the Node declaration in the format returned by @ref getNodes */
+        static std::string getDeclarationText(std::string const & text, NodeDeclaration const & declaration);
+
+        /** Internal function which builds the Nodes declared in the range of the text between begin and end, along with all their nested Nodes, and appends them to nodes.
+         * Nested elements are built using an explicit stack, so that the depth of the document isn't limited by the size of the thread's stack,
+         * and the content of each element is only scanned once, so that the time taken doesn't grow with the depth of the document.
+         * Throws std::invalid_argument if the Nodes are nested deeper than maxDepth (0 for no limit), deleting the Nodes built so far.
+         *  @param closingTags the positions of the closing tag parts, as returned by @ref findClosingTags for the text
+         *  @param sourceBegin the position of the text in the loaded text, used to save the ranges of the Nodes (std::string::npos if unknown)
+         *  @param options the declarations skipped before any Node is built for them
+        */
+        static void buildNodes(std::string const & text, size_t begin, size_t end, std::vector<std::pair<size_t, size_t>> const & closingTags, std::pmr::memory_resource * resource,
+                               size_t sourceBegin, size_t maxDepth, XmlParseOptions const & options, std::vector<Node *> & nodes);
+
         /** Internal auxiliary function which returns the name of an XML tag based on the XML text declaration of the tag
          * - returns empty string if name either not found, or if node type doesn't display name in the tag
          * - special behavior: for Comment type, the name is the first word of the comment, if any found
@@ -67,11 +154,46 @@ class XmlDocument {
         */
         static void saveAttributes(std::string const & tag, Node * nodeObject, int nameEndIndex = -1);
 
-        /** Internal function, returns a Node * instance of an XML element, if the passed xmlNode and nodeType correspond to an XML Node (undefined behavior otherwise) */
-        static Node * getXMLObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent);
+        /** Internal function which adds all loaded Nodes to the statistics, if any are set */
+        void collectStats(void);
+
+        /** Internal auxiliary function which appends the text between two Nodes of the loaded text to the result
+         * - if the text is only whitespace, it is appended whole; otherwise it contains removed Nodes, and only the whitespace around them which isn't on their lines is kept
+         * - returns the amount of appended bytes
+        */
+        static size_t appendGap(std::string & result, std::string const & source, size_t begin, size_t end);
+
+        /** Internal function which appends the given Nodes (the root-level Nodes if parent is null pointer, otherwise the nested Nodes of the parent) to the result,
+         * copying the unmodified Nodes and the text between them from the given range of the loaded text (the modified nested Nodes are printed using an explicit stack)
+         *  @param copied the amount of bytes copied from the loaded text is added to this counter
+        */
+        void printSourceNodes(std::string & result, Node const * parent, size_t begin, size_t end, int indentLevel, size_t & copied) const;
+
+        /** Internal function which appends the given Node to the result, copying it from the loaded text if unmodified, and printing it otherwise.
+         * Returns true if only the part of the Node before its nested Nodes was appended, in which case the nested Nodes between contentBegin and contentEnd
+         * have to be appended next (indented by contentIndent), followed by the rest of the Node after contentEnd
+         *  @param copied the amount of bytes copied from the loaded text is added to this counter
+        */
+        bool printSourceNode(std::string & result, Node const * node, int indentLevel, size_t & copied, size_t * contentBegin, size_t * contentEnd, int * contentIndent) const;
+
+        /** Internal function, returns a Node * instance of an XML element, if the passed xmlNode and nodeType correspond to an XML Node (undefined behavior otherwise)
+         *  @param sourceBegin the position of trimmedNode in the loaded text, used to save the ranges of nested Nodes (std::string::npos if unknown)
+         *  @param maxDepth the maximum nesting depth of the Node (the Node having the depth 1), 0 for no limit
+         *  @throws std::invalid_argument if the nested Nodes are nested deeper than maxDepth
+        */
+        static Node * getXMLObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent, std::pmr::memory_resource * resource, size_t sourceBegin,
+                                   size_t maxDepth = XML_DEFAULT_MAX_DEPTH);
 
-        /** Internal function, returns a Node * instance of a DTD element, if the passed xmlNode and nodeType correspond to a DTD Node (undefined behavior otherwise) */
-        static Node * getDTDObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent);
+        /** Internal function, returns a Node * instance of a DTD element, if the passed xmlNode and nodeType correspond to a DTD Node (undefined behavior otherwise)
+         *  @param sourceBegin the position of trimmedNode in the loaded text, used to save the ranges of nested Nodes (std::string::npos if unknown)
+        */
+        static Node * getDTDObject(std::string const & trimmedNode, std::string const & nodeName, NodeTypeName nodeType, bool endLine, bool indent, std::pmr::memory_resource * resource, size_t sourceBegin);
+
+        /** Internal function which resolves the namespaces and local names of the given root-level Node and all its nested elements (see @ref resolveNamespaces)
+         *  @param modifiable if true, the nested elements are requested as modifiable (copying shared ones), otherwise they are modified in place, 
+         *  which is only allowed for Nodes which were just built and aren't shared yet
+        */
+        static void resolveNodeNamespaces(Node * root, bool modifiable);
 
     public:
 
@@ -80,43 +202,70 @@ class XmlDocument {
         /** Returns an std::vector containing pairs with parsed XML file content 
          * - each pair consists of an XML declaration of a root XML node and the assumed NodeTypeName of the node
          * - if the XML declaration consists of content surrounded by 2 tag parts (opening and closing), the character '\0' is inserted to differentiate the content
+         *  @param ranges optionally specify a list into which the range of each declaration in fileContent is saved, as the position of its first character
+         *  and the position after its last character, including the line break ending it, if any (pass nullptr to not save ranges)
          */
-        static std::vector<std::pair<std::string, NodeTypeName>> getNodes(std::string const & fileContent);
+        static std::vector<std::pair<std::string, NodeTypeName>> getNodes(std::string const & fileContent, std::vector<std::pair<size_t, size_t>> * ranges = nullptr);
 
         /** Returns an allocated Node * instance of the given inheriting nodeType, based on the processed XML node declaration (must be deleted after usage)
          *  @param xmlNode the plaintext XML declaration of a node
          *  @param nodeType the expected type of the Node declared within xmlNode
+         *  @param resource the memory resource to allocate the Node and all its nested Nodes from (the default resource if null pointer)
+         *  @param sourceBegin optionally specify the range of xmlNode in the loaded text (as saved by getNodes), which is saved into the Node and its nested Nodes for incremental saving
+         *  @param maxDepth the maximum nesting depth of the Node (the Node having the depth 1), 0 for no limit
+         *  @throws std::invalid_argument if the nested Nodes are nested deeper than maxDepth
         */
-        static Node * getNodeObject(std::string const & xmlNode, NodeTypeName nodeType);
+        static Node * getNodeObject(std::string const & xmlNode, NodeTypeName nodeType, std::pmr::memory_resource * resource = nullptr, size_t sourceBegin = std::string::npos, size_t sourceEnd = std::string::npos,
+                                    size_t maxDepth = XML_DEFAULT_MAX_DEPTH);
 
 
         /* Constructors */
 
         /** Constructor - loads an XML file into the XmlDocument instance
          *  @param filePath the path to an XML file on the device to load
+         *  @param stats optionally specify statistics to be filled in when loading, printing and saving (see @ref setStats)
+         *  @param resource the memory resource to allocate all Nodes of the document from (the default resource if null pointer)
         */
-        XmlDocument(char const * filePath);
+        XmlDocument(char const * filePath, XmlStats * stats = nullptr, std::pmr::memory_resource * resource = nullptr);
 
-        /** Copy constructor (allocating new Node memory for a new copy) */
-        XmlDocument(XmlDocument const & original);
+        /** Copy constructor - the Nodes are shared with the original until modified, so copying takes time proportional only to the amount of root-level Nodes,
+         * and modifying the copy only copies the modified Nodes and their parents (the statistics are not shared with the copy)
+         *  @param resource the memory resource to allocate the copied Nodes from (the resource of the original if null pointer; Nodes are only shared if the resources match)
+        */
+        XmlDocument(XmlDocument const & original, std::pmr::memory_resource * resource = nullptr);
 
         /** Empty constructor - creating an empty Xml Document */
         XmlDocument();
 
+        /** Empty constructor - creating an empty Xml Document, with all Nodes allocated from the given memory resource (the default resource if null pointer) */
+        explicit XmlDocument(std::pmr::memory_resource * resource);
+
         ~XmlDocument(void);
 
+        /** Returns the memory resource all Nodes of the document are allocated from */
+        std::pmr::memory_resource * getResource(void) const;
+
 
         /* Get functions for internal nodes */
 
-        /** Returns the pointer to the internally saved Node at the specified index */
+        /** Returns the pointer to the internally saved Node at the specified index
+         * (if the Node is shared with a copy of the document, it is copied first, so that it can be modified without affecting the copy)
+        */
         Node * getNode(int index);
 
         /** Returns the pointer to the first (or n-th) internally saved Node with the given name 
+         * (if the Node is shared with a copy of the document, it is copied first, so that it can be modified without affecting the copy)
          *  @param name the name of the node to look for
          *  @param offset which node with the given name to find, if more exist (leave default or 0 to get the first found instance)
         */
         Node * getNode(char const * name, size_t offset = 0);
 
+        /** Returns a read-only pointer to the internally saved Node at the specified index, without copying a shared Node */
+        Node const * getNode(int index) const;
+
+        /** Returns a read-only pointer to the first (or n-th) internally saved Node with the given name, without copying a shared Node */
+        Node const * getNode(char const * name, size_t offset = 0) const;
+
         /** Gets the amount of root-level child Nodes contained within the XML document */
         size_t getChildAmount(void) const;
 
@@ -124,7 +273,21 @@ class XmlDocument {
         size_t getChildAmount(char const * name) const;
 
         /** Returns whether the first (or n-th if defined by offset) child Node exists, and saves its index (if index not nullptr) */
-        bool findChild(char const * name, int * index = nullptr, size_t offset = 0);
+        bool findChild(char const * name, int * index = nullptr, size_t offset = 0) const;
+
+        /** Returns the pointer to the first (or n-th) root-level Node with the given resolved namespace and local name (see @ref resolveNamespaces),
+         * copying a shared Node first (see @ref getNode(char const *, size_t))
+        */
+        Node * getNode(ExpandedName const & name, size_t offset = 0);
+
+        /** Returns a read-only pointer to the first (or n-th) root-level Node with the given resolved namespace and local name, without copying a shared Node */
+        Node const * getNode(ExpandedName const & name, size_t offset = 0) const;
+
+        /** Gets the amount of root-level Nodes with the given resolved namespace and local name in the XML document */
+        size_t getChildAmount(ExpandedName const & name) const;
+
+        /** Returns whether the first (or n-th if defined by offset) root-level Node with the given resolved namespace and local name exists, and saves its index (if index not nullptr) */
+        bool findChild(ExpandedName const & name, int * index = nullptr, size_t offset = 0) const;
 
         /* Member functions modifying the base internal node vector */
 
@@ -146,19 +309,164 @@ class XmlDocument {
         /** Removes all content from the Document */
         void clear(void);
 
-        /** Loads the XML document on the given path into this XmlDocument instance (replacing old content, if any) */
+        /** Loads the XML document on the given path into this XmlDocument instance (replacing old content, if any), decompressing a gzip-compressed file (see @ref file_readString) */
         void load(char const * filePath);
 
-        /** Saves the current XmlDocument to the given path */
-        void save(char const * filePath);
+        /** Saves the current XmlDocument to the given path (printed incrementally if enabled, see @ref setIncrementalSave), in the output encoding (see @ref getOutputEncoding) */
+        void save(char const * filePath) const;
 
         /** Loads the given string into the XmlDocument instance.
-         * Used internally to load the document from a file, but can be used when loading from a different source than a file as well
+         * Used internally to load the document from a file, but can be used when loading from a different source than a file as well.
+         * The encoding of the text is detected (see @ref encoding_detect), and the text is transcoded into UTF-8 (or validated, if already UTF-8) before processing.
+         * Throws std::invalid_argument if the text isn't valid in its encoding, or if the encoding isn't supported.
         */
         void loadFromString(std::string const & xml);
 
-        /** Returns the complete XML string of the loaded document */
-        std::string print(void);
+        /** Returns the complete XML string of the loaded document (in UTF-8), formatted as set by the write options (see @ref setWriteOptions) */
+        std::string print(void) const;
+
+
+        /* Encoding */
+
+        /** Returns the encoding of the text the document was loaded from (UTF-8 if not loaded from text) */
+        TextEncoding getEncoding(void) const;
+
+        /** Returns the encoding the document is saved in - the encoding declared in the XML prolog, if it declares a supported one,
+         * and otherwise the encoding the document was loaded from (a declared "UTF-16" keeps the byte order of loaded UTF-16 text)
+        */
+        TextEncoding getOutputEncoding(void) const;
+
+        /** Returns the complete XML text of the document as saved - printed incrementally if enabled, and encoded in the output encoding (see @ref getOutputEncoding).
+         * Throws std::invalid_argument if the document contains characters which can't be represented in the output encoding.
+        */
+        std::string printEncoded(void) const;
+
+
+        /* Namespaces */
+
+        /** Resolves the namespace and local name of all elements and their attributes (see @ref Node::getExpandedName), using the "xmlns" declarations in scope.
+         * Done automatically when loading - only needs to be called after elements are renamed, added with a different scope, or attributes added or deleted.
+         * Unprefixed attributes are in no namespace, and names with a prefix which isn't declared stay unresolved.
+         * The names are interned in the @ref NameTable, so that Nodes can be matched by comparing two integers (see @ref findChild(ExpandedName const &, int *, size_t) const).
+         * All elements are requested as modifiable, so Nodes shared with copies of the document are copied.
+        */
+        void resolveNamespaces(void);
+
+
+        /* Hashing */
+
+        /** Returns a 64-bit hash of the content of all Nodes in the document (see @ref Node::getHash), so that documents with equal hashes can be assumed to have equal content.
+         * The hashes of unmodified Nodes are cached, so hashing a document again after modifying it only recomputes the hashes of the modified Nodes and their parents.
+        */
+        uint64_t getHash(void) const;
+
+
+        /* Incremental saving */
+
+        /** Sets whether the text of documents loaded from now on is kept, so that saving only prints the Nodes modified since loading.
+         * The unmodified Nodes and the text between them are copied from the loaded text unchanged (keeping their original formatting),
+         * so the time to save a large document is proportional to the size of the modifications, rather than to the size of the document.
+         * Keeping the loaded text takes as much memory as the text itself. Disabled by default.
+        */
+        void setIncrementalSave(bool incrementalSave);
+
+        /** Returns whether incremental saving is enabled */
+        bool getIncrementalSave(void) const;
+
+        /** Returns the complete XML string of the document, copying the unmodified Nodes from the loaded text
+         * (the same as @ref print if the document wasn't loaded from text with incremental saving enabled, or if the write options don't keep the original formatting)
+        */
+        std::string printIncremental(void) const;
+
+
+        /* Output formatting */
+
+        /** Sets the formatting of the XML printed and saved from now on (see @ref XmlWriteOptions) - keeping the formatting of each Node by default,
+         * printing minified XML without any formatting whitespace, or indenting each Node by a fixed amount of spaces.
+         * Minified XML is printed in a single pass over the Nodes, only appending the names, attributes and content of the Nodes.
+         * Incremental saving only copies the loaded text while keeping the original formatting.
+        */
+        void setWriteOptions(XmlWriteOptions const & writeOptions);
+
+        /** Returns the formatting of the printed and saved XML */
+        XmlWriteOptions getWriteOptions(void) const;
+
+
+        /* Parse options */
+
+        /** Sets the content skipped when loading documents from now on (see @ref XmlParseOptions) - comments, and whitespace-only text content.
+         * The skipped declarations are dropped while the text is scanned, before any Node is created for them, so no memory is allocated for them.
+         * Nothing is skipped by default. The text of documents loaded while skipping any content isn't kept for incremental saving,
+         * since the Nodes no longer match the loaded text.
+        */
+        void setParseOptions(XmlParseOptions const & parseOptions);
+
+        /** Returns the content skipped when loading documents */
+        XmlParseOptions getParseOptions(void) const;
+
+
+        /* Nesting depth */
+
+        /** Sets the maximum nesting depth of documents loaded from now on (root-level Nodes having the depth 1), 0 for no limit (the default is XML_DEFAULT_MAX_DEPTH).
+         * Loading, copying, printing and deleting documents doesn't recurse, so any depth is handled, but the memory used while loading grows with the depth.
+         * Loading a document nested deeper than the maximum depth throws std::invalid_argument.
+        */
+        void setMaxDepth(size_t maxDepth);
+
+        /** Returns the maximum nesting depth of loaded documents */
+        size_t getMaxDepth(void) const;
+
+
+        /* Binary snapshot functions */
+
+        /** Saves the current XmlDocument to the given path as a binary snapshot (see @ref binary_util.hh), which loads much faster than XML text */
+        void saveBinary(char const * filePath) const;
+
+        /** Loads a binary snapshot on the given path into this XmlDocument instance (replacing old content, if any).
+         * The loaded document prints exactly the same as the document the snapshot was saved from.
+         * Throws std::invalid_argument if the file isn't a valid binary snapshot of a supported version.
+        */
+        void loadBinary(char const * filePath);
+
+        /** Loads the given binary snapshot into the XmlDocument instance (replacing old content, if any) */
+        void loadFromBinary(std::string const & data);
+
+        /** Returns the binary snapshot of the loaded document */
+        std::string printBinary(void) const;
+
+        /** Saves the current XmlDocument to the given path as a read-only image, which can be memory-mapped and queried in place using @ref XmlImage */
+        void saveImage(char const * filePath) const;
+
+
+        /* Freezing */
+
+        /** Returns an immutable snapshot of the document, which any amount of threads can read at the same time without locking
+         * (see @ref FrozenXmlDocument, declared in FrozenXmlDocument.hh). The Nodes are shared with the snapshot until modified.
+        */
+        std::shared_ptr<FrozenXmlDocument const> freeze(void) const;
+
+
+        /* Statistics */
+
+        /** Sets the statistics to be filled in by load, loadFromString, print and save (pass nullptr to stop collecting statistics).
+         * The statistics are owned by the caller, and must exist for as long as they are set.
+        */
+        void setStats(XmlStats * stats);
+
+        /** Returns the currently set statistics (or null pointer if none set) */
+        XmlStats * getStats(void) const;
+
+
+        /* DTD functions */
+
+        /** Applies the attribute declarations of the document's Doctype DTD (if any) to all elements in the document.
+         * The declarations are gathered into an @ref AttributeTable once, so each element only needs a single lookup.
+         * Missing attributes with a default or fixed value are filled in, and the declared attribute types are checked.
+         *  @param errors optionally specify a list into which a message is saved for each problem found (pass nullptr to not save messages)
+         *  @param applyDefaults if true, missing attributes with a default or fixed value are added to the elements
+         *  @return whether all elements in the document match the attribute declarations
+        */
+        bool validateAttributes(std::vector<std::string> * errors = nullptr, bool applyDefaults = true);
 
 };
 
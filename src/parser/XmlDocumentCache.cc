@@ -0,0 +1,159 @@
+#include "XmlDocumentCache.hh"
+
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+/* File identity */
+
+bool XmlDocumentCache::FileId::operator==(FileId const & other) const {
+    return this->device == other.device && this->inode == other.inode && this->size == other.size && this->modified == other.modified;
+}
+
+
+/* Protected member functions */
+
+bool XmlDocumentCache::getFileId(char const * filePath, FileId * id) {
+    struct stat info;
+    if(stat(filePath, &info) != 0)
+        return false;
+    id->device = (uint64_t)info.st_dev;
+    id->inode = (uint64_t)info.st_ino;
+    id->size = (uint64_t)info.st_size;
+    id->modified = (int64_t)info.st_mtim.tv_sec * 1000000000 + (int64_t)info.st_mtim.tv_nsec;
+    return true;
+}
+
+void XmlDocumentCache::eraseLocked(std::unordered_map<std::string, Entry>::iterator entry) {
+    /* Threads waiting for the document hold their own copy of the future, so they still get the result */
+    this->used -= entry->second.cost;
+    this->usage.erase(entry->second.usage);
+    this->entries.erase(entry);
+}
+
+void XmlDocumentCache::evictLocked(void) {
+    while(this->used > this->budget && this->usage.size() > 1)
+        this->eraseLocked(this->entries.find(this->usage.back()));
+}
+
+
+/* Constructor */
+
+XmlDocumentCache::XmlDocumentCache(size_t budget) : budget(budget), used(0), nextNumber(0), hits(0), misses(0) {}
+
+XmlDocumentCache & XmlDocumentCache::global(void) {
+    static XmlDocumentCache cache;
+    return cache;
+}
+
+
+/* Cache access */
+
+std::shared_ptr<FrozenXmlDocument const> XmlDocumentCache::get(char const * filePath) {
+    /* Checking the file before loading it, so that a change made while loading is found by the next check */
+    FileId id;
+    if(!getFileId(filePath, &id))
+        throw std::invalid_argument("Error: Cannot access the file to load");
+
+    std::promise<std::shared_ptr<FrozenXmlDocument const>> loaded;
+    std::shared_future<std::shared_ptr<FrozenXmlDocument const>> document;
+    bool load = false;
+    uint64_t number = 0;
+    {
+        std::lock_guard<std::mutex> guard(this->lock);
+        auto entry = this->entries.find(filePath);
+        if(entry != this->entries.end() && entry->second.id == id) {
+            /* Cached and unchanged, marking the entry as the most recently used */
+            ++this->hits;
+            this->usage.splice(this->usage.begin(), this->usage, entry->second.usage);
+            document = entry->second.document;
+        } else {
+            /* Not cached or changed, adding an entry which other threads wait on while this thread loads the file (charged the size of the file until loaded) */
+            if(entry != this->entries.end())
+                this->eraseLocked(entry);
+            ++this->misses;
+            number = this->nextNumber++;
+            document = loaded.get_future().share();
+            this->usage.push_front(filePath);
+            this->entries.emplace(filePath, Entry{id, document, (size_t)id.size, number, this->usage.begin()});
+            this->used += (size_t)id.size;
+            this->evictLocked();
+            load = true;
+        }
+    }
+
+    if(load) {
+        /* Loading outside of the lock, so that loading a large file doesn't block getting other files */
+        try {
+            XmlStats stats;
+            XmlDocument xml(filePath, &stats);
+            loaded.set_value(xml.freeze());
+
+            /* Charging the memory held by the loaded Nodes instead of the file size, which can be far smaller (e.g. for a compressed file) */
+            std::lock_guard<std::mutex> guard(this->lock);
+            auto entry = this->entries.find(filePath);
+            if(entry != this->entries.end() && entry->second.number == number) {
+                this->used -= entry->second.cost;
+                entry->second.cost = stats.estimatedAllocatedBytes;
+                this->used += entry->second.cost;
+                this->evictLocked();
+            }
+        } catch(...) {
+            /* Passing the exception to all waiting threads, and removing the entry so that the next get tries again */
+            loaded.set_exception(std::current_exception());
+            std::lock_guard<std::mutex> guard(this->lock);
+            auto entry = this->entries.find(filePath);
+            if(entry != this->entries.end() && entry->second.number == number)
+                this->eraseLocked(entry);
+        }
+    }
+    return document.get();
+}
+
+void XmlDocumentCache::erase(char const * filePath) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    auto entry = this->entries.find(filePath);
+    if(entry != this->entries.end())
+        this->eraseLocked(entry);
+}
+
+void XmlDocumentCache::clear(void) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->entries.clear();
+    this->usage.clear();
+    this->used = 0;
+}
+
+
+/* Budget and usage */
+
+void XmlDocumentCache::setBudget(size_t budget) {
+    std::lock_guard<std::mutex> guard(this->lock);
+    this->budget = budget;
+    this->evictLocked();
+}
+
+size_t XmlDocumentCache::getBudget(void) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->budget;
+}
+
+size_t XmlDocumentCache::getUsed(void) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->used;
+}
+
+size_t XmlDocumentCache::getEntryAmount(void) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->entries.size();
+}
+
+uint64_t XmlDocumentCache::getHits(void) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->hits;
+}
+
+uint64_t XmlDocumentCache::getMisses(void) const {
+    std::lock_guard<std::mutex> guard(this->lock);
+    return this->misses;
+}
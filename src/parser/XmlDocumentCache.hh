@@ -0,0 +1,149 @@
+/**
+ * @file XmlDocumentCache.hh
+ * @author Linux-Tech-Tips
+ * @brief XML Document cache header
+ *
+ * The header declaring the XML Document cache, which shares the parsed documents of files loaded by multiple components,
+ * so that each file is only read and parsed again once it changes
+ */
+#ifndef XML_DOC_CACHE_H
+#define XML_DOC_CACHE_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+
+#include "XmlDocument.hh"
+#include "FrozenXmlDocument.hh"
+
+/** The default memory budget of a document cache (in bytes of the cached documents) */
+#define XML_CACHE_DEFAULT_BUDGET (64u * 1024u * 1024u)
+
+/**
+ * @class XmlDocumentCache
+ * @author Linux-Tech-Tips
+ * @brief XML Document cache
+ *
+ * A thread-safe cache of loaded XML files, keyed by the path of the file. Each file is parsed once,
+ * and the parsed document is shared as an immutable snapshot (see @ref FrozenXmlDocument) by everyone getting it from the cache.
+ *
+ * A cached document is only returned while the file is unchanged - each @ref get checks the modification time, size and inode of the file,
+ * and loads the file again if any of them differ (e.g. the file was rewritten, or replaced by renaming another file over it).
+ * If multiple threads get the same file at the same time, the file is only loaded once, and the other threads wait for the result.
+ *
+ * The cache keeps the documents within a memory budget, each document being charged the memory held by its Nodes (estimated once loaded, see @ref XmlStats),
+ * or the size of its file while it's being loaded - once the budget is exceeded,
+ * the least recently used documents are evicted. Evicted documents stay valid for as long as anyone holds their snapshot.
+ * A single process-wide cache is available using @ref global, but separate caches can be created as well.
+*/
+class XmlDocumentCache {
+
+    protected:
+        /** The identity of a version of a file, as returned by stat */
+        struct FileId {
+            /** The device containing the file */
+            uint64_t device;
+            /** The inode of the file */
+            uint64_t inode;
+            /** The size of the file in bytes */
+            uint64_t size;
+            /** The modification time of the file in nanoseconds */
+            int64_t modified;
+
+            bool operator==(FileId const & other) const;
+        };
+
+        /** A cached document */
+        struct Entry {
+            /** The identity of the file the document was loaded from */
+            FileId id;
+            /** The document, ready once the file is loaded (so that other threads can wait for the thread loading it) */
+            std::shared_future<std::shared_ptr<FrozenXmlDocument const>> document;
+            /** The memory cost of the document, counted towards the budget */
+            size_t cost;
+            /** Unique number of the entry, used to check whether the entry is still cached after loading */
+            uint64_t number;
+            /** The position of the path of the entry in the usage order */
+            std::list<std::string>::iterator usage;
+        };
+
+        /** Lock held while accessing the entries (but not while loading files) */
+        mutable std::mutex lock;
+        /** The cached documents by their path */
+        std::unordered_map<std::string, Entry> entries;
+        /** The paths of the cached documents, from the most recently used to the least recently used */
+        std::list<std::string> usage;
+        /** The maximum total cost of the cached documents */
+        size_t budget;
+        /** The total cost of the cached documents */
+        size_t used;
+        /** The number given to the next entry */
+        uint64_t nextNumber;
+        /** The amount of times a cached document was returned */
+        uint64_t hits;
+        /** The amount of times a file was loaded */
+        uint64_t misses;
+
+        /** Internal function which saves the identity of the file on the given path into id, returning false if the file doesn't exist */
+        static bool getFileId(char const * filePath, FileId * id);
+
+        /** Internal function which removes the given entry (the lock must be held) */
+        void eraseLocked(std::unordered_map<std::string, Entry>::iterator entry);
+
+        /** Internal function which evicts the least recently used entries until the budget is met, keeping the most recently used one (the lock must be held) */
+        void evictLocked(void);
+
+    public:
+        /** Constructor - creates an empty cache with the given memory budget (in bytes of the cached documents) */
+        explicit XmlDocumentCache(size_t budget = XML_CACHE_DEFAULT_BUDGET);
+
+        /** Copying is not supported, since the cache is shared by its users */
+        XmlDocumentCache(XmlDocumentCache const & original) = delete;
+        /** Copying is not supported, since the cache is shared by its users */
+        XmlDocumentCache & operator=(XmlDocumentCache const & original) = delete;
+
+        /** Returns the process-wide document cache */
+        static XmlDocumentCache & global(void);
+
+
+        /* Cache access */
+
+        /** Returns the document loaded from the file on the given path, loading the file only if not cached or changed since cached.
+         * Throws std::invalid_argument if the file doesn't exist, or any exception thrown while loading the file.
+        */
+        std::shared_ptr<FrozenXmlDocument const> get(char const * filePath);
+
+        /** Removes the document loaded from the given path from the cache (if cached) */
+        void erase(char const * filePath);
+
+        /** Removes all documents from the cache */
+        void clear(void);
+
+
+        /* Budget and usage */
+
+        /** Sets the memory budget (in bytes of the cached documents), evicting the least recently used documents if exceeded */
+        void setBudget(size_t budget);
+
+        /** Returns the memory budget (in bytes of the cached documents) */
+        size_t getBudget(void) const;
+
+        /** Returns the total memory charged for the cached documents, in bytes */
+        size_t getUsed(void) const;
+
+        /** Returns the amount of cached documents */
+        size_t getEntryAmount(void) const;
+
+        /** Returns the amount of times a cached document was returned by get */
+        uint64_t getHits(void) const;
+
+        /** Returns the amount of times a file was loaded by get */
+        uint64_t getMisses(void) const;
+
+};
+
+#endif /* XML_DOC_CACHE_H */
@@ -0,0 +1,62 @@
+#include "XmlDocumentStore.hh"
+
+/* Protected member functions */
+
+uint64_t XmlDocumentStore::publishLocked(XmlDocument const & document) {
+    /* Only the writer holding the lock replaces the current version, so the previous version can't change before the next one is stored */
+    std::shared_ptr<Version const> previous = std::atomic_load(&this->current);
+    std::shared_ptr<Version const> next = std::make_shared<Version const>(Version{previous->number + 1, document.freeze()});
+    std::atomic_store(&this->current, next);
+    return next->number;
+}
+
+
+/* Constructors */
+
+XmlDocumentStore::XmlDocumentStore(void) : XmlDocumentStore(XmlDocument()) {}
+
+XmlDocumentStore::XmlDocumentStore(XmlDocument const & document) {
+    this->current = std::make_shared<Version const>(Version{0, document.freeze()});
+}
+
+
+/* Reading */
+
+std::shared_ptr<FrozenXmlDocument const> XmlDocumentStore::snapshot(uint64_t * version) const {
+    std::shared_ptr<Version const> published = std::atomic_load(&this->current);
+    if(version)
+        *version = published->number;
+    return published->document;
+}
+
+uint64_t XmlDocumentStore::getVersion(void) const {
+    return std::atomic_load(&this->current)->number;
+}
+
+void XmlDocumentStore::save(char const * filePath) const {
+    /* The snapshot is immutable, so it can be saved for as long as needed while new versions are published */
+    this->snapshot()->save(filePath);
+}
+
+
+/* Writing */
+
+uint64_t XmlDocumentStore::modify(std::function<void(XmlDocument &)> const & modification) {
+    std::lock_guard<std::mutex> lock(this->writer);
+    /* Modifying a copy sharing the Nodes with the current version, so only the modified Nodes are copied */
+    XmlDocument draft = this->snapshot()->thaw();
+    modification(draft);
+    return this->publishLocked(draft);
+}
+
+uint64_t XmlDocumentStore::publish(XmlDocument const & document) {
+    std::lock_guard<std::mutex> lock(this->writer);
+    return this->publishLocked(document);
+}
+
+uint64_t XmlDocumentStore::load(char const * filePath) {
+    /* Loading outside of the lock, so that a slow load doesn't block other modifications */
+    XmlDocument document;
+    document.load(filePath);
+    return this->publish(document);
+}
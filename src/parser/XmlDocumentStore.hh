@@ -0,0 +1,100 @@
+/**
+ * @file XmlDocumentStore.hh
+ * @author Linux-Tech-Tips
+ * @brief Versioned XML Document store header
+ *
+ * The header declaring the XML Document store, which keeps versions of a document as immutable snapshots,
+ * so that readers never wait for the writer (or for a slow save), and the writer never waits for readers
+ */
+#ifndef XML_DOC_STORE_H
+#define XML_DOC_STORE_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+#include "XmlDocument.hh"
+#include "FrozenXmlDocument.hh"
+
+/**
+ * @class XmlDocumentStore
+ * @author Linux-Tech-Tips
+ * @brief Versioned XML Document store
+ *
+ * A thread-safe store of a single XML Document, with multi-version concurrency control -
+ * each modification creates a new version of the document, which is published atomically as an immutable snapshot (see @ref FrozenXmlDocument).
+ *
+ * Readers get the current snapshot using @ref snapshot, and can keep reading it for as long as they want without any locking,
+ * even while newer versions are published. An old version is deleted once the last reader holding its snapshot releases it.
+ * Modifications are serialized (only one writer modifies the document at a time), but never wait for readers.
+ * Since the Nodes are shared between the versions until modified, each version only takes memory for the Nodes modified in it.
+*/
+class XmlDocumentStore {
+
+    protected:
+        /** A published version of the document */
+        struct Version {
+            /** The number of the version, increased by each publication */
+            uint64_t number;
+            /** The snapshot of the document */
+            std::shared_ptr<FrozenXmlDocument const> document;
+        };
+
+        /** The current version (only accessed using std::atomic_load and std::atomic_store, so that readers don't need to lock) */
+        std::shared_ptr<Version const> current;
+        /** Lock held by the writer while creating and publishing a new version */
+        std::mutex writer;
+
+        /** Internal function which publishes the given document as the version following the current one (the writer lock must be held) */
+        uint64_t publishLocked(XmlDocument const & document);
+
+    public:
+        /** Constructor - creates a store containing an empty document as version 0 */
+        XmlDocumentStore(void);
+
+        /** Constructor - creates a store containing a snapshot of the given document as version 0 */
+        explicit XmlDocumentStore(XmlDocument const & document);
+
+        /** Copying is not supported, since readers and the writer refer to a single store */
+        XmlDocumentStore(XmlDocumentStore const & original) = delete;
+        /** Copying is not supported, since readers and the writer refer to a single store */
+        XmlDocumentStore & operator=(XmlDocumentStore const & original) = delete;
+
+
+        /* Reading */
+
+        /** Returns the snapshot of the current version of the document, which stays valid and unchanged for as long as it's held
+         *  @param version optionally specify a variable into which the number of the returned version is saved (pass nullptr to not save the version)
+        */
+        std::shared_ptr<FrozenXmlDocument const> snapshot(uint64_t * version = nullptr) const;
+
+        /** Returns the number of the current version of the document */
+        uint64_t getVersion(void) const;
+
+        /** Saves the current version of the document to the given path, without blocking readers or the writer while saving */
+        void save(char const * filePath) const;
+
+
+        /* Writing */
+
+        /** Applies the given modification to a copy of the current version, and publishes the result as a new version.
+         * If the modification throws an exception, no version is published and the exception is passed on.
+         *  @return the number of the published version
+        */
+        uint64_t modify(std::function<void(XmlDocument &)> const & modification);
+
+        /** Publishes a snapshot of the given document as a new version, replacing the current document
+         *  @return the number of the published version
+        */
+        uint64_t publish(XmlDocument const & document);
+
+        /** Loads the XML document on the given path, and publishes it as a new version
+         *  @return the number of the published version
+        */
+        uint64_t load(char const * filePath);
+
+};
+
+#endif /* XML_DOC_STORE_H */
@@ -0,0 +1,479 @@
+#include "XmlImage.hh"
+
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "XML/Comment.hh"
+#include "XML/TextElement.hh"
+#include "XML/XmlElement.hh"
+#include "XML/DTD/DoctypeDTD.hh"
+#include "binary_util.hh"
+
+/** The value of the byte order marker, read differently by hosts of a different byte order */
+#define IMAGE_BYTE_ORDER 0x01020304u
+
+
+/* Internal auxiliary structures */
+
+/** The header at the start of each image */
+struct ImageHeader {
+    /** The magic bytes (IMAGE_MAGIC) */
+    char magic[4];
+    /** The format version (IMAGE_VERSION) */
+    uint32_t version;
+    /** The byte order marker (IMAGE_BYTE_ORDER) */
+    uint32_t byteOrder;
+    /** The amount of root-level Nodes (the first Nodes of the Node table) */
+    uint32_t rootAmount;
+    /** The amount of all Nodes */
+    uint32_t nodeAmount;
+    /** The amount of all attributes */
+    uint32_t attributeAmount;
+    /** The offset of the Node table */
+    uint32_t nodeOffset;
+    /** The offset of the attribute table */
+    uint32_t attributeOffset;
+    /** The offset of the string data */
+    uint32_t stringOffset;
+    /** The size of the string data */
+    uint32_t stringSize;
+};
+
+/** The record of a single Node in the Node table */
+struct ImageNodeRecord {
+    /** The NodeTypeName of the Node */
+    uint8_t type;
+    /** The settings of the Node (BINARY_FLAG_*, see @ref binary_getFlags) */
+    uint8_t flags;
+    /** Unused, keeps the following fields aligned */
+    uint16_t reserved;
+    /** The offset of the name within the string data */
+    uint32_t nameOffset;
+    /** The length of the name */
+    uint32_t nameLength;
+    /** The offset of the text content within the string data */
+    uint32_t contentOffset;
+    /** The length of the text content (0 for Nodes without content) */
+    uint32_t contentLength;
+    /** The index of the first nested Node in the Node table */
+    uint32_t firstChild;
+    /** The amount of nested Nodes, which follow the first nested Node in the Node table */
+    uint32_t childAmount;
+    /** The index of the first attribute in the attribute table */
+    uint32_t firstAttribute;
+    /** The amount of attributes, which follow the first attribute in the attribute table */
+    uint32_t attributeAmount;
+};
+
+/** The record of a single attribute in the attribute table */
+struct ImageAttributeRecord {
+    /** The offset of the attribute name within the string data */
+    uint32_t keyOffset;
+    /** The length of the attribute name */
+    uint32_t keyLength;
+    /** The offset of the attribute value within the string data */
+    uint32_t valueOffset;
+    /** The length of the attribute value */
+    uint32_t valueLength;
+};
+
+/* The records are copied into the image as they are, so their layout must not contain any padding */
+static_assert(sizeof(ImageHeader) == 40, "Unexpected XML image header layout");
+static_assert(sizeof(ImageNodeRecord) == 36, "Unexpected XML image Node record layout");
+static_assert(sizeof(ImageAttributeRecord) == 16, "Unexpected XML image attribute record layout");
+
+/** The string data built while encoding, storing each unique string only once */
+struct ImageStringTable {
+    /** All unique strings, in the order of their offsets (a deque, so that the strings never move and can be referenced by the offset map) */
+    std::deque<std::string> strings;
+    /** The offset of each string in the string data */
+    std::unordered_map<std::string_view, uint32_t> offsets;
+    /** The current size of the string data */
+    size_t size = 0;
+
+    /** Returns the offset of the given string, adding it to the string data if not present yet */
+    uint32_t add(std::string_view value) {
+        auto it = this->offsets.find(value);
+        if(it != this->offsets.end())
+            return it->second;
+        if(this->size + value.length() > UINT32_MAX)
+            throw std::invalid_argument("Error: Document too large for an XML image");
+        uint32_t offset = (uint32_t)this->size;
+        this->strings.emplace_back(value);
+        this->offsets.emplace(this->strings.back(), offset);
+        this->size += value.length();
+        return offset;
+    }
+};
+
+
+/* Internal auxiliary functions */
+
+/** Returns the given size rounded up to a multiple of 4, so that the tables following it are aligned */
+static size_t image_align(size_t size) {
+    return (size + 3) & ~((size_t)3);
+}
+
+/* === ImageNode === */
+
+ImageNode::ImageNode(XmlImage const * image, uint32_t index) {
+    this->image = image;
+    this->index = index;
+}
+
+bool ImageNode::isValid(void) const {
+    return (this->image != nullptr);
+}
+
+
+/* General */
+
+NodeTypeName ImageNode::getNodeType(void) const {
+    return (NodeTypeName)((ImageNodeRecord const *)this->image->_nodeRecord(this->index))->type;
+}
+
+std::string_view ImageNode::getName(void) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+    return this->image->_string(record->nameOffset, record->nameLength);
+}
+
+bool ImageNode::getEndLine(void) const {
+    return (((ImageNodeRecord const *)this->image->_nodeRecord(this->index))->flags & BINARY_FLAG_END_LINE);
+}
+
+bool ImageNode::getIndent(void) const {
+    return (((ImageNodeRecord const *)this->image->_nodeRecord(this->index))->flags & BINARY_FLAG_INDENT);
+}
+
+std::string_view ImageNode::getContent(void) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+    return this->image->_string(record->contentOffset, record->contentLength);
+}
+
+
+/* Attributes */
+
+std::string_view ImageNode::getAttribute(std::string_view name) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+
+    /* Binary search, since the attributes of each Node are sorted by name */
+    uint32_t low = 0;
+    uint32_t high = record->attributeAmount;
+    while(low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        ImageAttributeRecord const * attribute = (ImageAttributeRecord const *)this->image->_attributeRecord(record->firstAttribute + middle);
+        int comparison = this->image->_string(attribute->keyOffset, attribute->keyLength).compare(name);
+        if(comparison == 0)
+            return this->image->_string(attribute->valueOffset, attribute->valueLength);
+        else if(comparison < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return std::string_view();
+}
+
+bool ImageNode::hasAttribute(std::string_view name) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+    uint32_t low = 0;
+    uint32_t high = record->attributeAmount;
+    while(low < high) {
+        uint32_t middle = low + (high - low) / 2;
+        ImageAttributeRecord const * attribute = (ImageAttributeRecord const *)this->image->_attributeRecord(record->firstAttribute + middle);
+        int comparison = this->image->_string(attribute->keyOffset, attribute->keyLength).compare(name);
+        if(comparison == 0)
+            return true;
+        else if(comparison < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return false;
+}
+
+size_t ImageNode::getAttributeNumber(void) const {
+    return ((ImageNodeRecord const *)this->image->_nodeRecord(this->index))->attributeAmount;
+}
+
+std::string_view ImageNode::getAttributeName(size_t index) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+    if(index >= record->attributeAmount)
+        throw std::invalid_argument("Error: Attribute index out of bounds");
+    ImageAttributeRecord const * attribute = (ImageAttributeRecord const *)this->image->_attributeRecord(record->firstAttribute + (uint32_t)index);
+    return this->image->_string(attribute->keyOffset, attribute->keyLength);
+}
+
+std::string_view ImageNode::getAttributeValue(size_t index) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+    if(index >= record->attributeAmount)
+        throw std::invalid_argument("Error: Attribute index out of bounds");
+    ImageAttributeRecord const * attribute = (ImageAttributeRecord const *)this->image->_attributeRecord(record->firstAttribute + (uint32_t)index);
+    return this->image->_string(attribute->valueOffset, attribute->valueLength);
+}
+
+
+/* Nested Nodes */
+
+size_t ImageNode::getChildAmount(void) const {
+    return ((ImageNodeRecord const *)this->image->_nodeRecord(this->index))->childAmount;
+}
+
+size_t ImageNode::getChildAmount(char const * childName) const {
+    size_t amount = 0;
+    for(size_t i = 0; i < this->getChildAmount(); i++) {
+        if(this->getChild(i).getName().compare(childName) == 0)
+            amount++;
+    }
+    return amount;
+}
+
+ImageNode ImageNode::getChild(size_t index) const {
+    ImageNodeRecord const * record = (ImageNodeRecord const *)this->image->_nodeRecord(this->index);
+    if(index < record->childAmount)
+        return ImageNode(this->image, record->firstChild + (uint32_t)index);
+    else
+        return ImageNode();
+}
+
+ImageNode ImageNode::getChild(char const * childName, size_t offset) const {
+    int index;
+    if(this->findChild(childName, &index, offset))
+        return this->getChild((size_t)index);
+    else
+        return ImageNode();
+}
+
+bool ImageNode::findChild(char const * nameToFind, int * index, size_t offset) const {
+    /* Checks all nested Nodes */
+    for(size_t i = 0; i < this->getChildAmount(); i++) {
+        if(this->getChild(i).getName().compare(nameToFind) == 0) {
+            if(offset > 0) {
+                offset--;
+            } else {
+                if(index)
+                    *index = i;
+                return true;
+            }
+        }
+    }
+    if(index)
+        *index = -1;
+    return false;
+}
+
+
+/* === XmlImage === */
+
+/* Constructor/Destructor */
+
+XmlImage::XmlImage(char const * filePath) {
+    /* Mapping the whole file (the descriptor isn't needed once the file is mapped) */
+    int fd = open(filePath, O_RDONLY);
+    if(fd < 0)
+        throw std::invalid_argument("Error: Can't open XML image file");
+    struct stat status;
+    if(fstat(fd, &status) != 0 || (size_t)status.st_size < sizeof(ImageHeader)) {
+        close(fd);
+        throw std::invalid_argument("Error: Not an XML image");
+    }
+    this->size = (size_t)status.st_size;
+    void * mapping = mmap(nullptr, this->size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapping == MAP_FAILED)
+        throw std::invalid_argument("Error: Can't map XML image file");
+    this->data = (char const *)mapping;
+
+    /* Checking the header, and that all tables lie within the image */
+    ImageHeader const * header = (ImageHeader const *)this->data;
+    char const * error = nullptr;
+    if(std::memcmp(header->magic, IMAGE_MAGIC, 4) != 0)
+        error = "Error: Not an XML image";
+    else if(header->version != IMAGE_VERSION)
+        error = "Error: Unsupported XML image version";
+    else if(header->byteOrder != IMAGE_BYTE_ORDER)
+        error = "Error: XML image written on a host of a different byte order";
+    else if(header->nodeOffset % 4 != 0 || header->attributeOffset % 4 != 0 || header->rootAmount > header->nodeAmount
+            || (size_t)header->nodeOffset + (size_t)header->nodeAmount * sizeof(ImageNodeRecord) > this->size
+            || (size_t)header->attributeOffset + (size_t)header->attributeAmount * sizeof(ImageAttributeRecord) > this->size
+            || (size_t)header->stringOffset + (size_t)header->stringSize > this->size)
+        error = "Error: Corrupted XML image";
+    if(error) {
+        munmap(mapping, this->size);
+        throw std::invalid_argument(error);
+    }
+
+    this->rootAmount = header->rootAmount;
+    this->nodeAmount = header->nodeAmount;
+    this->attributeAmount = header->attributeAmount;
+    this->nodeOffset = header->nodeOffset;
+    this->attributeOffset = header->attributeOffset;
+    this->stringOffset = header->stringOffset;
+    this->stringSize = header->stringSize;
+}
+
+XmlImage::~XmlImage(void) {
+    munmap((void *)this->data, this->size);
+}
+
+
+/* Get functions for root-level Nodes */
+
+ImageNode XmlImage::getNode(size_t index) const {
+    if(index < this->rootAmount)
+        return ImageNode(this, (uint32_t)index);
+    else
+        return ImageNode();
+}
+
+ImageNode XmlImage::getNode(char const * name, size_t offset) const {
+    int index;
+    if(this->findChild(name, &index, offset))
+        return ImageNode(this, (uint32_t)index);
+    else
+        return ImageNode();
+}
+
+size_t XmlImage::getChildAmount(void) const {
+    return this->rootAmount;
+}
+
+bool XmlImage::findChild(char const * name, int * index, size_t offset) const {
+    for(size_t i = 0; i < this->rootAmount; i++) {
+        if(this->getNode(i).getName().compare(name) == 0) {
+            if(offset > 0) {
+                offset--;
+            } else {
+                if(index)
+                    *index = i;
+                return true;
+            }
+        }
+    }
+    if(index)
+        *index = -1;
+    return false;
+}
+
+size_t XmlImage::getNodeAmount(void) const {
+    return this->nodeAmount;
+}
+
+
+/* Image encoding */
+
+std::string XmlImage::encode(std::pmr::vector<Node *> const & nodes) {
+    /* Ordering the Nodes breadth-first, so that the nested Nodes of each Node are contiguous */
+    std::vector<Node const *> order(nodes.begin(), nodes.end());
+    std::vector<ImageNodeRecord> records;
+    std::vector<ImageAttributeRecord> attributes;
+    ImageStringTable strings;
+
+    for(size_t i = 0; i < order.size(); i++) {
+        Node const * node = order[i];
+        ImageNodeRecord record = {};
+        record.type = (uint8_t)node->getNodeType();
+        record.flags = binary_getFlags(node);
+        std::string name = node->getName();
+        record.nameOffset = strings.add(name);
+        record.nameLength = (uint32_t)name.length();
+
+        std::string content;
+        if(node->getNodeType() == NodeTypeName::Comment)
+            content = ((Comment const *)node)->getContent();
+        else if(node->getNodeType() == NodeTypeName::TextElement)
+            content = ((TextElement const *)node)->getContent();
+        record.contentOffset = strings.add(content);
+        record.contentLength = (uint32_t)content.length();
+
+        /* Nested Nodes are appended to the order, right after the nested Nodes of all previous Nodes */
+        record.firstChild = (uint32_t)order.size();
+        if(node->getNodeType() == NodeTypeName::XmlElement) {
+            XmlElement const * element = (XmlElement const *)node;
+            record.childAmount = (uint32_t)element->getChildAmount();
+            for(size_t j = 0; j < element->getChildAmount(); j++) {
+                order.push_back(element->getChild(j));
+            }
+        } else if(node->getNodeType() == NodeTypeName::DoctypeDTD) {
+            DoctypeDTD const * doctype = (DoctypeDTD const *)node;
+            record.childAmount = (uint32_t)doctype->getChildAmount();
+            for(size_t j = 0; j < doctype->getChildAmount(); j++) {
+                order.push_back(doctype->getChild(j));
+            }
+        }
+        if(order.size() > UINT32_MAX)
+            throw std::invalid_argument("Error: Document too large for an XML image");
+
+        /* Attributes, already sorted by name in the attribute map */
+        record.firstAttribute = (uint32_t)attributes.size();
+        record.attributeAmount = (uint32_t)node->getAttributeNumber();
+        for(auto const & it : node->getAttributes()) {
+            ImageAttributeRecord attribute;
+            attribute.keyOffset = strings.add(it.first);
+            attribute.keyLength = (uint32_t)it.first.length();
+            attribute.valueOffset = strings.add(it.second);
+            attribute.valueLength = (uint32_t)it.second.length();
+            attributes.push_back(attribute);
+        }
+
+        records.push_back(record);
+    }
+
+    /* Laying out the header, the tables and the string data */
+    ImageHeader header;
+    std::memcpy(header.magic, IMAGE_MAGIC, 4);
+    header.version = IMAGE_VERSION;
+    header.byteOrder = IMAGE_BYTE_ORDER;
+    header.rootAmount = (uint32_t)nodes.size();
+    header.nodeAmount = (uint32_t)records.size();
+    header.attributeAmount = (uint32_t)attributes.size();
+    size_t nodeOffset = image_align(sizeof(ImageHeader));
+    size_t attributeOffset = image_align(nodeOffset + records.size() * sizeof(ImageNodeRecord));
+    size_t stringOffset = image_align(attributeOffset + attributes.size() * sizeof(ImageAttributeRecord));
+    if(stringOffset + strings.size > UINT32_MAX)
+        throw std::invalid_argument("Error: Document too large for an XML image");
+    header.nodeOffset = (uint32_t)nodeOffset;
+    header.attributeOffset = (uint32_t)attributeOffset;
+    header.stringOffset = (uint32_t)stringOffset;
+    header.stringSize = (uint32_t)strings.size;
+
+    std::string result(stringOffset + strings.size, '\0');
+    std::memcpy(&result[0], &header, sizeof(ImageHeader));
+    if(!records.empty())
+        std::memcpy(&result[nodeOffset], records.data(), records.size() * sizeof(ImageNodeRecord));
+    if(!attributes.empty())
+        std::memcpy(&result[attributeOffset], attributes.data(), attributes.size() * sizeof(ImageAttributeRecord));
+    size_t position = stringOffset;
+    for(std::string const & it : strings.strings) {
+        std::memcpy(&result[position], it.data(), it.length());
+        position += it.length();
+    }
+    return result;
+}
+
+
+/* Internal access functions */
+
+void const * XmlImage::_nodeRecord(uint32_t index) const {
+    if(index >= this->nodeAmount)
+        throw std::invalid_argument("Error: Corrupted XML image");
+    return this->data + this->nodeOffset + (size_t)index * sizeof(ImageNodeRecord);
+}
+
+void const * XmlImage::_attributeRecord(uint32_t index) const {
+    if(index >= this->attributeAmount)
+        throw std::invalid_argument("Error: Corrupted XML image");
+    return this->data + this->attributeOffset + (size_t)index * sizeof(ImageAttributeRecord);
+}
+
+std::string_view XmlImage::_string(uint32_t offset, uint32_t length) const {
+    if((size_t)offset + (size_t)length > this->stringSize)
+        throw std::invalid_argument("Error: Corrupted XML image");
+    return std::string_view(this->data + this->stringOffset + offset, length);
+}
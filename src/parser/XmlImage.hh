@@ -0,0 +1,195 @@
+/**
+ * @file XmlImage.hh
+ * @author Linux-Tech-Tips
+ * @brief Memory-mapped read-only XML document image
+ *
+ * The header declaring the XML Image class, a read-only document stored in a file laid out so that it can be memory-mapped
+ * and queried in place, without parsing or deserializing anything. All returned strings are views into the mapping.
+ *
+ * The image consists of (all integers are unsigned 32-bit, in the byte order of the host which wrote the image):
+ *  - the header - the magic bytes "XMLI", the format version, a byte order marker, the amounts and offsets of the tables below
+ *  - the Node table - a fixed-size record for each Node, in breadth-first order, so that the nested Nodes of each Node are contiguous
+ *    (the root-level Nodes come first), each referencing its name, content, nested Nodes and attributes
+ *  - the attribute table - a fixed-size record for each attribute, the attributes of each Node contiguous and sorted by name
+ *  - the string data - all unique names, attribute keys and values and contents, referenced by offset and length
+ */
+#ifndef XML_IMAGE_H
+#define XML_IMAGE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+
+#include "XML/Node.hh"
+
+/** The magic bytes at the start of each XML image */
+#define IMAGE_MAGIC "XMLI"
+/** The current version of the XML image format, increased whenever the layout changes */
+#define IMAGE_VERSION 1
+
+class XmlImage;
+
+/**
+ * @class ImageNode
+ * @author Linux-Tech-Tips
+ * @brief Node of an XML Image
+ *
+ * A lightweight view of a single Node within an @ref XmlImage, with accessors resembling those of @ref Node and @ref XmlElement.
+ * Instances are cheap to copy, and are only valid for as long as the image they were taken from exists.
+ * A Node which wasn't found is represented by an invalid ImageNode (see @ref isValid), whose accessors must not be used.
+*/
+class ImageNode {
+
+    protected:
+        /** The image containing the Node */
+        XmlImage const * image;
+        /** The index of the Node in the Node table of the image */
+        uint32_t index;
+
+    public:
+        /** Constructor - used internally by @ref XmlImage, creates an invalid Node if the image is null pointer */
+        ImageNode(XmlImage const * image = nullptr, uint32_t index = 0);
+
+        /** Returns whether the Node exists (is false for the result of a failed lookup) */
+        bool isValid(void) const;
+
+
+        /* General */
+
+        /** Returns the type of the Node */
+        NodeTypeName getNodeType(void) const;
+        /** Returns the name of the Node */
+        std::string_view getName(void) const;
+        /** Returns whether the Node ends the line it's on */
+        bool getEndLine(void) const;
+        /** Returns whether the Node is indented if nested */
+        bool getIndent(void) const;
+        /** Returns the text content of the Node (only Comment and TextElement Nodes have content, the content of other Nodes is empty) */
+        std::string_view getContent(void) const;
+
+
+        /* Attributes */
+
+        /** Returns the value of the attribute with the given name (or an empty string if the attribute doesn't exist) */
+        std::string_view getAttribute(std::string_view name) const;
+        /** Returns whether the attribute with the given name exists */
+        bool hasAttribute(std::string_view name) const;
+        /** Returns the amount of attributes of the Node */
+        size_t getAttributeNumber(void) const;
+        /** Returns the name of the attribute at the given position (attributes are sorted by name) */
+        std::string_view getAttributeName(size_t index) const;
+        /** Returns the value of the attribute at the given position (attributes are sorted by name) */
+        std::string_view getAttributeValue(size_t index) const;
+
+
+        /* Nested Nodes */
+
+        /** Returns the amount of directly nested Nodes (only XmlElement and DoctypeDTD Nodes can have nested Nodes) */
+        size_t getChildAmount(void) const;
+        /** Returns the amount of directly nested Nodes with the given name */
+        size_t getChildAmount(char const * childName) const;
+        /** Returns the nested Node at the given position (or an invalid Node if out of bounds) */
+        ImageNode getChild(size_t index) const;
+        /** Returns the n-th nested Node with the given name (or an invalid Node if not found)
+         *  @param offset which found named child to get (leave default or 0 for the first child; the amount of found named children specified by offset is skipped)
+        */
+        ImageNode getChild(char const * childName, size_t offset = 0) const;
+        /** Returns whether an n-th nested Node with the given name exists and saves its index
+         *  @param index the saved index; if index < 0, the Node was not found (pass nullptr to not save index)
+         *  @param offset which named child to look for (leave default or 0 for the first child; the amount of found named children specified by offset is skipped)
+        */
+        bool findChild(char const * nameToFind, int * index = nullptr, size_t offset = 0) const;
+
+};
+
+/**
+ * @class XmlImage
+ * @author Linux-Tech-Tips
+ * @brief Memory-mapped read-only XML document
+ *
+ * A read-only XML document, memory-mapped from an image file written using @ref XmlDocument::saveImage.
+ * Opening an image only maps the file and checks the header, so it takes the same time regardless of the document size,
+ * and the pages of the image are shared by all processes mapping the same file.
+ * Throws std::invalid_argument if the file can't be mapped, or isn't a valid image.
+ * The image file must not be modified while mapped.
+*/
+class XmlImage {
+
+    protected:
+        /** The start of the mapped image */
+        char const * data;
+        /** The size of the mapped image, in bytes */
+        size_t size;
+
+        /** The amount of root-level Nodes */
+        uint32_t rootAmount;
+        /** The amount of all Nodes */
+        uint32_t nodeAmount;
+        /** The amount of all attributes */
+        uint32_t attributeAmount;
+        /** The offset of the Node table */
+        uint32_t nodeOffset;
+        /** The offset of the attribute table */
+        uint32_t attributeOffset;
+        /** The offset of the string data */
+        uint32_t stringOffset;
+        /** The size of the string data */
+        uint32_t stringSize;
+
+    public:
+        /** Constructor - maps the image file on the given path */
+        XmlImage(char const * filePath);
+
+        /** Copying is not supported, since the image owns the mapping */
+        XmlImage(XmlImage const & original) = delete;
+        /** Copying is not supported, since the image owns the mapping */
+        XmlImage & operator=(XmlImage const & original) = delete;
+
+        ~XmlImage(void);
+
+
+        /* Get functions for root-level Nodes */
+
+        /** Returns the root-level Node at the specified index (or an invalid Node if out of bounds) */
+        ImageNode getNode(size_t index) const;
+
+        /** Returns the first (or n-th) root-level Node with the given name (or an invalid Node if not found)
+         *  @param offset which node with the given name to find, if more exist (leave default or 0 to get the first found instance)
+        */
+        ImageNode getNode(char const * name, size_t offset = 0) const;
+
+        /** Gets the amount of root-level Nodes contained within the image */
+        size_t getChildAmount(void) const;
+
+        /** Returns whether the first (or n-th if defined by offset) root-level Node with the given name exists, and saves its index (if index not nullptr) */
+        bool findChild(char const * name, int * index = nullptr, size_t offset = 0) const;
+
+        /** Returns the total amount of Nodes in the image, including all nested Nodes */
+        size_t getNodeAmount(void) const;
+
+
+        /* Image encoding */
+
+        /** Returns the image of the given root-level Nodes, including all their nested Nodes, to be saved into a file and mapped
+         * Throws std::invalid_argument if the document is too large for the image format (4 GiB of string data, or 2^32 Nodes)
+        */
+        static std::string encode(std::pmr::vector<Node *> const & nodes);
+
+
+        /* Internal access functions, used by ImageNode */
+
+        /** Returns a pointer to the record of the Node at the given index (throws std::invalid_argument if out of bounds) */
+        void const * _nodeRecord(uint32_t index) const;
+
+        /** Returns a pointer to the record of the attribute at the given index (throws std::invalid_argument if out of bounds) */
+        void const * _attributeRecord(uint32_t index) const;
+
+        /** Returns a view of the string at the given offset within the string data (throws std::invalid_argument if out of bounds) */
+        std::string_view _string(uint32_t offset, uint32_t length) const;
+
+};
+
+#endif /* XML_IMAGE_H */
@@ -0,0 +1,184 @@
+#include "XmlStats.hh"
+
+#include "XML/Comment.hh"
+#include "XML/ProcessingInstruction.hh"
+#include "XML/TextElement.hh"
+#include "XML/XmlElement.hh"
+#include "XML/XmlProlog.hh"
+#include "XML/DTD/DTD.hh"
+#include "XML/DTD/AttributeDTD.hh"
+#include "XML/DTD/DoctypeDTD.hh"
+#include "XML/DTD/ElementDTD.hh"
+#include "XML/DTD/EntityDTD.hh"
+
+/* Internal auxiliary functions */
+
+/** Adds the estimated heap allocation of a string of the given length to the statistics (short strings are stored within the string object) */
+static void stats_addString(XmlStats * stats, size_t length) {
+    if(length > 15) {
+        stats->estimatedAllocations++;
+        stats->estimatedAllocatedBytes += length + 1;
+    }
+}
+
+
+/* Member functions */
+
+void XmlStats::resetLoad(void) {
+    this->bytesRead = 0;
+    this->readSeconds = 0.0;
+    this->decodeSeconds = 0.0;
+    this->scanSeconds = 0.0;
+    this->buildSeconds = 0.0;
+    for(size_t i = 0; i < XML_STATS_NODE_TYPES; i++) {
+        this->nodeCounts[i] = 0;
+    }
+    this->maxDepth = 0;
+    this->estimatedAllocations = 0;
+    this->estimatedAllocatedBytes = 0;
+    this->largestText = 0;
+}
+
+void XmlStats::resetSerialize(void) {
+    this->bytesWritten = 0;
+    this->bytesCopied = 0;
+    this->serializeSeconds = 0.0;
+    this->writeSeconds = 0.0;
+}
+
+size_t XmlStats::getNodeCount(NodeTypeName type) const {
+    return this->nodeCounts[(size_t)type];
+}
+
+size_t XmlStats::getNodeCount(void) const {
+    size_t result = 0;
+    for(size_t i = 0; i < XML_STATS_NODE_TYPES; i++) {
+        result += this->nodeCounts[i];
+    }
+    return result;
+}
+
+void XmlStats::addNode(Node const * node, size_t depth) {
+    this->nodeCounts[(size_t)node->getNodeType()]++;
+    if(depth > this->maxDepth)
+        this->maxDepth = depth;
+
+    /* The Node object itself, and the type-specific content */
+    size_t objectSize = sizeof(Node);
+    switch(node->getNodeType()) {
+        case NodeTypeName::Comment:
+            objectSize = sizeof(Comment);
+            stats_addString(this, ((Comment *)node)->getContent().length());
+            if(((Comment *)node)->getContent().length() > this->largestText)
+                this->largestText = ((Comment *)node)->getContent().length();
+            break;
+        case NodeTypeName::ProcessingInstruction:
+            objectSize = sizeof(ProcessingInstruction);
+            break;
+        case NodeTypeName::TextElement:
+            objectSize = sizeof(TextElement);
+            stats_addString(this, ((TextElement *)node)->getContent().length());
+            if(((TextElement *)node)->getContent().length() > this->largestText)
+                this->largestText = ((TextElement *)node)->getContent().length();
+            break;
+        case NodeTypeName::XmlElement:
+            objectSize = sizeof(XmlElement);
+            /* The vector of child pointers */
+            if(((XmlElement *)node)->getChildAmount() > 0) {
+                this->estimatedAllocations++;
+                this->estimatedAllocatedBytes += ((XmlElement *)node)->getChildAmount() * sizeof(Node *);
+            }
+            break;
+        case NodeTypeName::XmlProlog:
+            objectSize = sizeof(XmlProlog);
+            break;
+        case NodeTypeName::AttributeDTD:
+            objectSize = sizeof(AttributeDTD);
+            break;
+        case NodeTypeName::DoctypeDTD:
+            objectSize = sizeof(DoctypeDTD);
+            if(((DoctypeDTD *)node)->getChildAmount() > 0) {
+                this->estimatedAllocations++;
+                this->estimatedAllocatedBytes += ((DoctypeDTD *)node)->getChildAmount() * sizeof(DTD *);
+            }
+            break;
+        case NodeTypeName::DTD:
+            objectSize = sizeof(DTD);
+            break;
+        case NodeTypeName::ElementDTD:
+            objectSize = sizeof(ElementDTD);
+            break;
+        case NodeTypeName::EntityDTD:
+            objectSize = sizeof(EntityDTD);
+            break;
+        default:
+            break;
+    }
+    this->estimatedAllocations++;
+    this->estimatedAllocatedBytes += objectSize;
+
+    /* The name, and each attribute (a map tree node with the key and the value) */
+    stats_addString(this, node->getName().length());
+    for(auto const & it : node->getAttributes()) {
+        this->estimatedAllocations++;
+        this->estimatedAllocatedBytes += 4 * sizeof(void *) + sizeof(it);
+        stats_addString(this, it.first.length());
+        stats_addString(this, it.second.length());
+    }
+}
+
+std::string XmlStats::toJson(void) const {
+    std::string result = "{";
+    result += "\"bytes_read\":" + std::to_string(this->bytesRead);
+    result += ",\"read_seconds\":" + std::to_string(this->readSeconds);
+    result += ",\"decode_seconds\":" + std::to_string(this->decodeSeconds);
+    result += ",\"scan_seconds\":" + std::to_string(this->scanSeconds);
+    result += ",\"build_seconds\":" + std::to_string(this->buildSeconds);
+    result += ",\"nodes\":{";
+    for(size_t i = 0; i < XML_STATS_NODE_TYPES; i++) {
+        result += (i > 0 ? ",\"" : "\"") + std::string(nodeTypeNameString((NodeTypeName)i)) + "\":" + std::to_string(this->nodeCounts[i]);
+    }
+    result += "}";
+    result += ",\"max_depth\":" + std::to_string(this->maxDepth);
+    result += ",\"estimated_allocations\":" + std::to_string(this->estimatedAllocations);
+    result += ",\"estimated_allocated_bytes\":" + std::to_string(this->estimatedAllocatedBytes);
+    result += ",\"largest_text\":" + std::to_string(this->largestText);
+    result += ",\"bytes_written\":" + std::to_string(this->bytesWritten);
+    result += ",\"bytes_copied\":" + std::to_string(this->bytesCopied);
+    result += ",\"serialize_seconds\":" + std::to_string(this->serializeSeconds);
+    result += ",\"write_seconds\":" + std::to_string(this->writeSeconds);
+    result += "}";
+    return result;
+}
+
+
+/* Other functions */
+
+char const * nodeTypeNameString(NodeTypeName type) {
+    switch(type) {
+        case NodeTypeName::Node:
+            return "Node";
+        case NodeTypeName::Comment:
+            return "Comment";
+        case NodeTypeName::ProcessingInstruction:
+            return "ProcessingInstruction";
+        case NodeTypeName::TextElement:
+            return "TextElement";
+        case NodeTypeName::XmlElement:
+            return "XmlElement";
+        case NodeTypeName::XmlProlog:
+            return "XmlProlog";
+        case NodeTypeName::AttributeDTD:
+            return "AttributeDTD";
+        case NodeTypeName::DoctypeDTD:
+            return "DoctypeDTD";
+        case NodeTypeName::DTD:
+            return "DTD";
+        case NodeTypeName::ElementDTD:
+            return "ElementDTD";
+        case NodeTypeName::EntityDTD:
+            return "EntityDTD";
+        default:
+            return "Unknown";
+    }
+}
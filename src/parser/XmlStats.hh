@@ -0,0 +1,91 @@
+/**
+ * @file XmlStats.hh
+ * @author Linux-Tech-Tips
+ * @brief Parse and serialize statistics of an XML Document
+ *
+ * The header declaring the statistics structure, which can optionally be filled in by an XML Document
+ * when loading, printing and saving, to find out where the time of these operations is spent.
+ */
+#ifndef XML_STATS_H
+#define XML_STATS_H
+
+#include <string>
+#include <cstddef>
+
+#include "XML/Node.hh"
+
+/** The amount of members of the NodeTypeName enumeration */
+#define XML_STATS_NODE_TYPES (((size_t)NodeTypeName::EntityDTD) + 1)
+
+/**
+ * @struct XmlStats
+ * @author Linux-Tech-Tips
+ * @brief XML Document statistics
+ *
+ * Statistics of the last load and the last print or save of an XML Document, filled in if set using @ref XmlDocument::setStats.
+ * Loading (using load or loadFromString) overwrites the load statistics, printing overwrites the serialize statistics,
+ * and saving overwrites both the serialize and write statistics.
+ * The scan phase is the matching of the opening and closing tags of all elements in a single pass over the text, and the build phase
+ * is the creation of Node objects from their declarations (which includes the scanning of the content of each element).
+*/
+struct XmlStats {
+
+    /* Load statistics */
+
+    /** The amount of bytes read from the file, or passed as a string */
+    size_t bytesRead = 0;
+    /** Time spent reading the file, in seconds (0 if loaded from a string) */
+    double readSeconds = 0.0;
+    /** Time spent detecting the encoding, and validating or transcoding the text into UTF-8, in seconds */
+    double decodeSeconds = 0.0;
+    /** Time spent splitting the root-level content into Node declarations, in seconds */
+    double scanSeconds = 0.0;
+    /** Time spent creating Node objects from the declarations, in seconds */
+    double buildSeconds = 0.0;
+    /** The amount of loaded Nodes of each type, indexed by the NodeTypeName values */
+    size_t nodeCounts[XML_STATS_NODE_TYPES] = {};
+    /** The deepest nesting level of any loaded Node (root-level Nodes having depth 1) */
+    size_t maxDepth = 0;
+    /** The estimated amount of heap allocations holding the loaded Nodes, computed from the sizes of the loaded Nodes and their content (not measured) */
+    size_t estimatedAllocations = 0;
+    /** The estimated amount of heap memory holding the loaded Nodes in bytes, computed from the sizes of the loaded Nodes and their content (not measured) */
+    size_t estimatedAllocatedBytes = 0;
+    /** The length of the longest text content of any loaded Text Element or Comment */
+    size_t largestText = 0;
+
+    /* Serialize statistics */
+
+    /** The amount of bytes printed, or written into the file */
+    size_t bytesWritten = 0;
+    /** The amount of printed bytes copied unchanged from the loaded text (only by incremental printing, see @ref XmlDocument::setIncrementalSave) */
+    size_t bytesCopied = 0;
+    /** Time spent printing the document into a string, in seconds */
+    double serializeSeconds = 0.0;
+    /** Time spent writing the printed document into the file, in seconds (0 if only printed) */
+    double writeSeconds = 0.0;
+
+
+    /** Resets all load statistics */
+    void resetLoad(void);
+
+    /** Resets all serialize statistics */
+    void resetSerialize(void);
+
+    /** Returns the amount of loaded Nodes of the given type */
+    size_t getNodeCount(NodeTypeName type) const;
+
+    /** Returns the total amount of loaded Nodes of all types */
+    size_t getNodeCount(void) const;
+
+    /** Adds the given Node to the load statistics (called for each loaded Node, with the nesting depth of the Node) */
+    void addNode(Node const * node, size_t depth);
+
+    /** Returns all statistics as a single-line JSON object */
+    std::string toJson(void) const;
+
+};
+
+/** Returns the name of the given NodeTypeName value, as a string */
+char const * nodeTypeNameString(NodeTypeName type);
+
+#endif /* XML_STATS_H */
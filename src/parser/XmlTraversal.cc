@@ -0,0 +1,209 @@
+#include "XmlTraversal.hh"
+
+/* Tree iterator */
+
+/* Protected member functions */
+
+size_t TreeIterator::getLevelAmount(Node const * parent) const {
+    if(parent != nullptr)
+        return TreeIterator::getChildAmount(parent);
+    return (this->document ? this->document->getChildAmount() : 1);
+}
+
+Node const * TreeIterator::getLevelChild(Node const * parent, size_t index) const {
+    if(parent != nullptr)
+        return TreeIterator::getChild(parent, index);
+    return (this->document ? this->document->getNode((int)index) : this->root);
+}
+
+void TreeIterator::updateCurrent(void) {
+    if(this->levels.empty())
+        this->current = nullptr;
+    else
+        this->current = this->getLevelChild(this->levels.back().parent, this->levels.back().index);
+    this->skipped = false;
+}
+
+void TreeIterator::descendFirst(void) {
+    while(true) {
+        Node const * node = this->getLevelChild(this->levels.back().parent, this->levels.back().index);
+        size_t amount = TreeIterator::getChildAmount(node);
+        if(amount == 0)
+            break;
+        this->levels.push_back({ node, 0, amount });
+    }
+}
+
+
+/* Constructors */
+
+TreeIterator::TreeIterator(void) : document(nullptr), root(nullptr), order(TraversalOrder::PreOrder), current(nullptr), skipped(false) {}
+
+TreeIterator::TreeIterator(XmlDocument const & document, TraversalOrder order) : document(&document), root(nullptr), order(order), current(nullptr), skipped(false) {
+    if(document.getChildAmount() > 0) {
+        this->levels.push_back({ nullptr, 0, document.getChildAmount() });
+        if(order == TraversalOrder::PostOrder)
+            this->descendFirst();
+    }
+    this->updateCurrent();
+}
+
+TreeIterator::TreeIterator(Node const & root, TraversalOrder order) : document(nullptr), root(&root), order(order), current(nullptr), skipped(false) {
+    this->levels.push_back({ nullptr, 0, 1 });
+    if(order == TraversalOrder::PostOrder)
+        this->descendFirst();
+    this->updateCurrent();
+}
+
+
+/* Operators */
+
+Node const * TreeIterator::operator*(void) const {
+    return this->current;
+}
+
+Node const * TreeIterator::operator->(void) const {
+    return this->current;
+}
+
+TreeIterator & TreeIterator::operator++(void) {
+    if(this->levels.empty())
+        return *this;
+
+    if(this->order == TraversalOrder::PreOrder) {
+        /* Descending into the children of the current Node first, then continuing with the next sibling of the innermost Node which has one */
+        size_t amount = (this->skipped ? 0 : TreeIterator::getChildAmount(this->current));
+        if(amount > 0) {
+            this->levels.push_back({ this->current, 0, amount });
+        } else {
+            while(!this->levels.empty() && ++this->levels.back().index >= this->levels.back().amount) {
+                this->levels.pop_back();
+            }
+        }
+    } else {
+        /* Continuing with the first Node without children under the next sibling, or with the parent once all siblings are done */
+        if(++this->levels.back().index < this->levels.back().amount) {
+            this->descendFirst();
+        } else {
+            this->levels.pop_back();
+        }
+    }
+
+    this->updateCurrent();
+    return *this;
+}
+
+TreeIterator TreeIterator::operator++(int) {
+    TreeIterator result(*this);
+    ++(*this);
+    return result;
+}
+
+bool TreeIterator::operator==(TreeIterator const & other) const {
+    return this->current == other.current && this->levels.size() == other.levels.size();
+}
+
+bool TreeIterator::operator!=(TreeIterator const & other) const {
+    return !(*this == other);
+}
+
+
+/* Public member functions */
+
+void TreeIterator::skipChildren(void) {
+    if(this->order == TraversalOrder::PreOrder)
+        this->skipped = true;
+}
+
+size_t TreeIterator::getDepth(void) const {
+    return (this->levels.empty() ? 0 : this->levels.size() - 1);
+}
+
+Node const * TreeIterator::getParent(void) const {
+    return (this->levels.empty() ? nullptr : this->levels.back().parent);
+}
+
+size_t TreeIterator::getChildAmount(Node const * node) {
+    switch(node->getNodeType()) {
+        case NodeTypeName::XmlElement:
+            return ((XmlElement const *)node)->getChildAmount();
+        case NodeTypeName::DoctypeDTD:
+            return ((DoctypeDTD const *)node)->getChildAmount();
+        default:
+            return 0;
+    }
+}
+
+Node const * TreeIterator::getChild(Node const * node, size_t index) {
+    if(node->getNodeType() == NodeTypeName::XmlElement)
+        return ((XmlElement const *)node)->getChild((int)index);
+    return ((DoctypeDTD const *)node)->getChild((int)index);
+}
+
+
+/* Tree range */
+
+TreeRange::TreeRange(XmlDocument const & document, TraversalOrder order) : first(document, order) {}
+
+TreeRange::TreeRange(Node const & root, TraversalOrder order) : first(root, order) {}
+
+TreeIterator TreeRange::begin(void) const {
+    return this->first;
+}
+
+TreeIterator TreeRange::end(void) const {
+    return TreeIterator();
+}
+
+
+/* Child iterator */
+
+ChildIterator::ChildIterator(XmlDocument const & document, size_t index) : document(&document), parent(nullptr), index(index) {}
+
+ChildIterator::ChildIterator(Node const & parent, size_t index) : document(nullptr), parent(&parent), index(index) {}
+
+Node const * ChildIterator::operator*(void) const {
+    return (this->document ? this->document->getNode((int)this->index) : TreeIterator::getChild(this->parent, this->index));
+}
+
+Node const * ChildIterator::operator->(void) const {
+    return **this;
+}
+
+ChildIterator & ChildIterator::operator++(void) {
+    this->index++;
+    return *this;
+}
+
+ChildIterator ChildIterator::operator++(int) {
+    ChildIterator result(*this);
+    this->index++;
+    return result;
+}
+
+bool ChildIterator::operator==(ChildIterator const & other) const {
+    return this->document == other.document && this->parent == other.parent && this->index == other.index;
+}
+
+bool ChildIterator::operator!=(ChildIterator const & other) const {
+    return !(*this == other);
+}
+
+size_t ChildIterator::getIndex(void) const {
+    return this->index;
+}
+
+
+/* Child range */
+
+ChildRange::ChildRange(XmlDocument const & document) : first(document, 0), last(document, document.getChildAmount()) {}
+
+ChildRange::ChildRange(Node const & parent) : first(parent, 0), last(parent, TreeIterator::getChildAmount(&parent)) {}
+
+ChildIterator ChildRange::begin(void) const {
+    return this->first;
+}
+
+ChildIterator ChildRange::end(void) const {
+    return this->last;
+}
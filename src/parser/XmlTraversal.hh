@@ -0,0 +1,324 @@
+/**
+ * @file XmlTraversal.hh
+ * @author Linux-Tech-Tips
+ * @brief Non-recursive tree iterators and visitor header
+ *
+ * The header declaring iterators going through the Nodes of a document (or of a single Node) in pre-order or post-order, iterators going through the children of a Node,
+ * and a visitor calling a function for each type of Node. None of them recurse, so the depth of a document isn't limited by the size of the thread's stack.
+ */
+#ifndef XML_TRAVERSAL_H
+#define XML_TRAVERSAL_H
+
+#include <vector>
+#include <iterator>
+#include <cstddef>
+
+#include "XmlDocument.hh"
+
+/** The order in which a @ref TreeIterator goes through the Nodes */
+enum class TraversalOrder {
+    /** Each Node before its nested Nodes (document order) */
+    PreOrder,
+    /** Each Node after its nested Nodes */
+    PostOrder
+};
+
+/**
+ * @class TreeIterator
+ * @author Linux-Tech-Tips
+ * @brief Iterator going through all Nodes of a document or of a single Node
+ *
+ * Goes through the root-level Nodes of a document (or a single root Node) and all their nested Nodes - the children of XmlElement and DoctypeDTD Nodes.
+ * The path to the current Node is kept in an explicit stack allocated on the heap, and the children are found by switching on the type of the Node,
+ * without any recursion or virtual calls. The Nodes are read-only, so that shared Nodes are never copied (see @ref Node).
+ * The document must not be modified while it's being iterated over.
+*/
+class TreeIterator {
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node const * value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Node const * const * pointer;
+        typedef Node const * const & reference;
+
+    protected:
+        /** A Node on the path to the current Node, with the position of the next Node on the path among its children */
+        struct Level {
+            /** The parent (null pointer for the root-level Nodes) */
+            Node const * parent;
+            /** The position of the Node on the path among the children of the parent */
+            size_t index;
+            /** The amount of children of the parent */
+            size_t amount;
+        };
+
+        /** The iterated document (null pointer if iterating over a single Node) */
+        XmlDocument const * document;
+        /** The iterated Node (null pointer if iterating over a document) */
+        Node const * root;
+        /** The order of the iteration */
+        TraversalOrder order;
+        /** The path to the current Node, from the root level (empty once finished) */
+        std::vector<Level> levels;
+        /** The current Node (null pointer once finished) */
+        Node const * current;
+        /** Whether the children of the current Node are skipped */
+        bool skipped;
+
+        /** Internal function which returns the amount of children of the given parent (the amount of root-level Nodes if null pointer) */
+        size_t getLevelAmount(Node const * parent) const;
+
+        /** Internal function which returns the child of the given parent at the given position (the root-level Node if parent is null pointer) */
+        Node const * getLevelChild(Node const * parent, size_t index) const;
+
+        /** Internal function which sets the current Node to the Node at the top of the path, or finishes the iteration if the path is empty */
+        void updateCurrent(void);
+
+        /** Internal function which adds the first children to the path until a Node without children is reached (used in post-order) */
+        void descendFirst(void);
+
+    public:
+        /** Constructor - an iterator which has finished (the end of any iteration) */
+        TreeIterator(void);
+
+        /** Constructor - an iterator at the first Node of the given document in the given order */
+        explicit TreeIterator(XmlDocument const & document, TraversalOrder order = TraversalOrder::PreOrder);
+
+        /** Constructor - an iterator at the first Node of the given Node and its nested Nodes in the given order (the Node itself first in pre-order, last in post-order) */
+        explicit TreeIterator(Node const & root, TraversalOrder order = TraversalOrder::PreOrder);
+
+        /** Returns the current Node */
+        Node const * operator*(void) const;
+        /** Accesses the current Node */
+        Node const * operator->(void) const;
+
+        /** Moves to the next Node */
+        TreeIterator & operator++(void);
+        /** Moves to the next Node, returning a copy of the iterator before moving (copies the path) */
+        TreeIterator operator++(int);
+
+        /** Returns whether both iterators are at the same Node (or both finished) */
+        bool operator==(TreeIterator const & other) const;
+        bool operator!=(TreeIterator const & other) const;
+
+        /** Skips the nested Nodes of the current Node, so that moving to the next Node continues with its next sibling (pre-order only, no effect in post-order) */
+        void skipChildren(void);
+
+        /** Returns the depth of the current Node (0 for a root-level Node, or for the iterated Node) */
+        size_t getDepth(void) const;
+
+        /** Returns the parent of the current Node (null pointer for a root-level Node, or for the iterated Node) */
+        Node const * getParent(void) const;
+
+        /** Returns the amount of children of the given Node, which can be gone through by @ref getChild (0 for Nodes which can't have nested Nodes) */
+        static size_t getChildAmount(Node const * node);
+
+        /** Returns the child of the given Node at the given position (undefined if out of bounds) */
+        static Node const * getChild(Node const * node, size_t index);
+
+};
+
+/**
+ * @class TreeRange
+ * @author Linux-Tech-Tips
+ * @brief Range of all Nodes of a document or of a single Node, for range-based for loops
+ *
+ * e.g. 'for(Node const * node : TreeRange(document)) { ... }' - see @ref TreeIterator
+*/
+class TreeRange {
+
+    protected:
+        /** The iterator at the first Node */
+        TreeIterator first;
+
+    public:
+        /** Constructor - the range of all Nodes of the document in the given order */
+        explicit TreeRange(XmlDocument const & document, TraversalOrder order = TraversalOrder::PreOrder);
+
+        /** Constructor - the range of the Node and all its nested Nodes in the given order */
+        explicit TreeRange(Node const & root, TraversalOrder order = TraversalOrder::PreOrder);
+
+        TreeIterator begin(void) const;
+        TreeIterator end(void) const;
+
+};
+
+/**
+ * @class ChildIterator
+ * @author Linux-Tech-Tips
+ * @brief Iterator going through the children of a single Node (or the root-level Nodes of a document), without their nested Nodes
+*/
+class ChildIterator {
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Node const * value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Node const * const * pointer;
+        typedef Node const * const & reference;
+
+    protected:
+        /** The document whose root-level Nodes are iterated over (null pointer if iterating over the children of a Node) */
+        XmlDocument const * document;
+        /** The Node whose children are iterated over (null pointer if iterating over a document) */
+        Node const * parent;
+        /** The position of the current child */
+        size_t index;
+
+    public:
+        /** Constructor - an iterator at the given position among the root-level Nodes of the document */
+        ChildIterator(XmlDocument const & document, size_t index);
+
+        /** Constructor - an iterator at the given position among the children of the Node */
+        ChildIterator(Node const & parent, size_t index);
+
+        /** Returns the current child */
+        Node const * operator*(void) const;
+        /** Accesses the current child */
+        Node const * operator->(void) const;
+
+        /** Moves to the next sibling */
+        ChildIterator & operator++(void);
+        /** Moves to the next sibling, returning a copy of the iterator before moving */
+        ChildIterator operator++(int);
+
+        bool operator==(ChildIterator const & other) const;
+        bool operator!=(ChildIterator const & other) const;
+
+        /** Returns the position of the current child among its siblings */
+        size_t getIndex(void) const;
+
+};
+
+/**
+ * @class ChildRange
+ * @author Linux-Tech-Tips
+ * @brief Range of the children of a single Node (or the root-level Nodes of a document), for range-based for loops
+*/
+class ChildRange {
+
+    protected:
+        /** The iterator at the first child */
+        ChildIterator first;
+        /** The iterator after the last child */
+        ChildIterator last;
+
+    public:
+        /** Constructor - the range of the root-level Nodes of the document */
+        explicit ChildRange(XmlDocument const & document);
+
+        /** Constructor - the range of the children of the Node (empty if the Node can't have children) */
+        explicit ChildRange(Node const & parent);
+
+        ChildIterator begin(void) const;
+        ChildIterator end(void) const;
+
+};
+
+/**
+ * @class NodeVisitor
+ * @author Linux-Tech-Tips
+ * @brief Visitor calling a function for each type of Node
+ *
+ * Goes through all Nodes of a document (or of a single Node) in document order, calling the function of the visitor for the type of each Node.
+ * The visitor class inherits from NodeVisitor<VisitorClass> and declares the functions it needs (with the same signatures), the others doing nothing -
+ * the functions are found at compile time and dispatched by a switch on the type of the Node, so no virtual functions are called, and they can be inlined.
+ * The visit functions of Nodes with children return whether their nested Nodes should be visited, and the leave functions are called after the nested Nodes.
+ * Uses an explicit stack, so the depth of the document isn't limited by the size of the thread's stack.
+*/
+template <typename Visitor>
+class NodeVisitor {
+
+    public:
+        /** Called for each XmlElement, returns whether its nested Nodes should be visited */
+        bool visitElement(XmlElement const & element) { (void)element; return true; }
+        /** Called for each XmlElement after its nested Nodes (also if they weren't visited) */
+        void leaveElement(XmlElement const & element) { (void)element; }
+        /** Called for each TextElement */
+        void visitText(TextElement const & text) { (void)text; }
+        /** Called for each Comment */
+        void visitComment(Comment const & comment) { (void)comment; }
+        /** Called for each ProcessingInstruction */
+        void visitProcessingInstruction(ProcessingInstruction const & instruction) { (void)instruction; }
+        /** Called for each XmlProlog */
+        void visitProlog(XmlProlog const & prolog) { (void)prolog; }
+        /** Called for each DoctypeDTD, returns whether its nested DTD Nodes should be visited */
+        bool visitDoctype(DoctypeDTD const & doctype) { (void)doctype; return true; }
+        /** Called for each DoctypeDTD after its nested DTD Nodes (also if they weren't visited) */
+        void leaveDoctype(DoctypeDTD const & doctype) { (void)doctype; }
+        /** Called for each other DTD Node (element, attribute and entity declarations, and generic DTD Nodes) */
+        void visitDTD(DTD const & dtd) { (void)dtd; }
+        /** Called for each base Node */
+        void visitNode(Node const & node) { (void)node; }
+
+        /** Visits all Nodes of the document */
+        void traverse(XmlDocument const & document) {
+            for(size_t i = 0; i < document.getChildAmount(); i++) {
+                this->traverse(*document.getNode((int)i));
+            }
+        }
+
+        /** Visits the Node and all its nested Nodes */
+        void traverse(Node const & root) {
+            Visitor & visitor = static_cast<Visitor &>(*this);
+            /* The Nodes whose nested Nodes are being visited, with the position of the next child to visit */
+            std::vector<std::pair<Node const *, size_t>> stack;
+            Node const * node = &root;
+            while(true) {
+                if(node != nullptr) {
+                    bool nested = false;
+                    switch(node->getNodeType()) {
+                        case NodeTypeName::XmlElement:
+                            nested = visitor.visitElement(*(XmlElement const *)node);
+                            break;
+                        case NodeTypeName::TextElement:
+                            visitor.visitText(*(TextElement const *)node);
+                            break;
+                        case NodeTypeName::Comment:
+                            visitor.visitComment(*(Comment const *)node);
+                            break;
+                        case NodeTypeName::ProcessingInstruction:
+                            visitor.visitProcessingInstruction(*(ProcessingInstruction const *)node);
+                            break;
+                        case NodeTypeName::XmlProlog:
+                            visitor.visitProlog(*(XmlProlog const *)node);
+                            break;
+                        case NodeTypeName::DoctypeDTD:
+                            nested = visitor.visitDoctype(*(DoctypeDTD const *)node);
+                            break;
+                        case NodeTypeName::AttributeDTD:
+                        case NodeTypeName::DTD:
+                        case NodeTypeName::ElementDTD:
+                        case NodeTypeName::EntityDTD:
+                            visitor.visitDTD(*(DTD const *)node);
+                            break;
+                        default:
+                            visitor.visitNode(*node);
+                            break;
+                    }
+                    if(node->getNodeType() == NodeTypeName::XmlElement || node->getNodeType() == NodeTypeName::DoctypeDTD) {
+                        /* Nodes whose nested Nodes aren't visited are left right away */
+                        stack.emplace_back(node, nested ? 0 : TreeIterator::getChildAmount(node));
+                    }
+                }
+                if(stack.empty())
+                    return;
+                /* Continuing with the next child of the innermost Node, or leaving it if it has no more children */
+                std::pair<Node const *, size_t> & top = stack.back();
+                if(top.second < TreeIterator::getChildAmount(top.first)) {
+                    node = TreeIterator::getChild(top.first, top.second++);
+                } else {
+                    if(top.first->getNodeType() == NodeTypeName::XmlElement)
+                        visitor.leaveElement(*(XmlElement const *)top.first);
+                    else
+                        visitor.leaveDoctype(*(DoctypeDTD const *)top.first);
+                    stack.pop_back();
+                    node = nullptr;
+                }
+            }
+        }
+
+};
+
+#endif /* XML_TRAVERSAL_H */
@@ -0,0 +1,346 @@
+#include "binary_util.hh"
+
+#include <cstdint>
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <string_view>
+#include <stdexcept>
+
+#include "XML/Comment.hh"
+#include "XML/ProcessingInstruction.hh"
+#include "XML/TextElement.hh"
+#include "XML/XmlElement.hh"
+#include "XML/XmlProlog.hh"
+#include "XML/DTD/DTD.hh"
+#include "XML/DTD/AttributeDTD.hh"
+#include "XML/DTD/DoctypeDTD.hh"
+#include "XML/DTD/ElementDTD.hh"
+#include "XML/DTD/EntityDTD.hh"
+
+/* Internal auxiliary structures */
+
+/** The string table built while encoding, storing each unique string only once */
+struct BinaryStringTable {
+    /** All unique strings, in the order of their indices (a deque, so that the strings never move and can be referenced by the index map) */
+    std::deque<std::string> strings;
+    /** The index of each string in the table */
+    std::unordered_map<std::string_view, uint32_t> indices;
+
+    /** Returns the index of the given string, adding it to the table if not present yet */
+    uint32_t add(std::string_view value) {
+        auto it = this->indices.find(value);
+        if(it != this->indices.end())
+            return it->second;
+        this->strings.emplace_back(value);
+        uint32_t index = (uint32_t)(this->strings.size() - 1);
+        this->indices.emplace(this->strings.back(), index);
+        return index;
+    }
+};
+
+
+/* Internal auxiliary functions */
+
+/** Appends the given integer to the data, as a 32-bit little-endian integer */
+static void binary_writeInteger(std::string & data, uint32_t value) {
+    for(int i = 0; i < 4; i++) {
+        data += (char)((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/** Reads a 32-bit little-endian integer from the data at the index i, and moves i past it */
+static uint32_t binary_readInteger(std::string const & data, size_t * i) {
+    if(data.length() - *i < 4)
+        throw std::invalid_argument("Error: Truncated binary XML snapshot");
+    uint32_t result = 0;
+    for(int j = 0; j < 4; j++) {
+        result |= ((uint32_t)(unsigned char)data[*i + j]) << (8 * j);
+    }
+    *i += 4;
+    return result;
+}
+
+/** Reads a single byte from the data at the index i, and moves i past it */
+static uint8_t binary_readByte(std::string const & data, size_t * i) {
+    if(*i >= data.length())
+        throw std::invalid_argument("Error: Truncated binary XML snapshot");
+    return (uint8_t)data[(*i)++];
+}
+
+/** Reads a string table index from the data at the index i, and returns the referenced string */
+static std::string binary_readString(std::string const & data, size_t * i, std::vector<std::string_view> const & strings) {
+    uint32_t index = binary_readInteger(data, i);
+    if(index >= strings.size())
+        throw std::invalid_argument("Error: Invalid string index in binary XML snapshot");
+    return std::string(strings[index]);
+}
+
+/** Appends the record of a single Node (without its nested Nodes) to the data */
+static void binary_writeNode(std::string & data, BinaryStringTable & table, Node const * node) {
+    NodeTypeName type = node->getNodeType();
+
+    data += (char)type;
+    data += (char)binary_getFlags(node);
+
+    binary_writeInteger(data, table.add(node->getName()));
+
+    /* Type-specific content */
+    switch(type) {
+        case NodeTypeName::Comment:
+            binary_writeInteger(data, table.add(((Comment const *)node)->getContent()));
+            break;
+        case NodeTypeName::TextElement:
+            binary_writeInteger(data, table.add(((TextElement const *)node)->getContent()));
+            break;
+        case NodeTypeName::XmlElement:
+            binary_writeInteger(data, (uint32_t)((XmlElement const *)node)->getChildAmount());
+            break;
+        case NodeTypeName::DoctypeDTD:
+            binary_writeInteger(data, (uint32_t)((DoctypeDTD const *)node)->getChildAmount());
+            break;
+        default:
+            break;
+    }
+
+    /* Attributes */
+    binary_writeInteger(data, (uint32_t)node->getAttributeNumber());
+    for(auto const & it : node->getAttributes()) {
+        binary_writeInteger(data, table.add(it.first));
+        binary_writeInteger(data, table.add(it.second));
+    }
+}
+
+/** Reads the record of a single Node from the data at the index i, and returns the allocated Node
+ *  @param childAmount the amount of nested Nodes following the record is saved here (0 for Nodes which can't contain nested Nodes)
+*/
+static Node * binary_readNode(std::string const & data, size_t * i, std::vector<std::string_view> const & strings, std::pmr::memory_resource * resource, uint32_t * childAmount) {
+    uint8_t type = binary_readByte(data, i);
+    uint8_t flags = binary_readByte(data, i);
+    if(type > (uint8_t)NodeTypeName::EntityDTD)
+        throw std::invalid_argument("Error: Invalid Node type in binary XML snapshot");
+
+    bool endLine = (flags & BINARY_FLAG_END_LINE);
+    bool indent = (flags & BINARY_FLAG_INDENT);
+    bool first = (flags & BINARY_FLAG_FIRST);
+    bool second = (flags & BINARY_FLAG_SECOND);
+
+    std::string name = binary_readString(data, i, strings);
+    std::string content;
+    *childAmount = 0;
+    switch((NodeTypeName)type) {
+        case NodeTypeName::Comment:
+        case NodeTypeName::TextElement:
+            content = binary_readString(data, i, strings);
+            break;
+        case NodeTypeName::XmlElement:
+        case NodeTypeName::DoctypeDTD:
+            *childAmount = binary_readInteger(data, i);
+            break;
+        default:
+            break;
+    }
+
+    /* Creating the Node with the saved settings (names are set afterwards, since they were already checked when first set) */
+    Node * result = nullptr;
+    switch((NodeTypeName)type) {
+        case NodeTypeName::Comment:
+            result = new(resource) Comment("", content, first, endLine, indent, resource);
+            break;
+        case NodeTypeName::ProcessingInstruction:
+            result = new(resource) ProcessingInstruction("", endLine, indent, resource);
+            break;
+        case NodeTypeName::TextElement:
+            result = new(resource) TextElement("_default_text_element", content, first, indent, endLine, second, resource);
+            break;
+        case NodeTypeName::XmlElement:
+            result = new(resource) XmlElement("", first, endLine, indent, false, resource);
+            break;
+        case NodeTypeName::XmlProlog:
+            result = new(resource) XmlProlog("", 1.0f, "", STANDALONE_UNSET, endLine, indent, first, resource);
+            break;
+        case NodeTypeName::AttributeDTD:
+            result = new(resource) AttributeDTD("", "", "", "", first, indent, endLine, resource);
+            break;
+        case NodeTypeName::DoctypeDTD:
+            result = new(resource) DoctypeDTD("", first, indent, endLine, resource);
+            break;
+        case NodeTypeName::DTD:
+            result = new(resource) DTD("", "", indent, endLine, resource);
+            break;
+        case NodeTypeName::ElementDTD:
+            result = new(resource) ElementDTD("", "", indent, endLine, resource);
+            break;
+        case NodeTypeName::EntityDTD:
+            result = new(resource) EntityDTD("", "", first, indent, endLine, resource);
+            break;
+        default:
+            result = new(resource) Node("_default_node", endLine, indent, resource);
+            break;
+    }
+    result->setName(name, false);
+
+    /* Replacing any attributes set by the constructor with the saved ones (deleting the Node if the record is truncated) */
+    result->clearAttributes();
+    try {
+        uint32_t attributeAmount = binary_readInteger(data, i);
+        for(uint32_t j = 0; j < attributeAmount; j++) {
+            std::string key = binary_readString(data, i, strings);
+            result->setAttribute(key, binary_readString(data, i, strings));
+        }
+    } catch(std::invalid_argument const & e) {
+        delete result;
+        throw;
+    }
+
+    return result;
+}
+
+
+/* Binary snapshot functions */
+
+uint8_t binary_getFlags(Node const * node) {
+    uint8_t flags = 0;
+    if(node->getEndLine())
+        flags |= BINARY_FLAG_END_LINE;
+    if(node->getIndent())
+        flags |= BINARY_FLAG_INDENT;
+    switch(node->getNodeType()) {
+        case NodeTypeName::Comment:
+            if(((Comment const *)node)->getShowName())
+                flags |= BINARY_FLAG_FIRST;
+            break;
+        case NodeTypeName::TextElement:
+            if(((TextElement const *)node)->getShowTag())
+                flags |= BINARY_FLAG_FIRST;
+            if(((TextElement const *)node)->getEscapeSpecial())
+                flags |= BINARY_FLAG_SECOND;
+            break;
+        case NodeTypeName::XmlElement:
+            if(((XmlElement const *)node)->getSingleLine())
+                flags |= BINARY_FLAG_FIRST;
+            break;
+        case NodeTypeName::XmlProlog:
+            if(((XmlProlog const *)node)->getUserAttributes())
+                flags |= BINARY_FLAG_FIRST;
+            break;
+        case NodeTypeName::AttributeDTD:
+            if(((AttributeDTD const *)node)->getStringValue())
+                flags |= BINARY_FLAG_FIRST;
+            break;
+        case NodeTypeName::DoctypeDTD:
+            if(((DoctypeDTD const *)node)->getSingleLine())
+                flags |= BINARY_FLAG_FIRST;
+            break;
+        case NodeTypeName::EntityDTD:
+            if(((EntityDTD const *)node)->getStringValue())
+                flags |= BINARY_FLAG_FIRST;
+            break;
+        default:
+            break;
+    }
+    return flags;
+}
+
+
+std::string binary_encode(std::pmr::vector<Node *> const & nodes) {
+    BinaryStringTable table;
+    std::string body;
+
+    /* Encoding all Nodes in pre-order, using an explicit stack of Nodes left to encode */
+    binary_writeInteger(body, (uint32_t)nodes.size());
+    std::vector<Node const *> stack(nodes.rbegin(), nodes.rend());
+    while(!stack.empty()) {
+        Node const * current = stack.back();
+        stack.pop_back();
+        binary_writeNode(body, table, current);
+
+        if(current->getNodeType() == NodeTypeName::XmlElement) {
+            XmlElement const * element = (XmlElement const *)current;
+            for(size_t i = element->getChildAmount(); i > 0; i--) {
+                stack.push_back(element->getChild(i-1));
+            }
+        } else if(current->getNodeType() == NodeTypeName::DoctypeDTD) {
+            DoctypeDTD const * doctype = (DoctypeDTD const *)current;
+            for(size_t i = doctype->getChildAmount(); i > 0; i--) {
+                stack.push_back(doctype->getChild(i-1));
+            }
+        }
+    }
+
+    /* Header and string table, followed by the Nodes */
+    std::string result = BINARY_MAGIC;
+    binary_writeInteger(result, BINARY_VERSION);
+    binary_writeInteger(result, (uint32_t)table.strings.size());
+    for(std::string const & it : table.strings) {
+        binary_writeInteger(result, (uint32_t)it.length());
+        result += it;
+    }
+    result += body;
+    return result;
+}
+
+void binary_decode(std::string const & data, std::pmr::vector<Node *> & nodes) {
+    size_t i = 0;
+
+    /* Header */
+    if(data.compare(0, 4, BINARY_MAGIC) != 0)
+        throw std::invalid_argument("Error: Not a binary XML snapshot");
+    i += 4;
+    if(binary_readInteger(data, &i) != BINARY_VERSION)
+        throw std::invalid_argument("Error: Unsupported binary XML snapshot version");
+
+    /* String table, referencing the strings directly within the data */
+    uint32_t stringAmount = binary_readInteger(data, &i);
+    std::vector<std::string_view> strings;
+    strings.reserve(std::min((size_t)stringAmount, (data.length() - i) / 4));
+    for(uint32_t j = 0; j < stringAmount; j++) {
+        uint32_t length = binary_readInteger(data, &i);
+        if(data.length() - i < length)
+            throw std::invalid_argument("Error: Truncated binary XML snapshot");
+        strings.emplace_back(data.data() + i, length);
+        i += length;
+    }
+
+    /* Nodes in pre-order, each parent followed by its nested Nodes, using an explicit stack of parents and their amount of Nodes left to read */
+    uint32_t rootAmount = binary_readInteger(data, &i);
+    std::vector<Node *> roots;
+    std::vector<std::pair<Node *, uint32_t>> stack;
+    try {
+        for(uint32_t j = 0; j < rootAmount; j++) {
+            uint32_t childAmount;
+            roots.push_back(binary_readNode(data, &i, strings, nodes.get_allocator().resource(), &childAmount));
+            if(childAmount > 0)
+                stack.push_back({roots.back(), childAmount});
+
+            while(!stack.empty()) {
+                if(stack.back().second == 0) {
+                    stack.pop_back();
+                    continue;
+                }
+                stack.back().second--;
+
+                Node * parent = stack.back().first;
+                Node * child = binary_readNode(data, &i, strings, nodes.get_allocator().resource(), &childAmount);
+                if(parent->getNodeType() == NodeTypeName::XmlElement) {
+                    ((XmlElement *)parent)->_adoptChild(child);
+                } else if(child->getNodeType() >= NodeTypeName::AttributeDTD) {
+                    ((DoctypeDTD *)parent)->_adoptChild((DTD *)child);
+                } else {
+                    delete child;
+                    throw std::invalid_argument("Error: Non-DTD Node nested in a Doctype DTD in binary XML snapshot");
+                }
+                if(childAmount > 0)
+                    stack.push_back({child, childAmount});
+            }
+        }
+    } catch(std::invalid_argument const & e) {
+        /* Deleting any already decoded Nodes (nested Nodes are deleted by their parents) */
+        for(Node * it : roots) {
+            delete it;
+        }
+        throw;
+    }
+
+    nodes.insert(nodes.end(), roots.begin(), roots.end());
+}
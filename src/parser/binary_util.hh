@@ -0,0 +1,57 @@
+/**
+ * @file binary_util.hh
+ * @author Linux-Tech-Tips
+ * @brief Binary snapshot encoding of XML Node trees
+ *
+ * Contains functions which encode a list of XML Nodes (including all nested Nodes) into a compact, versioned binary snapshot,
+ * and decode such a snapshot back into allocated Nodes, without parsing any XML text.
+ *
+ * The snapshot consists of:
+ *  - the magic bytes "XMLB" followed by the format version (all integers are unsigned 32-bit little-endian, unless stated otherwise)
+ *  - the string table - the amount of strings, followed by the length and the bytes of each unique string
+ *    (all names, attribute keys and values and text contents of the Nodes are stored as indices into this table)
+ *  - the amount of root-level Nodes, followed by all Nodes in pre-order, each consisting of:
+ *    - the NodeTypeName of the Node and its flags (one byte each), and the name
+ *    - the text content (Comment and TextElement only), or the amount of directly nested Nodes (XmlElement and DoctypeDTD only), which follow the Node
+ *    - the amount of attributes, followed by the key and the value of each attribute
+ */
+
+#ifndef BINARY_UTIL_H
+#define BINARY_UTIL_H
+
+#include <string>
+#include <vector>
+#include <memory_resource>
+#include <cstdint>
+
+#include "XML/Node.hh"
+
+/** The magic bytes at the start of each binary snapshot */
+#define BINARY_MAGIC "XMLB"
+/** The current version of the binary snapshot format, increased whenever the encoding changes */
+#define BINARY_VERSION 1
+
+/* Node flags, saving the settings of a Node which affect how it is printed */
+
+/** The Node ends the line it's on */
+#define BINARY_FLAG_END_LINE 0x01
+/** The Node is indented if nested */
+#define BINARY_FLAG_INDENT 0x02
+/** The first setting specific to the Node type (showName, showTag, singleLine, printUserAttributes or stringValue) */
+#define BINARY_FLAG_FIRST 0x04
+/** The second setting specific to the Node type (escapeSpecial) */
+#define BINARY_FLAG_SECOND 0x08
+
+/** Returns the flags (BINARY_FLAG_*) describing the settings of the given Node */
+uint8_t binary_getFlags(Node const * node);
+
+/** Returns the binary snapshot of the given root-level Nodes, including all their nested Nodes */
+std::string binary_encode(std::pmr::vector<Node *> const & nodes);
+
+/** Decodes the given binary snapshot, adding all decoded root-level Nodes to the end of the given list.
+ * The Nodes are allocated from the memory resource of the list, and are owned by the caller.
+ * Throws std::invalid_argument if the snapshot is invalid, truncated, or of an unsupported version (in which case no Nodes are added).
+*/
+void binary_decode(std::string const & data, std::pmr::vector<Node *> & nodes);
+
+#endif /* BINARY_UTIL_H */
@@ -0,0 +1,305 @@
+#include "encoding_util.hh"
+
+#include <cctype>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Internal auxiliary functions */
+
+/** Returns the amount of ASCII bytes at the start of the given data */
+static size_t asciiPrefix(unsigned char const * data, size_t length) {
+    size_t i = 0;
+#ifdef __SSE2__
+    /* Testing 16 bytes at once, the mask having a bit set for each byte with the highest bit set */
+    for(; i + 16 <= length; i += 16) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((__m128i const *)(data + i)));
+        if(mask != 0)
+            return i + (size_t)__builtin_ctz((unsigned)mask);
+    }
+#endif
+    while(i < length && data[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+/** Decodes the UTF-8 character at the position i (moving i after it), returning its code point, or -1 if the character is invalid (i is not moved) */
+static int32_t decodeUtf8(unsigned char const * data, size_t length, size_t * i) {
+    size_t at = *i;
+    unsigned char first = data[at];
+    if(first < 0x80) {
+        *i = at + 1;
+        return first;
+    }
+    /* The amount of continuation bytes and the allowed range of the first one (excluding overlong forms, surrogates and code points above U+10FFFF) */
+    size_t continuation;
+    unsigned char low = 0x80, high = 0xBF;
+    int32_t result;
+    if(first >= 0xC2 && first <= 0xDF) {
+        continuation = 1;
+        result = first & 0x1F;
+    } else if(first >= 0xE0 && first <= 0xEF) {
+        continuation = 2;
+        result = first & 0x0F;
+        if(first == 0xE0)
+            low = 0xA0;
+        else if(first == 0xED)
+            high = 0x9F;
+    } else if(first >= 0xF0 && first <= 0xF4) {
+        continuation = 3;
+        result = first & 0x07;
+        if(first == 0xF0)
+            low = 0x90;
+        else if(first == 0xF4)
+            high = 0x8F;
+    } else {
+        return -1;
+    }
+    if(at + continuation >= length)
+        return -1;
+    for(size_t k = 1; k <= continuation; k++) {
+        unsigned char byte = data[at + k];
+        if(k == 1 ? (byte < low || byte > high) : (byte < 0x80 || byte > 0xBF))
+            return -1;
+        result = (result << 6) | (byte & 0x3F);
+    }
+    *i = at + continuation + 1;
+    return result;
+}
+
+/** Appends the given code point to the UTF-8 result */
+static void appendUtf8(std::string & result, uint32_t codePoint) {
+    if(codePoint < 0x80) {
+        result += (char)codePoint;
+    } else if(codePoint < 0x800) {
+        result += (char)(0xC0 | (codePoint >> 6));
+        result += (char)(0x80 | (codePoint & 0x3F));
+    } else if(codePoint < 0x10000) {
+        result += (char)(0xE0 | (codePoint >> 12));
+        result += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        result += (char)(0x80 | (codePoint & 0x3F));
+    } else {
+        result += (char)(0xF0 | (codePoint >> 18));
+        result += (char)(0x80 | ((codePoint >> 12) & 0x3F));
+        result += (char)(0x80 | ((codePoint >> 6) & 0x3F));
+        result += (char)(0x80 | (codePoint & 0x3F));
+    }
+}
+
+/** Appends the given UTF-16 code unit to the result in the given byte order */
+static void appendUtf16(std::string & result, uint16_t unit, bool bigEndian) {
+    if(bigEndian) {
+        result += (char)(unit >> 8);
+        result += (char)(unit & 0xFF);
+    } else {
+        result += (char)(unit & 0xFF);
+        result += (char)(unit >> 8);
+    }
+}
+
+/** Returns the encoding name declared in the prolog at the start of the ASCII-compatible data (empty if none declared) */
+static std::string declaredEncoding(std::string const & data, size_t begin) {
+    if(data.compare(begin, 5, "<?xml") != 0 || begin + 5 >= data.length() || !isspace((unsigned char)data[begin + 5]))
+        return "";
+    size_t end = data.find("?>", begin);
+    if(end == std::string::npos)
+        return "";
+    size_t i = data.find("encoding", begin);
+    if(i == std::string::npos || i > end)
+        return "";
+    i += 8;
+    while(i < end && isspace((unsigned char)data[i])) {
+        i++;
+    }
+    if(i >= end || data[i] != '=')
+        return "";
+    i++;
+    while(i < end && isspace((unsigned char)data[i])) {
+        i++;
+    }
+    if(i >= end || (data[i] != '"' && data[i] != '\''))
+        return "";
+    size_t close = data.find(data[i], i + 1);
+    if(close == std::string::npos || close > end)
+        return "";
+    return data.substr(i + 1, close - i - 1);
+}
+
+
+/* Function implementations */
+
+bool encoding_fromName(std::string const & name, TextEncoding * encoding) {
+    std::string upper;
+    for(char c : name) {
+        upper += (char)toupper((unsigned char)c);
+    }
+    if(upper == "UTF-8" || upper == "UTF8" || upper == "US-ASCII" || upper == "ASCII") {
+        *encoding = TextEncoding::UTF8;
+    } else if(upper == "UTF-16" || upper == "UTF16" || upper == "UTF-16LE") {
+        *encoding = TextEncoding::UTF16LE;
+    } else if(upper == "UTF-16BE") {
+        *encoding = TextEncoding::UTF16BE;
+    } else if(upper == "ISO-8859-1" || upper == "ISO8859-1" || upper == "ISO_8859-1" || upper == "LATIN1" || upper == "LATIN-1") {
+        *encoding = TextEncoding::Latin1;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string encoding_getName(TextEncoding encoding) {
+    switch(encoding) {
+        case TextEncoding::UTF16LE:
+        case TextEncoding::UTF16BE:
+            return "UTF-16";
+        case TextEncoding::Latin1:
+            return "ISO-8859-1";
+        default:
+            return "UTF-8";
+    }
+}
+
+TextEncoding encoding_detect(std::string const & data, size_t * bomLength) {
+    size_t bom = 0;
+    TextEncoding result = TextEncoding::UTF8;
+    unsigned char const * bytes = (unsigned char const *)data.data();
+    /* Byte order marks, then the first characters "<?" of a prolog in UTF-16 without a byte order mark */
+    if(data.length() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+        bom = 3;
+    } else if(data.length() >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE) {
+        bom = 2;
+        result = TextEncoding::UTF16LE;
+    } else if(data.length() >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF) {
+        bom = 2;
+        result = TextEncoding::UTF16BE;
+    } else if(data.length() >= 4 && data.compare(0, 4, std::string("<\0?\0", 4)) == 0) {
+        result = TextEncoding::UTF16LE;
+    } else if(data.length() >= 4 && data.compare(0, 4, std::string("\0<\0?", 4)) == 0) {
+        result = TextEncoding::UTF16BE;
+    } else {
+        /* ASCII-compatible, using the declared encoding (if any) */
+        std::string name = declaredEncoding(data, 0);
+        if(!name.empty() && !encoding_fromName(name, &result))
+            throw std::invalid_argument("Error: Unsupported encoding " + name);
+        /* UTF-16 can't be declared by an ASCII-compatible prolog */
+        if(result == TextEncoding::UTF16LE || result == TextEncoding::UTF16BE)
+            result = TextEncoding::UTF8;
+    }
+    if(bomLength)
+        *bomLength = bom;
+    return result;
+}
+
+bool encoding_validateUtf8(char const * data, size_t length, size_t * errorOffset) {
+    unsigned char const * bytes = (unsigned char const *)data;
+    size_t i = 0;
+    while(i < length) {
+        i += asciiPrefix(bytes + i, length - i);
+        if(i >= length)
+            break;
+        if(decodeUtf8(bytes, length, &i) < 0) {
+            if(errorOffset)
+                *errorOffset = i;
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string encoding_toUtf8(char const * data, size_t length, TextEncoding encoding) {
+    unsigned char const * bytes = (unsigned char const *)data;
+    std::string result;
+    if(encoding == TextEncoding::UTF8) {
+        size_t errorOffset;
+        if(!encoding_validateUtf8(data, length, &errorOffset))
+            throw std::invalid_argument("Error: Invalid UTF-8 at byte " + std::to_string(errorOffset));
+        result.assign(data, length);
+
+    } else if(encoding == TextEncoding::Latin1) {
+        /* Each byte is its own code point, copying the runs of ASCII at once */
+        result.reserve(length + length / 8);
+        size_t i = 0;
+        while(i < length) {
+            size_t ascii = asciiPrefix(bytes + i, length - i);
+            result.append(data + i, ascii);
+            i += ascii;
+            if(i < length) {
+                appendUtf8(result, bytes[i]);
+                i++;
+            }
+        }
+
+    } else {
+        if(length % 2 != 0)
+            throw std::invalid_argument("Error: Invalid UTF-16 (odd amount of bytes)");
+        bool bigEndian = (encoding == TextEncoding::UTF16BE);
+        result.reserve(length / 2);
+        for(size_t i = 0; i < length; i += 2) {
+            uint32_t unit = (bigEndian ? ((uint32_t)bytes[i] << 8) | bytes[i+1] : ((uint32_t)bytes[i+1] << 8) | bytes[i]);
+            if(unit >= 0xD800 && unit <= 0xDBFF) {
+                /* High surrogate, needing a low surrogate to follow */
+                if(i + 3 >= length)
+                    throw std::invalid_argument("Error: Invalid UTF-16 at byte " + std::to_string(i));
+                uint32_t next = (bigEndian ? ((uint32_t)bytes[i+2] << 8) | bytes[i+3] : ((uint32_t)bytes[i+3] << 8) | bytes[i+2]);
+                if(next < 0xDC00 || next > 0xDFFF)
+                    throw std::invalid_argument("Error: Invalid UTF-16 at byte " + std::to_string(i));
+                unit = 0x10000 + ((unit - 0xD800) << 10) + (next - 0xDC00);
+                i += 2;
+            } else if(unit >= 0xDC00 && unit <= 0xDFFF) {
+                throw std::invalid_argument("Error: Invalid UTF-16 at byte " + std::to_string(i));
+            }
+            appendUtf8(result, unit);
+        }
+    }
+    return result;
+}
+
+std::string encoding_fromUtf8(std::string const & utf8, TextEncoding encoding) {
+    if(encoding == TextEncoding::UTF8)
+        return utf8;
+
+    unsigned char const * bytes = (unsigned char const *)utf8.data();
+    size_t length = utf8.length();
+    std::string result;
+    bool bigEndian = (encoding == TextEncoding::UTF16BE);
+    if(encoding == TextEncoding::Latin1) {
+        result.reserve(length);
+    } else {
+        result.reserve(length * 2 + 2);
+        appendUtf16(result, 0xFEFF, bigEndian);
+    }
+
+    size_t i = 0;
+    while(i < length) {
+        size_t ascii = asciiPrefix(bytes + i, length - i);
+        if(encoding == TextEncoding::Latin1) {
+            result.append(utf8, i, ascii);
+        } else {
+            for(size_t k = i; k < i + ascii; k++) {
+                appendUtf16(result, bytes[k], bigEndian);
+            }
+        }
+        i += ascii;
+        if(i >= length)
+            break;
+        size_t at = i;
+        int32_t codePoint = decodeUtf8(bytes, length, &i);
+        if(codePoint < 0)
+            throw std::invalid_argument("Error: Invalid UTF-8 at byte " + std::to_string(at));
+        if(encoding == TextEncoding::Latin1) {
+            if(codePoint > 0xFF)
+                throw std::invalid_argument("Error: Character at byte " + std::to_string(at) + " can't be represented in " + encoding_getName(encoding));
+            result += (char)codePoint;
+        } else if(codePoint >= 0x10000) {
+            appendUtf16(result, (uint16_t)(0xD800 + ((codePoint - 0x10000) >> 10)), bigEndian);
+            appendUtf16(result, (uint16_t)(0xDC00 + ((codePoint - 0x10000) & 0x3FF)), bigEndian);
+        } else {
+            appendUtf16(result, (uint16_t)codePoint, bigEndian);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file encoding_util.hh
+ * @author Linux-Tech-Tips
+ * @brief Text encoding detection, validation and transcoding
+ *
+ * Contains functions which detect the encoding of XML text (using the byte order mark and the encoding declared in the XML prolog),
+ * validate UTF-8 text, and transcode UTF-16 and Latin-1 text to and from UTF-8, which is the encoding all Nodes are stored in.
+ * Runs of ASCII characters are processed 16 bytes at a time using SSE2 (if available), so validating mostly ASCII text is nearly free.
+ */
+
+#ifndef ENCODING_UTIL_H
+#define ENCODING_UTIL_H
+
+#include <string>
+#include <cstddef>
+
+/** The encodings the parser can load and save */
+enum class TextEncoding {
+    /** UTF-8 (including US-ASCII, a subset of it) */
+    UTF8,
+    /** UTF-16, little-endian */
+    UTF16LE,
+    /** UTF-16, big-endian */
+    UTF16BE,
+    /** ISO-8859-1 (Latin-1) */
+    Latin1
+};
+
+/** Returns the encoding with the given name, as declared in an XML prolog (case-insensitive), saving it into encoding.
+ * Plain "UTF-16" is saved as little-endian.
+ *  @return false if the encoding is not supported (nothing is saved)
+*/
+bool encoding_fromName(std::string const & name, TextEncoding * encoding);
+
+/** Returns the name of the given encoding, as declared in an XML prolog */
+std::string encoding_getName(TextEncoding encoding);
+
+/** Detects the encoding of the given XML text, from its byte order mark, the byte pattern of its first characters, or the encoding declared in its prolog
+ * (UTF-8 if none found). Throws std::invalid_argument if the prolog declares an unsupported encoding.
+ *  @param bomLength optionally specify a variable into which the length of the byte order mark is saved (0 if none)
+*/
+TextEncoding encoding_detect(std::string const & data, size_t * bomLength = nullptr);
+
+/** Returns whether the given text is valid UTF-8 (no overlong forms, surrogates, or code points above U+10FFFF)
+ *  @param errorOffset optionally specify a variable into which the position of the first invalid byte is saved (if invalid)
+*/
+bool encoding_validateUtf8(char const * data, size_t length, size_t * errorOffset = nullptr);
+
+/** Returns the given text (without the byte order mark) transcoded from the given encoding into UTF-8.
+ * Throws std::invalid_argument if the text is invalid in the encoding (for UTF-8, the text is validated and returned unchanged).
+*/
+std::string encoding_toUtf8(char const * data, size_t length, TextEncoding encoding);
+
+/** Returns the given UTF-8 text transcoded into the given encoding (UTF-16 starting with the byte order mark).
+ * Throws std::invalid_argument if the text isn't valid UTF-8, or contains characters which can't be represented in the encoding.
+*/
+std::string encoding_fromUtf8(std::string const & utf8, TextEncoding encoding);
+
+#endif /* ENCODING_UTIL_H */
@@ -1,5 +1,138 @@
 #include "file_util.hh"
 
+#include <thread>
+#include <functional>
+#include <stdexcept>
+
+#include <zlib.h>
+
+#include "BoundedQueue.hh"
+
+/* Internal auxiliary structures */
+
+/** Decompresses gzip data fed to it in chunks, passing on the decompressed chunks */
+class GzipInflater {
+
+    protected:
+        /** The zlib stream state */
+        z_stream stream;
+        /** Whether the last gzip member ended (and no data followed it yet) */
+        bool ended;
+
+    public:
+        GzipInflater(void) : ended(false) {
+            this->stream = z_stream();
+            /* Window bits increased by 16 to only accept the gzip format */
+            if(inflateInit2(&this->stream, 15 + 16) != Z_OK)
+                throw std::invalid_argument("Error: Cannot initialize decompression");
+        }
+
+        ~GzipInflater(void) {
+            inflateEnd(&this->stream);
+        }
+
+        /** Decompresses the given chunk, calling output for each decompressed chunk (returning false from output stops decompressing) */
+        void feed(char const * data, size_t length, std::function<bool(std::string &&)> const & output) {
+            this->stream.next_in = (Bytef *)data;
+            this->stream.avail_in = (uInt)length;
+            while(this->stream.avail_in > 0) {
+                /* Starting the next member of concatenated gzip files */
+                if(this->ended) {
+                    inflateReset(&this->stream);
+                    this->ended = false;
+                }
+                std::string chunk(FILE_INFLATE_CHUNK, '\0');
+                this->stream.next_out = (Bytef *)&chunk[0];
+                this->stream.avail_out = (uInt)chunk.length();
+                int result = inflate(&this->stream, Z_NO_FLUSH);
+                if(result == Z_STREAM_END)
+                    this->ended = true;
+                else if(result != Z_OK && result != Z_BUF_ERROR)
+                    throw std::invalid_argument("Error: Invalid compressed data");
+                chunk.resize(chunk.length() - this->stream.avail_out);
+                if(!chunk.empty() && !output(std::move(chunk)))
+                    return;
+            }
+        }
+
+        /** Checks that the data ended with a complete gzip member */
+        void finish(void) {
+            if(!this->ended)
+                throw std::invalid_argument("Error: Compressed data ends unexpectedly");
+        }
+
+};
+
+/** Returns the decompressed size stored at the end of a gzip file (modulo 2^32, and only of the last member), used as an estimate of the size */
+static size_t gzipStoredSize(std::ifstream & f, std::streamoff size) {
+    if(size < 18)
+        return 0;
+    unsigned char trailer[4];
+    f.seekg(size - 4);
+    f.read((char *)trailer, 4);
+    f.seekg(0);
+    return (size_t)trailer[0] | ((size_t)trailer[1] << 8) | ((size_t)trailer[2] << 16) | ((size_t)trailer[3] << 24);
+}
+
+/** Reads and decompresses the opened gzip file, reading and decompressing on separate threads while the calling thread collects the result */
+static std::string readCompressed(std::ifstream & f, std::streamoff size) {
+    std::string result;
+    size_t stored = gzipStoredSize(f, size);
+    if(stored > (size_t)size)
+        result.reserve(stored);
+
+    BoundedQueue<std::string> compressed(FILE_QUEUED_CHUNKS);
+    BoundedQueue<std::string> decompressed(FILE_QUEUED_CHUNKS);
+    std::string error;
+
+    /* Reading stage - reads the compressed chunks */
+    std::thread reader([&f, &compressed]() {
+        while(f) {
+            std::string chunk(FILE_READ_CHUNK, '\0');
+            f.read(&chunk[0], chunk.length());
+            chunk.resize((size_t)f.gcount());
+            if(chunk.empty() || !compressed.push(std::move(chunk)))
+                break;
+        }
+        compressed.close();
+    });
+
+    /* Decompressing stage - decompresses the chunks read so far, stopping the reading stage on an error */
+    std::thread inflater([&compressed, &decompressed, &error]() {
+        try {
+            GzipInflater inflater;
+            std::string chunk;
+            bool running = true;
+            while(running && compressed.pop(chunk)) {
+                inflater.feed(chunk.data(), chunk.length(), [&decompressed, &running](std::string && output) {
+                    running = decompressed.push(std::move(output));
+                    return running;
+                });
+            }
+            if(running)
+                inflater.finish();
+        } catch(std::exception const & e) {
+            error = e.what();
+        }
+        compressed.close();
+        decompressed.close();
+    });
+
+    /* Collecting stage - appends the decompressed chunks into the result */
+    std::string chunk;
+    while(decompressed.pop(chunk)) {
+        result += chunk;
+    }
+    reader.join();
+    inflater.join();
+    if(!error.empty())
+        throw std::invalid_argument(error);
+    return result;
+}
+
+
+/* Function implementations */
+
 void file_writeString(char const * fileName, std::string const & fileData) {
     /* Writing to output file stream */
     std::ofstream f(fileName);
@@ -8,9 +141,44 @@ void file_writeString(char const * fileName, std::string const & fileData) {
 }
 
 std::string file_readString(char const * fileName) {
-    /* Reading from input file stream into intermediary buffer */
-    std::ifstream f(fileName);
-    std::stringstream buffer;
-    buffer << f.rdbuf();
-    return buffer.str();
-}
\ No newline at end of file
+    /* Reading the whole file directly into the result, sized upfront */
+    std::ifstream f(fileName, std::ios::binary | std::ios::ate);
+    if(!f.is_open())
+        return "";
+    std::streamoff size = f.tellg();
+    if(size <= 0) {
+        /* Size unknown (e.g. not a regular file), reading through an intermediary buffer instead */
+        f.seekg(0);
+        std::stringstream buffer;
+        buffer << f.rdbuf();
+        std::string result = buffer.str();
+        return (file_isCompressed(result) ? file_decompressString(result) : result);
+    }
+    /* Checking the magic bytes, decompressing while reading if compressed */
+    char magic[2] = {0, 0};
+    f.seekg(0);
+    f.read(magic, 2);
+    f.clear();
+    f.seekg(0);
+    if(f.gcount() == 2 && file_isCompressed(std::string(magic, 2)))
+        return readCompressed(f, size);
+    std::string result((size_t)size, '\0');
+    f.read(&result[0], size);
+    result.resize((size_t)f.gcount());
+    return result;
+}
+
+bool file_isCompressed(std::string const & data) {
+    return data.length() >= 2 && (unsigned char)data[0] == 0x1f && (unsigned char)data[1] == 0x8b;
+}
+
+std::string file_decompressString(std::string const & data) {
+    std::string result;
+    GzipInflater inflater;
+    inflater.feed(data.data(), data.length(), [&result](std::string && output) {
+        result += output;
+        return true;
+    });
+    inflater.finish();
+    return result;
+}
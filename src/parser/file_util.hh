@@ -4,6 +4,7 @@
  * @brief Very simple utility functions for easier file saving and loading
  *
  * Contains functions which simplify the process of saving and loading @ref std::string variables to and from files.
+ * Gzip-compressed files are detected and decompressed when read.
  */
 
 #ifndef FILE_UTIL_H
@@ -14,10 +15,26 @@
 #include <sstream>
 #include <string>
 
+/** The size of the compressed chunks read from a compressed file */
+#define FILE_READ_CHUNK (256u * 1024u)
+/** The size of the decompressed chunks passed on from decompressing */
+#define FILE_INFLATE_CHUNK (256u * 1024u)
+/** The amount of chunks queued between two stages of decompressing a file */
+#define FILE_QUEUED_CHUNKS 4
+
 /** Writes a string into a file */
 void file_writeString(char const * fileName, std::string const & fileData);
 
-/** Returns a string read from a file */
+/** Returns a string read from a file (an empty string if the file can't be opened).
+ * A gzip-compressed file is decompressed while reading - the file is read and decompressed on separate threads, passing the chunks
+ * through bounded queues, while the calling thread collects the decompressed text. Throws std::invalid_argument if the compressed data is invalid.
+*/
 std::string file_readString(char const * fileName);
 
-#endif /* FILE_UTIL_H */
\ No newline at end of file
+/** Returns whether the data is gzip-compressed (starts with the gzip magic bytes) */
+bool file_isCompressed(std::string const & data);
+
+/** Returns the decompressed gzip data (including multiple concatenated gzip members). Throws std::invalid_argument if the data is invalid */
+std::string file_decompressString(std::string const & data);
+
+#endif /* FILE_UTIL_H */
@@ -0,0 +1,588 @@
+#include "DtdCodeGenerator.hh"
+
+#include <cctype>
+#include <set>
+#include <stdexcept>
+
+/* Internal auxiliary functions */
+
+/** The C++ keywords, which can't be used as identifiers */
+static std::set<std::string> const keywords = {
+    "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch", "char", "char16_t", "char32_t", "class", "compl",
+    "concept", "const", "const_cast", "constexpr", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete", "do", "double", "dynamic_cast",
+    "else", "enum", "explicit", "export", "extern", "false", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new",
+    "noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast", "requires", "return",
+    "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local", "throw", "true", "try",
+    "typedef", "typeid", "typename", "union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq"
+};
+
+/** Skips whitespace in the given content model */
+static void skipWhitespace(std::string const & model, size_t * i) {
+    while((*i) < model.length() && std::isspace((unsigned char)model[*i]))
+        (*i)++;
+}
+
+
+/* Protected member functions */
+
+BindingElement & DtdCodeGenerator::getElement(std::string const & name) {
+    auto found = this->indices.find(name);
+    if(found != this->indices.end())
+        return this->elements[found->second];
+    this->indices[name] = this->elements.size();
+    this->elements.push_back({ name, "", BindingContent::Any, "", {}, {}, "" });
+    return this->elements.back();
+}
+
+std::vector<size_t> DtdCodeGenerator::getDeclarationOrder(void) {
+    /* Depth-first search through the members using an explicit stack, each struct being declared once all its members were (0 = not visited, 1 = visiting, 2 = declared) */
+    std::vector<size_t> result;
+    std::vector<int> states(this->elements.size(), 0);
+    std::vector<std::pair<size_t, size_t>> stack;
+    for(size_t first = 0; first < this->elements.size(); first++) {
+        if(states[first] != 0)
+            continue;
+        states[first] = 1;
+        stack.push_back({ first, 0 });
+        while(!stack.empty()) {
+            size_t element = stack.back().first;
+            size_t next = stack.back().second++;
+            if(next >= this->elements[element].children.size()) {
+                states[element] = 2;
+                result.push_back(element);
+                stack.pop_back();
+                continue;
+            }
+            BindingChild & child = this->elements[element].children[next];
+            size_t index = this->indices[child.name];
+            if(states[index] == 0) {
+                states[index] = 1;
+                stack.push_back({ index, 0 });
+            } else if(states[index] == 1) {
+                /* The struct of the child contains this struct, so it's still incomplete here */
+                child.repeated = true;
+            }
+        }
+    }
+    return result;
+}
+
+void DtdCodeGenerator::assignIdentifiers(void) {
+    std::set<std::string> types;
+    for(BindingElement & element : this->elements) {
+        std::string type = DtdCodeGenerator::getIdentifier(element.name, true);
+        while(types.count(type) > 0)
+            type += '_';
+        types.insert(type);
+        element.type = type;
+    }
+
+    /* Members can't have the name of a struct, which would change the meaning of the name within the struct */
+    for(BindingElement & element : this->elements) {
+        std::set<std::string> members;
+        auto getMember = [&](std::string const & name) {
+            std::string member = DtdCodeGenerator::getIdentifier(name, false);
+            while(members.count(member) > 0 || types.count(member) > 0)
+                member += '_';
+            members.insert(member);
+            return member;
+        };
+        for(BindingAttribute & it : element.attributes) {
+            it.member = getMember(it.declaration.name);
+        }
+        for(BindingChild & it : element.children) {
+            it.member = getMember(it.name);
+        }
+        if(element.content == BindingContent::Text)
+            element.contentMember = getMember("text");
+        else if(element.content == BindingContent::Any)
+            element.contentMember = getMember("content");
+    }
+}
+
+void DtdCodeGenerator::printStruct(std::string & result, BindingElement const & element) const {
+    result += "/** The element <" + element.name + ">";
+    if(!element.declaration.empty())
+        result += ", declared as " + element.declaration;
+    else
+        result += " (not declared, its content is kept as XML text)";
+    result += " */\n";
+    result += "struct " + element.type + " {\n";
+
+    for(BindingAttribute const & it : element.attributes) {
+        AttributeDeclaration const & declaration = it.declaration;
+        result += "    /** The attribute " + declaration.name;
+        if(declaration.defaultType == AttributeDefault::Required)
+            result += " (required)";
+        else if(declaration.defaultType == AttributeDefault::Fixed)
+            result += " (fixed)";
+        else if(declaration.defaultType == AttributeDefault::Implied)
+            result += " (optional)";
+        result += " */\n";
+        if(declaration.defaultType == AttributeDefault::Implied)
+            result += "    std::optional<std::string> " + it.member + ";\n";
+        else if(declaration.defaultType == AttributeDefault::Required)
+            result += "    std::string " + it.member + ";\n";
+        else
+            result += "    std::string " + it.member + " = " + DtdCodeGenerator::getLiteral(declaration.defaultValue) + ";\n";
+    }
+
+    for(BindingChild const & it : element.children) {
+        std::string type = this->elements[this->indices.at(it.name)].type;
+        result += "    /** The child element" + std::string(it.repeated ? "s" : "") + " <" + it.name + "> */\n";
+        if(it.repeated)
+            result += "    std::vector<" + type + "> " + it.member + ";\n";
+        else if(it.optional)
+            result += "    std::optional<" + type + "> " + it.member + ";\n";
+        else
+            result += "    " + type + " " + it.member + ";\n";
+    }
+
+    if(element.content == BindingContent::Text) {
+        result += "    /** The text content */\n";
+        result += "    std::string " + element.contentMember + ";\n";
+    } else if(element.content == BindingContent::Any) {
+        result += "    /** The content, as XML text */\n";
+        result += "    std::string " + element.contentMember + ";\n";
+    }
+
+    result += "};\n\n";
+}
+
+void DtdCodeGenerator::printReader(std::string & result, BindingElement const & element) const {
+    result += "inline void read" + element.type + "(XmlBindingReader & reader, " + element.type + " * value) {\n";
+    result += "    std::string_view name;\n";
+
+    /* Attributes */
+    result += "    std::string attribute;\n";
+    for(BindingAttribute const & it : element.attributes) {
+        if(it.declaration.defaultType == AttributeDefault::Required)
+            result += "    bool has_" + it.member + " = false;\n";
+    }
+    result += "    while(reader.nextAttribute(&name, &attribute)) {\n";
+    std::string keyword = "if";
+    for(BindingAttribute const & it : element.attributes) {
+        AttributeDeclaration const & declaration = it.declaration;
+        result += "        " + keyword + "(name == " + DtdCodeGenerator::getLiteral(declaration.name) + ") {\n";
+        keyword = "} else if";
+        if(declaration.defaultType == AttributeDefault::Fixed) {
+            result += "            if(attribute != " + DtdCodeGenerator::getLiteral(declaration.defaultValue) + ")\n";
+            result += "                reader.fail(\"The attribute " + declaration.name + " of <" + element.name + "> must have the fixed value\");\n";
+        }
+        if(!declaration.enumeration.empty()) {
+            std::string condition;
+            for(std::string const & value : declaration.enumeration) {
+                condition += (condition.empty() ? "" : " && ") + std::string("attribute != ") + DtdCodeGenerator::getLiteral(value);
+            }
+            result += "            if(" + condition + ")\n";
+            result += "                reader.fail(\"The attribute " + declaration.name + " of <" + element.name + "> has a value which is not in the declared enumeration\");\n";
+        }
+        if(declaration.defaultType == AttributeDefault::Required)
+            result += "            has_" + it.member + " = true;\n";
+        result += "            value->" + it.member + " = std::move(attribute);\n";
+    }
+    if(!element.attributes.empty())
+        result += "        }\n";
+    result += "    }\n";
+    for(BindingAttribute const & it : element.attributes) {
+        if(it.declaration.defaultType == AttributeDefault::Required) {
+            result += "    if(!has_" + it.member + ")\n";
+            result += "        reader.fail(\"Missing the required attribute " + it.declaration.name + " of <" + element.name + ">\");\n";
+        }
+    }
+
+    /* Content */
+    switch(element.content) {
+        case BindingContent::Empty:
+            if(element.attributes.empty())
+                result += "    (void)value;\n";
+            result += "    if(reader.nextChild(&name))\n";
+            result += "        reader.fail(\"Unexpected element <\" + std::string(name) + \"> in the empty element <" + element.name + ">\");\n";
+            break;
+
+        case BindingContent::Text:
+            result += "    reader.readText(&value->" + element.contentMember + ");\n";
+            break;
+
+        case BindingContent::Any:
+            result += "    reader.readContent(&value->" + element.contentMember + ");\n";
+            break;
+
+        default:
+            /* Single children are counted, so that missing and repeated ones are found */
+            for(BindingChild const & it : element.children) {
+                if(!it.repeated)
+                    result += "    bool has_" + it.member + " = false;\n";
+            }
+            result += "    while(reader.nextChild(&name)) {\n";
+            keyword = "if";
+            for(BindingChild const & it : element.children) {
+                std::string type = this->elements[this->indices.at(it.name)].type;
+                result += "        " + keyword + "(name == " + DtdCodeGenerator::getLiteral(it.name) + ") {\n";
+                keyword = "} else if";
+                if(it.repeated) {
+                    result += "            value->" + it.member + ".emplace_back();\n";
+                    result += "            read" + type + "(reader, &value->" + it.member + ".back());\n";
+                } else {
+                    result += "            if(has_" + it.member + ")\n";
+                    result += "                reader.fail(\"Unexpected second <" + it.name + "> in <" + element.name + ">\");\n";
+                    result += "            has_" + it.member + " = true;\n";
+                    if(it.optional) {
+                        result += "            value->" + it.member + ".emplace();\n";
+                        result += "            read" + type + "(reader, &*value->" + it.member + ");\n";
+                    } else {
+                        result += "            read" + type + "(reader, &value->" + it.member + ");\n";
+                    }
+                }
+            }
+            if(element.children.empty()) {
+                result += "        reader.fail(\"Unexpected element <\" + std::string(name) + \"> in <" + element.name + ">\");\n";
+            } else {
+                result += "        } else {\n";
+                result += "            reader.fail(\"Unexpected element <\" + std::string(name) + \"> in <" + element.name + ">\");\n";
+                result += "        }\n";
+            }
+            result += "    }\n";
+            for(BindingChild const & it : element.children) {
+                if(it.optional)
+                    continue;
+                result += (it.repeated ? "    if(value->" + it.member + ".empty())\n" : "    if(!has_" + it.member + ")\n");
+                result += "        reader.fail(\"Missing the element <" + it.name + "> in <" + element.name + ">\");\n";
+            }
+            break;
+    }
+
+    result += "}\n\n";
+}
+
+void DtdCodeGenerator::printWriter(std::string & result, BindingElement const & element) const {
+    result += "inline void write" + element.type + "(std::string & result, " + element.type + " const & value) {\n";
+    result += "    result += " + DtdCodeGenerator::getLiteral("<" + element.name) + ";\n";
+    for(BindingAttribute const & it : element.attributes) {
+        std::string name = DtdCodeGenerator::getLiteral(it.declaration.name);
+        if(it.declaration.defaultType == AttributeDefault::Implied) {
+            result += "    if(value." + it.member + ")\n";
+            result += "        XmlBindingWriter::appendAttribute(result, " + name + ", *value." + it.member + ");\n";
+        } else {
+            result += "    XmlBindingWriter::appendAttribute(result, " + name + ", value." + it.member + ");\n";
+        }
+    }
+
+    switch(element.content) {
+        case BindingContent::Empty:
+            if(element.attributes.empty())
+                result += "    (void)value;\n";
+            result += "    result += \"/>\";\n";
+            break;
+
+        case BindingContent::Text:
+            result += "    result += '>';\n";
+            result += "    XmlBindingWriter::appendEscaped(result, value." + element.contentMember + ");\n";
+            break;
+
+        case BindingContent::Any:
+            result += "    result += '>';\n";
+            result += "    result += value." + element.contentMember + ";\n";
+            break;
+
+        default:
+            result += "    result += '>';\n";
+            for(BindingChild const & it : element.children) {
+                std::string type = this->elements[this->indices.at(it.name)].type;
+                if(it.repeated) {
+                    result += "    for(" + type + " const & it : value." + it.member + ")\n";
+                    result += "        write" + type + "(result, it);\n";
+                } else if(it.optional) {
+                    result += "    if(value." + it.member + ")\n";
+                    result += "        write" + type + "(result, *value." + it.member + ");\n";
+                } else {
+                    result += "    write" + type + "(result, value." + it.member + ");\n";
+                }
+            }
+            break;
+    }
+    if(element.content != BindingContent::Empty)
+        result += "    result += " + DtdCodeGenerator::getLiteral("</" + element.name + ">") + ";\n";
+
+    result += "}\n\n";
+}
+
+
+/* Protected static member functions */
+
+DtdCodeGenerator::ContentParticle DtdCodeGenerator::parseContentModel(std::string const & model) {
+    /* The groups being parsed, using an explicit stack (the first one collecting the whole model) */
+    std::vector<ContentParticle> groups;
+    groups.push_back({ "", {}, 0, 0 });
+    size_t i = 0;
+    auto modifier = [&](void) {
+        if(i < model.length() && (model[i] == '?' || model[i] == '*' || model[i] == '+'))
+            return model[i++];
+        return (char)0;
+    };
+
+    while(true) {
+        skipWhitespace(model, &i);
+        if(i >= model.length())
+            break;
+        char c = model[i];
+        if(c == '(') {
+            i++;
+            groups.push_back({ "", {}, 0, 0 });
+        } else if(c == ')') {
+            i++;
+            if(groups.size() < 2)
+                throw std::invalid_argument("Error: Unbalanced brackets in the content model " + model);
+            ContentParticle group = std::move(groups.back());
+            groups.pop_back();
+            group.modifier = modifier();
+            groups.back().items.push_back(std::move(group));
+        } else if(c == ',' || c == '|') {
+            i++;
+            ContentParticle & group = groups.back();
+            if(group.separator != 0 && group.separator != c)
+                throw std::invalid_argument("Error: Mixed separators in a group of the content model " + model);
+            group.separator = c;
+        } else {
+            size_t begin = i;
+            while(i < model.length() && !std::isspace((unsigned char)model[i]) && std::string("(),|?*+").find(model[i]) == std::string::npos)
+                i++;
+            ContentParticle name = { model.substr(begin, i - begin), {}, 0, 0 };
+            name.modifier = modifier();
+            groups.back().items.push_back(std::move(name));
+        }
+    }
+
+    if(groups.size() != 1 || groups.back().items.size() != 1)
+        throw std::invalid_argument("Error: Malformed content model " + model);
+    return std::move(groups.back().items.front());
+}
+
+std::string DtdCodeGenerator::getIdentifier(std::string const & name, bool type) {
+    std::string result;
+    bool upper = type;
+    for(char c : name) {
+        if(std::isalnum((unsigned char)c) || (c == '_' && !type)) {
+            result += (upper ? (char)std::toupper((unsigned char)c) : c);
+            upper = false;
+        } else {
+            /* Other characters (e.g. '-', '.' and ':') separate the words of the name */
+            if(type)
+                upper = true;
+            else
+                result += '_';
+        }
+    }
+    if(result.empty() || std::isdigit((unsigned char)result[0]))
+        result = (type ? "E" : "_") + result;
+    if(keywords.count(result) > 0)
+        result += '_';
+    return result;
+}
+
+std::string DtdCodeGenerator::getLiteral(std::string const & text) {
+    std::string result = "\"";
+    for(char c : text) {
+        if(c == '"' || c == '\\')
+            result += '\\';
+        if(c == '\n')
+            result += "\\n";
+        else
+            result += c;
+    }
+    result += '"';
+    return result;
+}
+
+
+/* Constructor */
+
+DtdCodeGenerator::DtdCodeGenerator(void) {}
+
+
+/* Public member functions */
+
+void DtdCodeGenerator::addDocument(XmlDocument const & document) {
+    for(size_t i = 0; i < document.getChildAmount(); i++) {
+        Node const * node = document.getNode((int)i);
+        if(node->getNodeType() == NodeTypeName::ElementDTD) {
+            this->addElement(*(ElementDTD const *)node);
+        } else if(node->getNodeType() == NodeTypeName::AttributeDTD) {
+            this->addAttribute(*(AttributeDTD const *)node);
+        } else if(node->getNodeType() == NodeTypeName::DoctypeDTD) {
+            DoctypeDTD const * doctype = (DoctypeDTD const *)node;
+            for(size_t j = 0; j < doctype->getChildAmount(); j++) {
+                Node const * child = doctype->getChild((int)j);
+                if(child->getNodeType() == NodeTypeName::ElementDTD)
+                    this->addElement(*(ElementDTD const *)child);
+                else if(child->getNodeType() == NodeTypeName::AttributeDTD)
+                    this->addAttribute(*(AttributeDTD const *)child);
+            }
+        }
+    }
+}
+
+void DtdCodeGenerator::addElement(ElementDTD const & declaration) {
+    std::string content = declaration.getElementContent();
+    BindingElement parsed = { declaration.getElementName(), "", BindingContent::Any, "", {}, {}, "" };
+
+    if(content.compare(DTD_CONTENT_EMPTY) == 0) {
+        parsed.content = BindingContent::Empty;
+        parsed.declaration = content;
+    } else if(content.compare(DTD_CONTENT_ANY) == 0) {
+        parsed.declaration = content;
+    } else {
+        /* The content is stored without the outer brackets and the modifier following them */
+        std::string model = "(" + content + ")" + declaration.getElementModifier();
+        parsed.declaration = model;
+
+        /* Going through the particles with an explicit stack, along with whether they can be missing and whether they can repeat */
+        ContentParticle root = DtdCodeGenerator::parseContentModel(model);
+        bool mixed = false;
+        struct Item {
+            ContentParticle const * particle;
+            bool optional;
+            bool repeated;
+        };
+        std::vector<Item> stack;
+        stack.push_back({ &root, false, false });
+        std::vector<BindingChild> children;
+        while(!stack.empty()) {
+            Item item = stack.back();
+            stack.pop_back();
+            ContentParticle const & particle = *item.particle;
+            bool optional = item.optional || particle.modifier == '?' || particle.modifier == '*';
+            bool repeated = item.repeated || particle.modifier == '*' || particle.modifier == '+';
+            if(particle.items.empty()) {
+                if(particle.name.compare(DTD_CONTENT_PCDATA) == 0) {
+                    mixed = true;
+                    continue;
+                }
+                /* A child appearing more than once in the model is repeated, and can only be missing if it can be missing everywhere */
+                bool found = false;
+                for(BindingChild & it : children) {
+                    if(it.name.compare(particle.name) == 0) {
+                        it.repeated = true;
+                        it.optional = it.optional && optional;
+                        found = true;
+                    }
+                }
+                if(!found)
+                    children.push_back({ particle.name, "", optional, repeated });
+                continue;
+            }
+            /* The alternatives of a choice can be missing (pushed in reverse, so that the children keep the order of the model) */
+            bool choice = (particle.separator == '|' && particle.items.size() > 1);
+            for(size_t i = particle.items.size(); i > 0; i--) {
+                stack.push_back({ &particle.items[i-1], optional || choice, repeated });
+            }
+        }
+
+        if(mixed && children.empty()) {
+            parsed.content = BindingContent::Text;
+        } else if(!mixed) {
+            parsed.content = BindingContent::Elements;
+            parsed.children = children;
+        }
+    }
+
+    /* The first declaration of an element is used, but the struct may already exist for an element used as a child or with declared attributes */
+    BindingElement & element = this->getElement(parsed.name);
+    if(!element.declaration.empty())
+        return;
+    element.content = parsed.content;
+    element.declaration = parsed.declaration;
+    element.children = parsed.children;
+    for(BindingChild const & it : element.children) {
+        this->getElement(it.name);
+    }
+}
+
+void DtdCodeGenerator::addAttribute(AttributeDTD const & declaration) {
+    /* Processing the declaration the same as when applying it to elements */
+    AttributeTable table;
+    table.addDeclaration(declaration);
+    AttributeDeclaration const & processed = table.getDeclarations(declaration.getElementName())->front();
+
+    /* The first declaration of an attribute is used */
+    BindingElement & element = this->getElement(declaration.getElementName());
+    for(BindingAttribute const & it : element.attributes) {
+        if(it.declaration.name.compare(processed.name) == 0)
+            return;
+    }
+    element.attributes.push_back({ "", processed });
+}
+
+void DtdCodeGenerator::setNamespace(std::string const & nameSpace) {
+    this->nameSpace = nameSpace;
+}
+
+size_t DtdCodeGenerator::getElementAmount(void) const {
+    return this->elements.size();
+}
+
+std::string DtdCodeGenerator::generate(std::string const & guard, std::string const & source) {
+    std::vector<size_t> order = this->getDeclarationOrder();
+    this->assignIdentifiers();
+
+    std::string result;
+    result += "/**\n";
+    result += " * @file\n";
+    result += " * @brief XML bindings generated from the DTD declarations of " + source + "\n";
+    result += " *\n";
+    result += " * Generated by the DTD code generator - changes are overwritten once generated again.\n";
+    result += " * Each parse function reads the struct of an element straight from XML text (throwing std::invalid_argument if it doesn't match the declarations),\n";
+    result += " * and each print function prints the struct as minified XML.\n";
+    result += " */\n";
+    result += "#ifndef " + guard + "\n";
+    result += "#define " + guard + "\n\n";
+    result += "#include <string>\n#include <string_view>\n#include <vector>\n#include <optional>\n\n";
+    result += "#include \"xml_binding.hh\"\n\n";
+    if(!this->nameSpace.empty())
+        result += "namespace " + this->nameSpace + " {\n\n";
+
+    /* Structs, each declared after the structs of its members (and all of them forward-declared, for the vectors of structs containing their own struct) */
+    for(BindingElement const & it : this->elements) {
+        result += "struct " + it.type + ";\n";
+    }
+    result += "\n";
+    for(size_t it : order) {
+        this->printStruct(result, this->elements[it]);
+    }
+
+    /* Functions reading and printing each struct, which call each other */
+    for(BindingElement const & it : this->elements) {
+        result += "inline void read" + it.type + "(XmlBindingReader & reader, " + it.type + " * value);\n";
+        result += "inline void write" + it.type + "(std::string & result, " + it.type + " const & value);\n";
+    }
+    result += "\n";
+    for(BindingElement const & it : this->elements) {
+        this->printReader(result, it);
+        this->printWriter(result, it);
+    }
+
+    /* Public functions, parsing a whole document with the element as its root, and printing the element */
+    for(BindingElement const & it : this->elements) {
+        result += "/** Returns the <" + it.name + "> root element of the given XML text (throws std::invalid_argument if the text doesn't match the declarations) */\n";
+        result += "inline " + it.type + " parse" + it.type + "(std::string_view xml) {\n";
+        result += "    XmlBindingReader reader(xml);\n";
+        result += "    if(reader.readRoot() != " + DtdCodeGenerator::getLiteral(it.name) + ")\n";
+        result += "        reader.fail(\"Expected the root element <" + it.name + ">\");\n";
+        result += "    " + it.type + " result;\n";
+        result += "    read" + it.type + "(reader, &result);\n";
+        result += "    reader.readEnd();\n";
+        result += "    return result;\n";
+        result += "}\n\n";
+        result += "/** Returns the given <" + it.name + "> element as minified XML */\n";
+        result += "inline std::string print" + it.type + "(" + it.type + " const & value) {\n";
+        result += "    std::string result;\n";
+        result += "    write" + it.type + "(result, value);\n";
+        result += "    return result;\n";
+        result += "}\n\n";
+    }
+
+    if(!this->nameSpace.empty())
+        result += "} /* namespace " + this->nameSpace + " */\n\n";
+    result += "#endif /* " + guard + " */\n";
+    return result;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file DtdCodeGenerator.hh
+ * @author Linux-Tech-Tips
+ * @brief Code generator from DTD declarations to C++ bindings header
+ *
+ * The header declaring the code generator, which turns the Element DTD and Attribute DTD declarations of a document
+ * into C++ structs, along with parse and print functions specialized for them (see @ref xml_binding.hh)
+ */
+#ifndef DTD_CODE_GENERATOR_H
+#define DTD_CODE_GENERATOR_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../src/parser/XmlDocument.hh"
+
+/** The content of a generated struct, as declared by the Element DTD */
+enum class BindingContent {
+    /** No content (EMPTY) */
+    Empty,
+    /** Text only (#PCDATA) */
+    Text,
+    /** Child elements only (a content model without #PCDATA) */
+    Elements,
+    /** Any content, kept as XML text (ANY, mixed content, or an element which isn't declared) */
+    Any
+};
+
+/** A child element of a generated struct */
+struct BindingChild {
+    /** The name of the child element */
+    std::string name;
+    /** The name of the member */
+    std::string member;
+    /** Whether the child can be missing (std::optional member, or a vector which can be empty) */
+    bool optional;
+    /** Whether the child can appear more than once, or has to be stored in a vector because its struct contains this one (std::vector member) */
+    bool repeated;
+};
+
+/** An attribute of a generated struct */
+struct BindingAttribute {
+    /** The name of the member */
+    std::string member;
+    /** The processed declaration of the attribute */
+    AttributeDeclaration declaration;
+};
+
+/** A generated struct, representing one element */
+struct BindingElement {
+    /** The name of the element */
+    std::string name;
+    /** The name of the struct */
+    std::string type;
+    /** The content of the element */
+    BindingContent content;
+    /** The declared content of the element, printed in the documentation of the struct (empty if not declared) */
+    std::string declaration;
+    /** The child elements, in the order of the content model */
+    std::vector<BindingChild> children;
+    /** The attributes, in the order of their declarations */
+    std::vector<BindingAttribute> attributes;
+    /** The name of the member holding the text (Text) or the XML text (Any) content */
+    std::string contentMember;
+};
+
+/**
+ * @class DtdCodeGenerator
+ * @author Linux-Tech-Tips
+ * @brief Code generator from DTD declarations to C++ bindings
+ *
+ * Generates a header with a struct for each declared element - a member for each declared attribute, and a member for each child element
+ * in the content model (a vector if it can appear more than once, std::optional if it can be missing), or a string for text content.
+ * For each struct, a parse function reads the struct straight from XML text, and a print function prints it as minified XML,
+ * without building any Nodes. The parse functions check the attributes (required, fixed and enumerated values) and the child elements,
+ * throwing std::invalid_argument if the text doesn't match the declarations. The order of the child elements isn't checked,
+ * and they are printed in the order of the content model. Unknown attributes are ignored.
+*/
+class DtdCodeGenerator {
+
+    protected:
+        /** A particle of a content model - a name, or a sequence or choice of particles, with its modifier ('?', '*', '+' or 0) */
+        struct ContentParticle {
+            std::string name;
+            std::vector<ContentParticle> items;
+            char separator;
+            char modifier;
+        };
+
+        /** The generated structs, in the order of their declarations */
+        std::vector<BindingElement> elements;
+        /** The position of the struct of each element name */
+        std::unordered_map<std::string, size_t> indices;
+        /** The namespace the generated code is placed in (none if empty) */
+        std::string nameSpace;
+
+        /** Internal function which returns the struct of the element with the given name, adding an undeclared (Any) struct if none exists */
+        BindingElement & getElement(std::string const & name);
+
+        /** Internal function which returns the order in which the structs have to be declared (each struct after the structs of its members),
+         * changing the members which refer to a struct containing their own struct into vectors, which can hold incomplete types
+        */
+        std::vector<size_t> getDeclarationOrder(void);
+
+        /** Internal function which gives each member a valid identifier, unique within its struct, and each struct a unique type name */
+        void assignIdentifiers(void);
+
+        /** Internal function which appends the struct of the element to the result */
+        void printStruct(std::string & result, BindingElement const & element) const;
+        /** Internal function which appends the function reading the element to the result */
+        void printReader(std::string & result, BindingElement const & element) const;
+        /** Internal function which appends the function printing the element to the result */
+        void printWriter(std::string & result, BindingElement const & element) const;
+
+        /** Internal auxiliary function which parses the given content model (as written in the declaration, including the outer brackets)
+         * @throws std::invalid_argument if the model is malformed
+        */
+        static ContentParticle parseContentModel(std::string const & model);
+
+        /** Internal auxiliary function which returns the given name turned into a C++ identifier (in CamelCase if type is true) */
+        static std::string getIdentifier(std::string const & name, bool type);
+
+        /** Internal auxiliary function which returns the given text as a C++ string literal */
+        static std::string getLiteral(std::string const & text);
+
+    public:
+        /** Constructor - a generator without any declarations */
+        DtdCodeGenerator(void);
+
+        /** Adds the Element DTD and Attribute DTD declarations of the given document - from its Doctype DTD, and from its root level (e.g. a loaded external DTD file)
+         * @throws std::invalid_argument if a content model is malformed
+        */
+        void addDocument(XmlDocument const & document);
+
+        /** Adds the given Element DTD declaration, as the struct of the element
+         * @throws std::invalid_argument if the content model is malformed
+        */
+        void addElement(ElementDTD const & declaration);
+
+        /** Adds the given Attribute DTD declaration, as a member of the struct of its element */
+        void addAttribute(AttributeDTD const & declaration);
+
+        /** Sets the namespace the generated code is placed in (none if empty) */
+        void setNamespace(std::string const & nameSpace);
+
+        /** Returns the amount of generated structs */
+        size_t getElementAmount(void) const;
+
+        /** Returns the generated header
+         *  @param guard the name of the include guard macro
+         *  @param source the name of the file the declarations were loaded from, mentioned in the header comment
+        */
+        std::string generate(std::string const & guard, std::string const & source);
+
+};
+
+#endif /* DTD_CODE_GENERATOR_H */
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+#include <cctype>
+#include <stdexcept>
+
+#include "../src/parser/XmlDocument.hh"
+#include "DtdCodeGenerator.hh"
+
+/* Internal auxiliary functions */
+
+/** Prints the usage of the program */
+static void usage(char const * program) {
+    std::cerr << "Usage: " << program << " <input.xml|input.dtd> <output.hh> [--namespace name]" << std::endl;
+    std::cerr << "  Generates a C++ header with a struct, a parse function and a print function for each element declared in the DTD of the input" << std::endl;
+    std::cerr << "  (the generated header includes xml_binding.hh from the tools directory)" << std::endl;
+}
+
+/** Returns the include guard for the given output file (the upper-case file name without its extension, followed by _H) */
+static std::string getGuard(std::string const & path) {
+    size_t begin = path.find_last_of("/\\");
+    std::string name = path.substr(begin == std::string::npos ? 0 : begin + 1);
+    name = name.substr(0, name.find('.'));
+    std::string result;
+    for(char c : name) {
+        result += (std::isalnum((unsigned char)c) ? (char)std::toupper((unsigned char)c) : '_');
+    }
+    if(result.empty() || std::isdigit((unsigned char)result[0]))
+        result = "XML_" + result;
+    return result + "_H";
+}
+
+
+/* Main function */
+
+int main(int argc, char ** argv) {
+    /* Reading the arguments */
+    std::string input;
+    std::string output;
+    std::string nameSpace;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--namespace" && i + 1 < argc) {
+            nameSpace = argv[++i];
+        } else if(arg == "--help" || arg == "-h") {
+            usage(argv[0]);
+            return 0;
+        } else if(input.empty()) {
+            input = arg;
+        } else if(output.empty()) {
+            output = arg;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(input.empty() || output.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    /* Generating the header */
+    try {
+        XmlDocument document(input.c_str());
+        DtdCodeGenerator generator;
+        generator.setNamespace(nameSpace);
+        generator.addDocument(document);
+        if(generator.getElementAmount() == 0) {
+            std::cerr << "Error: No element declarations found in " << input << std::endl;
+            return 1;
+        }
+        file_writeString(output.c_str(), generator.generate(getGuard(output), input));
+        std::cout << "Generated " << generator.getElementAmount() << " structs into " << output << std::endl;
+    } catch(std::exception const & e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
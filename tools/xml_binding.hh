@@ -0,0 +1,431 @@
+/**
+ * @file xml_binding.hh
+ * @author Linux-Tech-Tips
+ * @brief Runtime of the code generated from DTD declarations
+ *
+ * The header-only reader and writer used by the parse and print functions generated by the DTD code generator (see @ref DtdCodeGenerator).
+ * The reader goes through the XML text in place, one tag at a time, so the generated code reads the text straight into its structs, without building any Nodes.
+ * The text must be UTF-8 (or ASCII). Must be available on the include path of the generated code.
+ */
+#ifndef XML_BINDING_H
+#define XML_BINDING_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+
+/** The default maximum nesting depth of documents read by the generated code (the generated functions recurse once per nesting level) */
+#define XML_BINDING_MAX_DEPTH 10000
+
+/**
+ * @class XmlBindingReader
+ * @author Linux-Tech-Tips
+ * @brief Reader going through the tags of XML text in place
+ *
+ * After the name of an element is read (@ref readRoot or @ref nextChild), its attributes are read by @ref nextAttribute until it returns false,
+ * and then its content is read by one of @ref nextChild (element content), @ref readText (text content), @ref readContent (any content) or @ref skipContent.
+ * Comments, processing instructions and the document type declaration are skipped. Throws std::invalid_argument on malformed text.
+*/
+class XmlBindingReader {
+
+    protected:
+        /** The read text */
+        std::string_view text;
+        /** The position of the next character to read */
+        size_t position;
+        /** The names of the elements whose content is being read */
+        std::vector<std::string_view> open;
+        /** The maximum nesting depth */
+        size_t maxDepth;
+        /** Whether the last read start tag was self-closing (the element having no content) */
+        bool selfClosing;
+
+        /** Internal function which returns whether the text at the current position starts with the given prefix */
+        bool startsWith(char const * prefix) const {
+            size_t length = std::strlen(prefix);
+            return this->text.length() - this->position >= length && this->text.compare(this->position, length, prefix) == 0;
+        }
+
+        /** Internal function which moves after the next occurrence of the given string, failing if there is none */
+        void skipPast(char const * end) {
+            size_t found = this->text.find(end, this->position);
+            if(found == std::string_view::npos)
+                this->fail(std::string("Expected \"") + end + "\"");
+            this->position = found + std::strlen(end);
+        }
+
+        /** Internal function which moves after any whitespace */
+        void skipWhitespace(void) {
+            while(this->position < this->text.length() && XmlBindingReader::isWhitespace(this->text[this->position]))
+                this->position++;
+        }
+
+        /** Internal function which moves after a comment, processing instruction or document type declaration, returning false if there is none at the position */
+        bool skipMarkup(void) {
+            if(this->startsWith("<!--")) {
+                this->skipPast("-->");
+            } else if(this->startsWith("<?")) {
+                this->skipPast("?>");
+            } else if(this->startsWith("<!DOCTYPE")) {
+                /* The internal subset can contain '>' characters, so the brackets are matched */
+                size_t bracket = this->text.find_first_of("[>", this->position);
+                if(bracket != std::string_view::npos && this->text[bracket] == '[') {
+                    this->position = bracket;
+                    this->skipPast("]");
+                }
+                this->skipPast(">");
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        /** Internal function which reads a name at the position */
+        std::string_view readName(void) {
+            size_t begin = this->position;
+            while(this->position < this->text.length() && !XmlBindingReader::isWhitespace(this->text[this->position]) && std::strchr("/>=", this->text[this->position]) == nullptr)
+                this->position++;
+            if(this->position == begin)
+                this->fail("Expected a name");
+            return this->text.substr(begin, this->position - begin);
+        }
+
+        /** Internal function which reads the closing tag of the innermost open element */
+        void readClosingTag(void) {
+            this->position += 2;
+            std::string_view name = this->readName();
+            if(name != this->open.back())
+                this->fail("Expected the closing tag of <" + std::string(this->open.back()) + ">");
+            this->skipWhitespace();
+            if(!this->startsWith(">"))
+                this->fail("Expected '>'");
+            this->position++;
+            this->open.pop_back();
+        }
+
+        /** Internal function which starts reading the element whose name was read, failing if nested too deep */
+        void openElement(std::string_view name) {
+            this->open.push_back(name);
+            this->selfClosing = false;
+            if(this->maxDepth > 0 && this->open.size() > this->maxDepth)
+                this->fail("Elements nested deeper than the maximum depth of " + std::to_string(this->maxDepth));
+        }
+
+        /** Internal function which finishes reading a self-closing element, returning false if the element has content */
+        bool closeEmpty(void) {
+            if(!this->selfClosing)
+                return false;
+            this->selfClosing = false;
+            this->open.pop_back();
+            return true;
+        }
+
+        /** Internal function which appends the given text to the result, replacing the predefined and character entity references */
+        void appendDecoded(std::string & result, std::string_view raw) {
+            size_t i = 0;
+            while(i < raw.length()) {
+                size_t amp = raw.find('&', i);
+                if(amp == std::string_view::npos) {
+                    result.append(raw, i, std::string_view::npos);
+                    return;
+                }
+                result.append(raw, i, amp - i);
+                size_t semicolon = raw.find(';', amp);
+                if(semicolon == std::string_view::npos)
+                    this->fail("Unterminated entity reference");
+                std::string_view entity = raw.substr(amp + 1, semicolon - amp - 1);
+                if(entity == "lt") {
+                    result += '<';
+                } else if(entity == "gt") {
+                    result += '>';
+                } else if(entity == "amp") {
+                    result += '&';
+                } else if(entity == "quot") {
+                    result += '"';
+                } else if(entity == "apos") {
+                    result += '\'';
+                } else if(entity.length() > 1 && entity[0] == '#') {
+                    bool hex = (entity[1] == 'x');
+                    uint32_t code = 0;
+                    for(size_t j = (hex ? 2 : 1); j < entity.length(); j++) {
+                        char c = entity[j];
+                        uint32_t digit = (c >= '0' && c <= '9' ? c - '0' : (hex && c >= 'a' && c <= 'f' ? c - 'a' + 10 : (hex && c >= 'A' && c <= 'F' ? c - 'A' + 10 : 99)));
+                        if(digit >= (hex ? 16u : 10u) || code > 0x10FFFF)
+                            this->fail("Invalid character reference");
+                        code = code * (hex ? 16 : 10) + digit;
+                    }
+                    if(code > 0x10FFFF || entity.length() == (hex ? 2u : 1u))
+                        this->fail("Invalid character reference");
+                    XmlBindingReader::appendUtf8(result, code);
+                } else {
+                    this->fail("Undeclared entity &" + std::string(entity) + ";");
+                }
+                i = semicolon + 1;
+            }
+        }
+
+        /** Internal auxiliary function which appends the given code point encoded in UTF-8 */
+        static void appendUtf8(std::string & result, uint32_t code) {
+            if(code < 0x80) {
+                result += (char)code;
+            } else if(code < 0x800) {
+                result += (char)(0xC0 | (code >> 6));
+                result += (char)(0x80 | (code & 0x3F));
+            } else if(code < 0x10000) {
+                result += (char)(0xE0 | (code >> 12));
+                result += (char)(0x80 | ((code >> 6) & 0x3F));
+                result += (char)(0x80 | (code & 0x3F));
+            } else {
+                result += (char)(0xF0 | (code >> 18));
+                result += (char)(0x80 | ((code >> 12) & 0x3F));
+                result += (char)(0x80 | ((code >> 6) & 0x3F));
+                result += (char)(0x80 | (code & 0x3F));
+            }
+        }
+
+        /** Internal function which moves after the closing tag of the current element, going through its nested elements without recursing,
+         * and returns the position of the closing tag
+        */
+        size_t skipNested(void) {
+            size_t outer = this->open.size();
+            while(true) {
+                size_t tag = this->text.find('<', this->position);
+                if(tag == std::string_view::npos) {
+                    this->position = this->text.length();
+                    this->fail("Expected the closing tag of <" + std::string(this->open.back()) + ">");
+                }
+                this->position = tag;
+                if(this->skipMarkup())
+                    continue;
+                if(this->startsWith("<![CDATA[")) {
+                    this->skipPast("]]>");
+                } else if(this->startsWith("</")) {
+                    size_t closing = this->position;
+                    this->readClosingTag();
+                    if(this->open.size() < outer)
+                        return closing;
+                } else {
+                    this->position++;
+                    this->openElement(this->readName());
+                    std::string_view name;
+                    std::string value;
+                    while(this->nextAttribute(&name, &value)) {}
+                    this->closeEmpty();
+                }
+            }
+        }
+
+        /** Internal auxiliary function which returns whether the given character is XML whitespace */
+        static bool isWhitespace(char c) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+    public:
+        /** Constructor
+         *  @param text the XML text to read (must outlive the reader)
+         *  @param maxDepth the maximum nesting depth of the elements (0 for no limit)
+        */
+        explicit XmlBindingReader(std::string_view text, size_t maxDepth = XML_BINDING_MAX_DEPTH) : text(text), position(0), maxDepth(maxDepth), selfClosing(false) {}
+
+        /** Throws std::invalid_argument with the given message and the current position */
+        [[noreturn]] void fail(std::string const & message) const {
+            throw std::invalid_argument("Error: " + message + " (at byte " + std::to_string(this->position) + ")");
+        }
+
+        /** Reads the start of the root element, skipping the prolog, comments, processing instructions and the document type declaration before it, and returns its name */
+        std::string_view readRoot(void) {
+            /* Skipping the UTF-8 byte order mark, if any */
+            if(this->startsWith("\xEF\xBB\xBF"))
+                this->position += 3;
+            while(true) {
+                this->skipWhitespace();
+                if(!this->skipMarkup())
+                    break;
+            }
+            if(!this->startsWith("<"))
+                this->fail("Expected the root element");
+            this->position++;
+            std::string_view name = this->readName();
+            this->openElement(name);
+            return name;
+        }
+
+        /** Reads the next attribute of the current start tag, returning false once the start tag is finished
+         *  @param name the name of the read attribute
+         *  @param value the value of the read attribute, with entity references replaced
+        */
+        bool nextAttribute(std::string_view * name, std::string * value) {
+            this->skipWhitespace();
+            if(this->startsWith("/>")) {
+                this->position += 2;
+                this->selfClosing = true;
+                return false;
+            }
+            if(this->startsWith(">")) {
+                this->position++;
+                return false;
+            }
+            *name = this->readName();
+            this->skipWhitespace();
+            if(!this->startsWith("="))
+                this->fail("Expected '=' after the attribute " + std::string(*name));
+            this->position++;
+            this->skipWhitespace();
+            if(this->position >= this->text.length() || (this->text[this->position] != '"' && this->text[this->position] != '\''))
+                this->fail("Expected a quoted attribute value");
+            char quote = this->text[this->position++];
+            size_t end = this->text.find(quote, this->position);
+            if(end == std::string_view::npos)
+                this->fail("Unterminated attribute value");
+            value->clear();
+            this->appendDecoded(*value, this->text.substr(this->position, end - this->position));
+            this->position = end + 1;
+            return true;
+        }
+
+        /** Reads the start of the next child element of the current element and returns its name, or reads the closing tag of the current element and returns false.
+         * Text between the child elements is skipped
+        */
+        bool nextChild(std::string_view * name) {
+            if(this->closeEmpty())
+                return false;
+            while(true) {
+                size_t tag = this->text.find('<', this->position);
+                if(tag == std::string_view::npos) {
+                    this->position = this->text.length();
+                    this->fail("Expected the closing tag of <" + std::string(this->open.back()) + ">");
+                }
+                this->position = tag;
+                if(this->skipMarkup())
+                    continue;
+                if(this->startsWith("<![CDATA[")) {
+                    this->skipPast("]]>");
+                    continue;
+                }
+                if(this->startsWith("</")) {
+                    this->readClosingTag();
+                    return false;
+                }
+                this->position++;
+                *name = this->readName();
+                this->openElement(*name);
+                return true;
+            }
+        }
+
+        /** Reads the text content of the current element (with entity references replaced) and its closing tag, failing if it contains any elements */
+        void readText(std::string * result) {
+            result->clear();
+            if(this->closeEmpty())
+                return;
+            while(true) {
+                size_t tag = this->text.find('<', this->position);
+                if(tag == std::string_view::npos) {
+                    this->position = this->text.length();
+                    this->fail("Expected the closing tag of <" + std::string(this->open.back()) + ">");
+                }
+                this->appendDecoded(*result, this->text.substr(this->position, tag - this->position));
+                this->position = tag;
+                if(this->startsWith("<![CDATA[")) {
+                    size_t end = this->text.find("]]>", this->position + 9);
+                    if(end == std::string_view::npos)
+                        this->fail("Unterminated CDATA section");
+                    result->append(this->text, this->position + 9, end - this->position - 9);
+                    this->position = end + 3;
+                } else if(this->startsWith("</")) {
+                    this->readClosingTag();
+                    return;
+                } else if(!this->skipMarkup()) {
+                    this->fail("Unexpected element in the text content of <" + std::string(this->open.back()) + ">");
+                }
+            }
+        }
+
+        /** Reads the content of the current element unchanged (as XML text, including any nested elements) and its closing tag */
+        void readContent(std::string * result) {
+            result->clear();
+            if(this->closeEmpty())
+                return;
+            size_t begin = this->position;
+            size_t end = this->skipNested();
+            result->assign(this->text.data() + begin, end - begin);
+        }
+
+        /** Skips the content of the current element and its closing tag */
+        void skipContent(void) {
+            if(!this->closeEmpty())
+                this->skipNested();
+        }
+
+        /** Skips the attributes and the content of the current element */
+        void skipElement(void) {
+            std::string_view name;
+            std::string value;
+            while(this->nextAttribute(&name, &value)) {}
+            this->skipContent();
+        }
+
+        /** Checks that only whitespace, comments and processing instructions follow the root element */
+        void readEnd(void) {
+            while(true) {
+                this->skipWhitespace();
+                if(!this->skipMarkup())
+                    break;
+            }
+            if(this->position < this->text.length())
+                this->fail("Unexpected content after the root element");
+        }
+
+};
+
+/**
+ * @class XmlBindingWriter
+ * @author Linux-Tech-Tips
+ * @brief Functions appending escaped XML text, used by the generated print functions
+*/
+class XmlBindingWriter {
+
+    public:
+        /** Appends the given text to the result, escaping the characters which can't appear in text content or attribute values */
+        static void appendEscaped(std::string & result, std::string_view text) {
+            size_t i = 0;
+            while(i < text.length()) {
+                size_t special = text.find_first_of("<>&\"", i);
+                if(special == std::string_view::npos) {
+                    result.append(text, i, std::string_view::npos);
+                    return;
+                }
+                result.append(text, i, special - i);
+                switch(text[special]) {
+                    case '<':
+                        result += "&lt;";
+                        break;
+                    case '>':
+                        result += "&gt;";
+                        break;
+                    case '&':
+                        result += "&amp;";
+                        break;
+                    default:
+                        result += "&quot;";
+                        break;
+                }
+                i = special + 1;
+            }
+        }
+
+        /** Appends an attribute with the given name and value to the result, preceded by a space */
+        static void appendAttribute(std::string & result, char const * name, std::string_view value) {
+            result += ' ';
+            result += name;
+            result += "=\"";
+            XmlBindingWriter::appendEscaped(result, value);
+            result += '"';
+        }
+
+};
+
+#endif /* XML_BINDING_H */